@@ -12,6 +12,7 @@ Feature: osrm-contract command line options: help
         And stdout should contain "--threads"
         And stdout should contain "--core"
         And stdout should contain "--level-cache"
+        And stdout should contain "--renumber-nodes"
         And stdout should contain "--segment-speed-file"
         And it should exit with an error
 
@@ -26,6 +27,7 @@ Feature: osrm-contract command line options: help
         And stdout should contain "--threads"
         And stdout should contain "--core"
         And stdout should contain "--level-cache"
+        And stdout should contain "--renumber-nodes"
         And stdout should contain "--segment-speed-file"
         And it should exit successfully
 
@@ -40,5 +42,6 @@ Feature: osrm-contract command line options: help
         And stdout should contain "--threads"
         And stdout should contain "--core"
         And stdout should contain "--level-cache"
+        And stdout should contain "--renumber-nodes"
         And stdout should contain "--segment-speed-file"
         And it should exit successfully
@@ -0,0 +1,39 @@
+@contract @options @renumber-nodes
+Feature: osrm-contract command line option: renumber-nodes
+
+    Background: A small network with a few contracted nodes
+        Given the node map
+            """
+            a b c d
+                e
+                f
+            """
+        And the ways
+            | nodes | highway     |
+            | abcd  | primary     |
+            | cef   | residential |
+        Given the profile "testbot"
+        And the data has been saved to disk
+
+    Scenario: Routing on a renumbered graph
+        When I run "osrm-extract --profile {profile_file} {osm_file}"
+        When I run "osrm-contract --renumber-nodes true {processed_file}"
+        Then stderr should be empty
+        And it should exit successfully
+        And I route I should get
+            | from | to | route           |
+            | a    | d  | abcd,abcd       |
+            | a    | f  | abcd,cef,cef    |
+            | f    | d  | cef,abcd,abcd   |
+
+    Scenario: Contracting a renumbered graph again with and without renumbering
+        When I run "osrm-extract --profile {profile_file} {osm_file}"
+        When I run "osrm-contract --renumber-nodes true {processed_file}"
+        When I run "osrm-contract --renumber-nodes true {processed_file}"
+        When I run "osrm-contract {processed_file}"
+        Then stderr should be empty
+        And it should exit successfully
+        And I route I should get
+            | from | to | route           |
+            | a    | d  | abcd,abcd       |
+            | f    | d  | cef,abcd,abcd   |
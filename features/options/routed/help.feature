@@ -16,11 +16,18 @@ Feature: osrm-routed command line options: help
         And stdout should contain "--ip"
         And stdout should contain "--port"
         And stdout should contain "--threads"
+        And stdout should contain "--io-threads"
+        And stdout should contain "--max-queue-size"
+        And stdout should contain "--max-concurrent-requests"
+        And stdout should contain "--keepalive-timeout"
+        And stdout should contain "--keepalive-max-requests"
         And stdout should contain "--shared-memory"
         And stdout should contain "--max-viaroute-size"
         And stdout should contain "--max-trip-size"
         And stdout should contain "--max-table-size"
         And stdout should contain "--max-matching-size"
+        And stdout should contain "--max-table-parallelism"
+        And stdout should contain "--max-dense-heap-nodes"
         And it should exit successfully
 
     Scenario: osrm-routed - Help, short
@@ -35,11 +42,18 @@ Feature: osrm-routed command line options: help
         And stdout should contain "--ip"
         And stdout should contain "--port"
         And stdout should contain "--threads"
+        And stdout should contain "--io-threads"
+        And stdout should contain "--max-queue-size"
+        And stdout should contain "--max-concurrent-requests"
+        And stdout should contain "--keepalive-timeout"
+        And stdout should contain "--keepalive-max-requests"
         And stdout should contain "--shared-memory"
         And stdout should contain "--max-viaroute-size"
         And stdout should contain "--max-trip-size"
         And stdout should contain "--max-table-size"
         And stdout should contain "--max-matching-size"
+        And stdout should contain "--max-table-parallelism"
+        And stdout should contain "--max-dense-heap-nodes"
         And it should exit successfully
 
     Scenario: osrm-routed - Help, long
@@ -54,9 +68,16 @@ Feature: osrm-routed command line options: help
         And stdout should contain "--ip"
         And stdout should contain "--port"
         And stdout should contain "--threads"
+        And stdout should contain "--io-threads"
+        And stdout should contain "--max-queue-size"
+        And stdout should contain "--max-concurrent-requests"
+        And stdout should contain "--keepalive-timeout"
+        And stdout should contain "--keepalive-max-requests"
         And stdout should contain "--shared-memory"
         And stdout should contain "--max-trip-size"
         And stdout should contain "--max-table-size"
         And stdout should contain "--max-table-size"
         And stdout should contain "--max-matching-size"
+        And stdout should contain "--max-table-parallelism"
+        And stdout should contain "--max-dense-heap-nodes"
         And it should exit successfully
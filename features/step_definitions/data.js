@@ -9,7 +9,7 @@ var OSM = require('../lib/osm');
 module.exports = function () {
     this.Given(/^the profile "([^"]*)"$/, (profile, callback) => {
         this.profile = profile;
-        this.profileFile = path.join(this.PROFILES_PATH, this.profile + '.lua');
+        this.profileFile = this.getProfileFile(this.profile);
         callback();
     });
 
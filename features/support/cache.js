@@ -126,11 +126,25 @@ module.exports = function() {
             });
         };
 
+        // the data extracted with compiled profiles is cached separately
+        var addCompiledProfiles = (directory, callback) => {
+            if (!this.USE_COMPILED_PROFILES) return callback();
+            fs.readdir(path.normalize(directory), (err, files) => {
+                if (err) return callback(err);
+
+                var compiledProfiles = files.filter(f => !!f.match(/\.so$/) && !f.match(/^lib/)).map(f => path.normalize(directory + '/' + f));
+                Array.prototype.push.apply(dependencies, compiledProfiles);
+
+                callback();
+            });
+        };
+
         // Note: we need a serialized queue here to ensure that the order of the files
         // passed is stable. Otherwise the hash will not be stable
         d3.queue(1)
             .defer(addLuaFiles, this.PROFILES_PATH)
             .defer(addLuaFiles, this.PROFILES_PATH + '/lib')
+            .defer(addCompiledProfiles, this.BIN_PATH)
             .awaitAll(hash.hashOfFiles.bind(hash, dependencies, callback));
     };
 
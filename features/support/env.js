@@ -22,6 +22,8 @@ module.exports = function () {
         this.PROFILES_PATH = path.resolve(this.ROOT_PATH, 'profiles');
         this.FIXTURES_PATH = path.resolve(this.ROOT_PATH, 'unit_tests/fixtures');
         this.BIN_PATH = process.env.OSRM_BUILD_DIR && process.env.OSRM_BUILD_DIR || path.resolve(this.ROOT_PATH, 'build');
+        // use {profile}.so from the build directory instead of {profile}.lua where it exists
+        this.USE_COMPILED_PROFILES = !!process.env.OSRM_COMPILED_PROFILES;
         var stxxl_config = path.resolve(this.ROOT_PATH, 'test/.stxxl');
         if (!fs.existsSync(stxxl_config)) {
             return callback(new Error('*** '+stxxl_config+ 'does not exist'));
@@ -97,6 +99,19 @@ module.exports = function () {
         return path.resolve(this.PROFILES_PATH, profile + '.lua');
     };
 
+    this.getCompiledProfilePath = (profile) => {
+        return path.resolve(this.BIN_PATH, profile + '.so');
+    };
+
+    // the profile osrm-extract runs with for the given profile name
+    this.getProfileFile = (profile) => {
+        if (this.USE_COMPILED_PROFILES) {
+            const compiledProfile = this.getCompiledProfilePath(profile);
+            if (fs.existsSync(compiledProfile)) return compiledProfile;
+        }
+        return this.getProfilePath(profile);
+    };
+
     this.verifyOSRMIsNotRunning = (callback) => {
         tryConnect(this.OSRM_PORT, (err) => {
             if (!err) return callback(new Error('*** osrm-routed is already running.'));
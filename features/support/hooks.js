@@ -23,7 +23,7 @@ module.exports = function () {
 
     this.BeforeFeature((feature, callback) => {
         this.profile = this.DEFAULT_PROFILE;
-        this.profileFile = path.join(this.PROFILES_PATH, this.profile + '.lua');
+        this.profileFile = this.getProfileFile(this.profile);
         this.setupFeatureCache(feature);
         callback();
     });
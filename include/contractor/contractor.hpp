@@ -65,6 +65,14 @@ class Contractor
                        std::vector<EdgeWeight> &&node_weights,
                        std::vector<bool> &is_core_node,
                        std::vector<float> &inout_node_levels) const;
+    bool
+    CustomizeGraph(const unsigned max_edge_id,
+                   const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+                   util::DeallocatingVector<QueryEdge> &contracted_edge_list) const;
+    void RenumberNodes(const std::vector<NodeID> &new_node_ids,
+                       util::DeallocatingVector<QueryEdge> &contracted_edge_list,
+                       std::vector<bool> &is_core_node) const;
+    void RenumberRTreeLeaves(const std::vector<NodeID> &new_node_ids) const;
     void WriteCoreNodeMarker(std::vector<bool> &&is_core_node) const;
     void WriteNodeLevels(std::vector<float> &&node_levels) const;
     void ReadNodeLevels(std::vector<float> &contraction_order) const;
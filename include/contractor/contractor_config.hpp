@@ -39,7 +39,10 @@ namespace contractor
 
 struct ContractorConfig
 {
-    ContractorConfig() : requested_num_threads(0) {}
+    ContractorConfig()
+        : requested_num_threads(0), renumber_nodes(false), customize_hierarchy(false)
+    {
+    }
 
     // Infer the output names from the path of the .osrm file
     void UseDefaultOutputNames()
@@ -53,6 +56,7 @@ struct ContractorConfig
         node_based_graph_path = osrm_input_path.string() + ".nodes";
         geometry_path = osrm_input_path.string() + ".geometry";
         rtree_leaf_path = osrm_input_path.string() + ".fileIndex";
+        node_order_path = osrm_input_path.string() + ".node_order";
         datasource_names_path = osrm_input_path.string() + ".datasource_names";
         datasource_indexes_path = osrm_input_path.string() + ".datasource_indexes";
     }
@@ -70,6 +74,7 @@ struct ContractorConfig
     std::string node_based_graph_path;
     std::string geometry_path;
     std::string rtree_leaf_path;
+    std::string node_order_path;
     bool use_cached_priority;
 
     unsigned requested_num_threads;
@@ -81,6 +86,14 @@ struct ContractorConfig
     //(e.g. 0.8 contracts 80 percent of the hierarchy, leaving a core of 20%)
     double core_factor;
 
+    // Renumber the nodes of the contracted graph so that a node is stored close to the nodes
+    // above it in the hierarchy. The R-tree leaves are rewritten with the new IDs.
+    bool renumber_nodes;
+
+    // Keep the node order and shortcuts of the existing .hsgr and only update their weights.
+    // Falls back to a full contraction if the new weights need shortcuts that do not exist.
+    bool customize_hierarchy;
+
     std::vector<std::string> segment_speed_lookup_paths;
     std::vector<std::string> turn_penalty_lookup_paths;
     std::string datasource_indexes_path;
@@ -3,6 +3,7 @@
 
 #include "contractor/query_edge.hpp"
 #include "util/binary_heap.hpp"
+#include "util/search_heap.hpp"
 #include "util/deallocating_vector.hpp"
 #include "util/dynamic_graph.hpp"
 #include "util/integer_range.hpp"
@@ -74,7 +75,7 @@ class GraphContractor
     //    using ContractorHeap = util::BinaryHeap<NodeID, NodeID, int, ContractorHeapData,
     //    ArrayStorage<NodeID, NodeID>
     //    >;
-    using ContractorHeap = util::BinaryHeap<NodeID,
+    using ContractorHeap = util::SearchHeap<NodeID,
                                             NodeID,
                                             int,
                                             ContractorHeapData,
@@ -0,0 +1,680 @@
+#ifndef GRAPH_CUSTOMIZER_HPP
+#define GRAPH_CUSTOMIZER_HPP
+
+#include "contractor/query_edge.hpp"
+#include "extractor/edge_based_edge.hpp"
+#include "util/deallocating_vector.hpp"
+#include "util/integer_range.hpp"
+#include "util/search_heap.hpp"
+#include "util/simple_logger.hpp"
+#include "util/typedefs.hpp"
+#include "util/xor_fast_hash_storage.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <queue>
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+/**
+ * Updates the weights of an existing contraction hierarchy after the weights of the edge-based
+ * graph changed, keeping the node order and the shortcuts of the hierarchy.
+ *
+ * All edges between two nodes are kept as one record at the node that was contracted first,
+ * with a weight per direction. Going up the hierarchy, a record is only recomputed if the weight
+ * of its original edge or of one of its lower triangles (the two records of a node contracted
+ * before both ends) changed.
+ *
+ * The node levels are only a hint for the contraction order: with cached priorities they are the
+ * priorities of an earlier contraction and neighbours can share a level. So the nodes are ranked
+ * in a topological order of the records, which go from the lower to the higher node, and the
+ * levels only break ties.
+ *
+ * The hierarchy only stays correct if every pair of neighbours of a contracted node that is not
+ * connected by a short enough record still has a witness path, so such pairs are checked with a
+ * witness search like the one of the GraphContractor. Likewise a path from a node around a
+ * contracted neighbour back to itself that is shorter than the node weight needs a self-loop. If
+ * either is missing, the new weights need a shortcut that does not exist and the graph has to be
+ * contracted again.
+ */
+class GraphCustomizer
+{
+  private:
+    static const constexpr std::size_t FORWARD = 0;
+    static const constexpr std::size_t REVERSE = 1;
+
+    // Edges between source and target, FORWARD is source -> target and REVERSE target -> source
+    struct Record
+    {
+        Record() : target(SPECIAL_NODEID)
+        {
+            weight[FORWARD] = weight[REVERSE] = INVALID_EDGE_WEIGHT;
+            id[FORWARD] = id[REVERSE] = SPECIAL_NODEID;
+            shortcut[FORWARD] = shortcut[REVERSE] = false;
+        }
+
+        NodeID target;
+        EdgeWeight weight[2];
+        NodeID id[2];
+        bool shortcut[2];
+    };
+
+    // A record of a lower node to a node, the lower node is the middle node of triangles
+    struct LowerRecord
+    {
+        NodeID middle;
+        std::size_t record;
+    };
+
+    struct Arc
+    {
+        NodeID target;
+        EdgeWeight weight;
+    };
+
+    struct WitnessHeapData
+    {
+    };
+    using WitnessHeap = util::SearchHeap<NodeID,
+                                         NodeID,
+                                         int,
+                                         WitnessHeapData,
+                                         util::XORFastHashStorage<NodeID, NodeID>>;
+
+  public:
+    // hierarchy_edges have to be sorted by source and target like the edges of a .hsgr file
+    GraphCustomizer(const NodeID number_of_nodes,
+                    const util::DeallocatingVector<QueryEdge> &hierarchy_edges,
+                    std::vector<float> node_levels_,
+                    std::vector<bool> is_core_node_,
+                    std::vector<EdgeWeight> node_weights_)
+        : number_of_nodes(number_of_nodes), node_levels(std::move(node_levels_)),
+          is_core_node(std::move(is_core_node_)), node_weights(std::move(node_weights_))
+    {
+        BOOST_ASSERT(node_levels.size() == number_of_nodes);
+        BOOST_ASSERT(node_weights.size() == number_of_nodes);
+        is_core_node.resize(number_of_nodes, false);
+
+        record_offsets.resize(number_of_nodes + 1, 0);
+        NodeID record_source = SPECIAL_NODEID;
+        for (const auto &edge : hierarchy_edges)
+        {
+            BOOST_ASSERT(edge.source < number_of_nodes);
+            if (records.empty() || record_source != edge.source ||
+                records.back().target != edge.target)
+            {
+                BOOST_ASSERT(records.empty() || record_source <= edge.source);
+                records.emplace_back();
+                records.back().target = edge.target;
+                record_source = edge.source;
+                ++record_offsets[edge.source + 1];
+            }
+
+            auto &record = records.back();
+            for (const auto direction : {FORWARD, REVERSE})
+            {
+                const bool has_direction =
+                    direction == FORWARD ? edge.data.forward : edge.data.backward;
+                if (has_direction && edge.data.weight < record.weight[direction])
+                {
+                    record.weight[direction] = edge.data.weight;
+                    record.id[direction] = edge.data.id;
+                    record.shortcut[direction] = edge.data.shortcut;
+                }
+            }
+        }
+        std::partial_sum(record_offsets.begin(), record_offsets.end(), record_offsets.begin());
+    }
+
+    // Applies the weights of the edge-based graph, new_node_ids maps the nodes of the edge-based
+    // graph to the nodes of the hierarchy (empty if they are the same).
+    // Returns false if the hierarchy has to be rebuilt for the new weights.
+    bool Run(const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edges,
+             const std::vector<NodeID> &new_node_ids)
+    {
+        old_records = records;
+        std::vector<EdgeWeight> original_weights(2 * records.size(), INVALID_EDGE_WEIGHT);
+        std::vector<NodeID> original_ids(2 * records.size(), SPECIAL_NODEID);
+
+        const auto set_original = [&](const std::size_t record,
+                                      const std::size_t direction,
+                                      const EdgeWeight weight,
+                                      const NodeID id) {
+            if (weight < original_weights[2 * record + direction])
+            {
+                original_weights[2 * record + direction] = weight;
+                original_ids[2 * record + direction] = id;
+            }
+        };
+
+        for (const auto &edge : edge_based_edges)
+        {
+            const auto source = new_node_ids.empty() ? edge.source : new_node_ids[edge.source];
+            const auto target = new_node_ids.empty() ? edge.target : new_node_ids[edge.target];
+            // eigenloops are removed by the contractor as well
+            if (source == target)
+                continue;
+
+            const EdgeWeight weight = std::max(edge.weight, 1);
+            const auto forward_record = FindRecord(source, target);
+            const auto reverse_record = FindRecord(target, source);
+            if (forward_record == SPECIAL_EDGEID && reverse_record == SPECIAL_EDGEID)
+            {
+                util::SimpleLogger().Write() << "Edge " << source << " -> " << target
+                                             << " is not part of the hierarchy";
+                return false;
+            }
+            if (forward_record != SPECIAL_EDGEID)
+            {
+                if (edge.forward)
+                    set_original(forward_record, FORWARD, weight, edge.edge_id);
+                if (edge.backward)
+                    set_original(forward_record, REVERSE, weight, edge.edge_id);
+            }
+            if (reverse_record != SPECIAL_EDGEID)
+            {
+                if (edge.forward)
+                    set_original(reverse_record, REVERSE, weight, edge.edge_id);
+                if (edge.backward)
+                    set_original(reverse_record, FORWARD, weight, edge.edge_id);
+            }
+        }
+
+        std::vector<NodeID> order;
+        if (!BuildContractionOrder(order))
+            return false;
+
+        BuildLowerRecords();
+
+        // A record has to be recomputed if its original edge changed while being the shortest
+        // connection, or if it became shorter than the shortcut.
+        std::vector<bool> dirty(records.size(), false);
+        for (const auto record : util::irange<std::size_t>(0UL, records.size()))
+        {
+            for (const auto direction : {FORWARD, REVERSE})
+            {
+                const auto &old_record = old_records[record];
+                const auto original_weight = original_weights[2 * record + direction];
+                if ((!old_record.shortcut[direction] &&
+                     original_weight != old_record.weight[direction]) ||
+                    original_weight < old_record.weight[direction])
+                {
+                    dirty[record] = true;
+                }
+            }
+        }
+
+        std::size_t recomputed_records = 0;
+        std::size_t changed_records = 0;
+        std::vector<bool> changed(records.size(), false);
+        for (const auto node : order)
+        {
+            bool node_changed = false;
+            for (const auto record : util::irange(record_offsets[node], record_offsets[node + 1]))
+            {
+                if (!dirty[record])
+                    continue;
+
+                ++recomputed_records;
+                RecomputeRecord(node, record, original_weights, original_ids);
+                const auto &old_record = old_records[record];
+                changed[record] = records[record].weight[FORWARD] != old_record.weight[FORWARD] ||
+                                  records[record].weight[REVERSE] != old_record.weight[REVERSE];
+                if (changed[record])
+                {
+                    ++changed_records;
+                    node_changed = true;
+                }
+            }
+
+            // the core is not contracted, its nodes are no middle nodes
+            if (!node_changed || is_core_node[node])
+                continue;
+
+            for (const auto first : util::irange(record_offsets[node], record_offsets[node + 1]))
+            {
+                for (const auto second : util::irange(first, record_offsets[node + 1]))
+                {
+                    if (!changed[first] && !changed[second])
+                        continue;
+
+                    const auto first_target = records[first].target;
+                    const auto second_target = records[second].target;
+                    if (first_target == node || second_target == node)
+                        continue;
+
+                    const auto record = FindRecord(first_target, second_target);
+                    if (record != SPECIAL_EDGEID)
+                        dirty[record] = true;
+                    const auto mirrored_record = FindRecord(second_target, first_target);
+                    if (mirrored_record != SPECIAL_EDGEID)
+                        dirty[mirrored_record] = true;
+                }
+            }
+        }
+
+        util::SimpleLogger().Write() << "Recomputed " << recomputed_records << " of "
+                                     << records.size() << " hierarchy edges, " << changed_records
+                                     << " changed";
+
+        if (changed_records == 0)
+            return true;
+
+        // The witness searches of a contracted node only use records between nodes above it. So
+        // only the nodes with a changed record of their own, and the nodes below a record that
+        // got longer, can lose a witness or need a new self-loop.
+        NodeID lowest_increased_rank = 0;
+        std::vector<bool> check_middle(number_of_nodes, false);
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        {
+            for (const auto record : util::irange(record_offsets[node], record_offsets[node + 1]))
+            {
+                if (!changed[record])
+                    continue;
+
+                check_middle[node] = true;
+                const auto &old_record = old_records[record];
+                if (records[record].weight[FORWARD] > old_record.weight[FORWARD] ||
+                    records[record].weight[REVERSE] > old_record.weight[REVERSE])
+                {
+                    lowest_increased_rank = std::max(
+                        lowest_increased_rank,
+                        std::min(node_ranks[node], node_ranks[records[record].target]));
+                }
+            }
+        }
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        {
+            if (!is_core_node[node] && node_ranks[node] < lowest_increased_rank)
+                check_middle[node] = true;
+        }
+
+        return HasWitnesses(check_middle);
+    }
+
+    // Edges of the customized hierarchy with forward and backward merged if they are the same
+    void GetEdges(util::DeallocatingVector<QueryEdge> &edges) const
+    {
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        {
+            for (const auto record : util::irange(record_offsets[node], record_offsets[node + 1]))
+            {
+                const auto &data = records[record];
+                const auto make_edge = [&](const std::size_t direction) {
+                    QueryEdge edge;
+                    edge.source = node;
+                    edge.target = data.target;
+                    edge.data.weight = data.weight[direction];
+                    edge.data.id = data.id[direction];
+                    edge.data.shortcut = data.shortcut[direction];
+                    edge.data.forward = direction == FORWARD;
+                    edge.data.backward = direction == REVERSE;
+                    return edge;
+                };
+
+                const bool has_forward = data.weight[FORWARD] != INVALID_EDGE_WEIGHT;
+                const bool has_reverse = data.weight[REVERSE] != INVALID_EDGE_WEIGHT;
+                if (has_forward && has_reverse && data.weight[FORWARD] == data.weight[REVERSE] &&
+                    data.id[FORWARD] == data.id[REVERSE] &&
+                    data.shortcut[FORWARD] == data.shortcut[REVERSE])
+                {
+                    auto edge = make_edge(FORWARD);
+                    edge.data.backward = true;
+                    edges.push_back(edge);
+                    continue;
+                }
+                if (has_forward)
+                    edges.push_back(make_edge(FORWARD));
+                if (has_reverse)
+                    edges.push_back(make_edge(REVERSE));
+            }
+        }
+    }
+
+  private:
+    // Sorts the contracted nodes from the bottom of the hierarchy to the top, followed by the core,
+    // and ranks them in that order. Returns false if the records contain a cycle.
+    bool BuildContractionOrder(std::vector<NodeID> &order)
+    {
+        // records of contracted nodes to higher contracted nodes
+        std::vector<std::size_t> lower_neighbours(number_of_nodes, 0);
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        {
+            if (is_core_node[node])
+                continue;
+            for (const auto record : util::irange(record_offsets[node], record_offsets[node + 1]))
+            {
+                const auto target = records[record].target;
+                if (target != node && !is_core_node[target])
+                    ++lower_neighbours[target];
+            }
+        }
+
+        using QueueEntry = std::pair<float, NodeID>;
+        std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        {
+            if (!is_core_node[node] && lower_neighbours[node] == 0)
+                queue.emplace(node_levels[node], node);
+        }
+
+        order.clear();
+        order.reserve(number_of_nodes);
+        while (!queue.empty())
+        {
+            const auto node = queue.top().second;
+            queue.pop();
+            order.push_back(node);
+            for (const auto record : util::irange(record_offsets[node], record_offsets[node + 1]))
+            {
+                const auto target = records[record].target;
+                if (target != node && !is_core_node[target] && --lower_neighbours[target] == 0)
+                    queue.emplace(node_levels[target], target);
+            }
+        }
+
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        {
+            if (is_core_node[node])
+                order.push_back(node);
+        }
+        if (order.size() != number_of_nodes)
+        {
+            util::SimpleLogger().Write() << "Hierarchy edges contain a cycle";
+            return false;
+        }
+
+        node_ranks.resize(number_of_nodes);
+        for (const auto rank : util::irange<NodeID>(0, number_of_nodes))
+            node_ranks[order[rank]] = rank;
+        return true;
+    }
+
+    // Weight of the record from source to target, which is stored at the lower of both
+    EdgeWeight GetRecordWeight(const NodeID source, const NodeID target) const
+    {
+        EdgeWeight weight = INVALID_EDGE_WEIGHT;
+        const auto forward_record = FindRecord(source, target);
+        if (forward_record != SPECIAL_EDGEID)
+            weight = std::min(weight, records[forward_record].weight[FORWARD]);
+        const auto reverse_record = FindRecord(target, source);
+        if (reverse_record != SPECIAL_EDGEID)
+            weight = std::min(weight, records[reverse_record].weight[REVERSE]);
+        return weight;
+    }
+
+    std::size_t FindRecord(const NodeID source, const NodeID target) const
+    {
+        const auto first = records.begin() + record_offsets[source];
+        const auto last = records.begin() + record_offsets[source + 1];
+        const auto iter =
+            std::lower_bound(first, last, target, [](const Record &record, const NodeID node) {
+                return record.target < node;
+            });
+        if (iter == last || iter->target != target)
+            return SPECIAL_EDGEID;
+        return std::distance(records.begin(), iter);
+    }
+
+    // The records of contracted nodes grouped by their target, each group sorted by the middle
+    void BuildLowerRecords()
+    {
+        lower_offsets.assign(number_of_nodes + 1, 0);
+        const auto for_each_lower_record = [this](const auto &callback) {
+            for (const auto middle : util::irange<NodeID>(0, number_of_nodes))
+            {
+                if (is_core_node[middle])
+                    continue;
+                for (const auto record :
+                     util::irange(record_offsets[middle], record_offsets[middle + 1]))
+                {
+                    if (records[record].target != middle)
+                        callback(middle, record);
+                }
+            }
+        };
+
+        for_each_lower_record([this](const NodeID, const std::size_t record) {
+            ++lower_offsets[records[record].target + 1];
+        });
+        std::partial_sum(lower_offsets.begin(), lower_offsets.end(), lower_offsets.begin());
+
+        lower_records.resize(lower_offsets.back());
+        std::vector<std::size_t> insert_position(lower_offsets.begin(), lower_offsets.end() - 1);
+        for_each_lower_record([&](const NodeID middle, const std::size_t record) {
+            lower_records[insert_position[records[record].target]++] = LowerRecord{middle, record};
+        });
+    }
+
+    void RecomputeRecord(const NodeID source,
+                         const std::size_t record,
+                         const std::vector<EdgeWeight> &original_weights,
+                         const std::vector<NodeID> &original_ids)
+    {
+        auto &data = records[record];
+        const auto target = data.target;
+        for (const auto direction : {FORWARD, REVERSE})
+        {
+            data.weight[direction] = original_weights[2 * record + direction];
+            data.id[direction] = original_ids[2 * record + direction];
+            data.shortcut[direction] = false;
+        }
+
+        const auto relax = [&data](const std::size_t direction,
+                                   const EdgeWeight first,
+                                   const EdgeWeight second,
+                                   const NodeID middle) {
+            if (first == INVALID_EDGE_WEIGHT || second == INVALID_EDGE_WEIGHT)
+                return;
+            if (first + second < data.weight[direction])
+            {
+                data.weight[direction] = first + second;
+                data.id[direction] = middle;
+                data.shortcut[direction] = true;
+            }
+        };
+
+        // intersect the middle nodes below source and target
+        auto source_iter = lower_records.begin() + lower_offsets[source];
+        const auto source_end = lower_records.begin() + lower_offsets[source + 1];
+        auto target_iter = lower_records.begin() + lower_offsets[target];
+        const auto target_end = lower_records.begin() + lower_offsets[target + 1];
+        while (source_iter != source_end && target_iter != target_end)
+        {
+            if (source_iter->middle < target_iter->middle)
+            {
+                ++source_iter;
+            }
+            else if (target_iter->middle < source_iter->middle)
+            {
+                ++target_iter;
+            }
+            else
+            {
+                // records are stored at the middle node, their REVERSE direction leads to it
+                const auto &to_source = records[source_iter->record];
+                const auto &to_target = records[target_iter->record];
+                relax(FORWARD,
+                      to_source.weight[REVERSE],
+                      to_target.weight[FORWARD],
+                      source_iter->middle);
+                relax(REVERSE,
+                      to_target.weight[REVERSE],
+                      to_source.weight[FORWARD],
+                      source_iter->middle);
+                ++source_iter;
+                ++target_iter;
+            }
+        }
+    }
+
+    // Checks that the pairs of neighbours of the contracted nodes in check_middle that are not
+    // connected by a record of at most the weight of the path via the contracted node have a
+    // witness path of at most that weight, and that such paths back to the same neighbour have a
+    // self-loop if the contractor would have added one.
+    bool HasWitnesses(const std::vector<bool> &check_middle) const
+    {
+        // arcs of both directions of all records
+        std::vector<std::size_t> arc_offsets(number_of_nodes + 1, 0);
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        {
+            for (const auto record : util::irange(record_offsets[node], record_offsets[node + 1]))
+            {
+                if (records[record].weight[FORWARD] != INVALID_EDGE_WEIGHT)
+                    ++arc_offsets[node + 1];
+                if (records[record].weight[REVERSE] != INVALID_EDGE_WEIGHT)
+                    ++arc_offsets[records[record].target + 1];
+            }
+        }
+        std::partial_sum(arc_offsets.begin(), arc_offsets.end(), arc_offsets.begin());
+        std::vector<Arc> arcs(arc_offsets.back());
+        std::vector<std::size_t> insert_position(arc_offsets.begin(), arc_offsets.end() - 1);
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        {
+            for (const auto record : util::irange(record_offsets[node], record_offsets[node + 1]))
+            {
+                const auto &data = records[record];
+                if (data.weight[FORWARD] != INVALID_EDGE_WEIGHT)
+                    arcs[insert_position[node]++] = Arc{data.target, data.weight[FORWARD]};
+                if (data.weight[REVERSE] != INVALID_EDGE_WEIGHT)
+                    arcs[insert_position[data.target]++] = Arc{node, data.weight[REVERSE]};
+            }
+        }
+
+        // same limit as the witness search of the final contraction
+        const int constexpr WITNESS_SEARCH_SPACE_SIZE = 2000;
+
+        tbb::enumerable_thread_specific<std::unique_ptr<WitnessHeap>> heaps;
+        std::atomic<bool> has_witnesses{true};
+        std::atomic<std::size_t> witness_searches{0};
+        tbb::parallel_for(NodeID{0}, number_of_nodes, [&](const NodeID middle) {
+            if (!has_witnesses || !check_middle[middle] || is_core_node[middle])
+                return;
+
+            auto &heap = heaps.local();
+            if (!heap)
+                heap = std::make_unique<WitnessHeap>(number_of_nodes);
+
+            // the pairs that are not connected by a short enough record
+            const auto needs_witness = [&](const NodeID source,
+                                           const NodeID target,
+                                           const EdgeWeight path_weight) {
+                return target != middle && target != source &&
+                       GetRecordWeight(source, target) > path_weight;
+            };
+
+            const auto first = record_offsets[middle];
+            const auto last = record_offsets[middle + 1];
+            for (const auto in_record : util::irange(first, last))
+            {
+                const auto source = records[in_record].target;
+                const auto in_weight = records[in_record].weight[REVERSE];
+                if (source == middle || in_weight == INVALID_EDGE_WEIGHT)
+                    continue;
+
+                // the contractor adds a self-loop for a way around the middle node that is
+                // shorter than its node weight
+                const auto loop_out_weight = records[in_record].weight[FORWARD];
+                if (loop_out_weight != INVALID_EDGE_WEIGHT &&
+                    in_weight + loop_out_weight < node_weights[middle] &&
+                    GetRecordWeight(source, source) > in_weight + loop_out_weight)
+                {
+                    util::SimpleLogger().Write() << "Missing self-loop " << source << " -> "
+                                                 << middle << " -> " << source;
+                    has_witnesses = false;
+                    return;
+                }
+
+                int max_weight = 0;
+                for (const auto out_record : util::irange(first, last))
+                {
+                    const auto target = records[out_record].target;
+                    const auto out_weight = records[out_record].weight[FORWARD];
+                    if (out_weight != INVALID_EDGE_WEIGHT &&
+                        needs_witness(source, target, in_weight + out_weight))
+                    {
+                        max_weight = std::max(max_weight, in_weight + out_weight);
+                    }
+                }
+                if (max_weight == 0)
+                    continue;
+
+                // only nodes that are ranked after the middle node
+                ++witness_searches;
+                heap->Clear();
+                heap->Insert(source, 0, WitnessHeapData{});
+                int settled_nodes = 0;
+                while (!heap->Empty() && ++settled_nodes <= WITNESS_SEARCH_SPACE_SIZE)
+                {
+                    const auto node = heap->DeleteMin();
+                    const auto weight = heap->GetKey(node);
+                    if (weight > max_weight)
+                        break;
+                    for (const auto arc : util::irange(arc_offsets[node], arc_offsets[node + 1]))
+                    {
+                        const auto to = arcs[arc].target;
+                        if (node_ranks[to] <= node_ranks[middle])
+                            continue;
+                        const auto to_weight = weight + arcs[arc].weight;
+                        if (!heap->WasInserted(to))
+                            heap->Insert(to, to_weight, WitnessHeapData{});
+                        else if (to_weight < heap->GetKey(to))
+                            heap->DecreaseKey(to, to_weight);
+                    }
+                }
+
+                for (const auto out_record : util::irange(first, last))
+                {
+                    const auto target = records[out_record].target;
+                    const auto out_weight = records[out_record].weight[FORWARD];
+                    if (out_weight == INVALID_EDGE_WEIGHT ||
+                        !needs_witness(source, target, in_weight + out_weight))
+                        continue;
+                    if (!heap->WasInserted(target) ||
+                        heap->GetKey(target) > in_weight + out_weight)
+                    {
+                        util::SimpleLogger().Write()
+                            << "Missing shortcut " << source << " -> " << middle << " -> "
+                            << target;
+                        has_witnesses = false;
+                        return;
+                    }
+                }
+            }
+        });
+
+        util::SimpleLogger().Write() << "Ran " << witness_searches << " witness searches";
+
+        return has_witnesses;
+    }
+
+    const NodeID number_of_nodes;
+    std::vector<float> node_levels;
+    std::vector<bool> is_core_node;
+    // position of the nodes in the contraction order
+    std::vector<NodeID> node_ranks;
+    // the node weights of the edge-based graph, see the self-loops of the GraphContractor
+    std::vector<EdgeWeight> node_weights;
+
+    std::vector<std::size_t> record_offsets;
+    std::vector<Record> records;
+    std::vector<Record> old_records;
+
+    std::vector<std::size_t> lower_offsets;
+    std::vector<LowerRecord> lower_records;
+};
+}
+}
+
+#endif // GRAPH_CUSTOMIZER_HPP
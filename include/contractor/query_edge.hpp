@@ -14,10 +14,48 @@ struct QueryEdge
 {
     NodeID source;
     NodeID target;
+
+    // The engine stores EdgeData split into two arrays: the weight and directions a search
+    // reads for every relaxed edge, and the middle node of a shortcut or the id of an
+    // original edge that is only needed when unpacking a path.
+    struct SearchData
+    {
+        SearchData() : weight(0), forward(false), backward(false) {}
+
+        template <class OtherT> SearchData(const OtherT &other)
+        {
+            weight = other.weight;
+            forward = other.forward;
+            backward = other.backward;
+        }
+        int weight : 30;
+        bool forward : 1;
+        bool backward : 1;
+    };
+
+    struct UnpackData
+    {
+        UnpackData() : id(0), shortcut(false) {}
+
+        template <class OtherT> UnpackData(const OtherT &other)
+        {
+            id = other.id;
+            shortcut = other.shortcut;
+        }
+        NodeID id : 31;
+        bool shortcut : 1;
+    };
+
     struct EdgeData
     {
         EdgeData() : id(0), shortcut(false), weight(0), forward(false), backward(false) {}
 
+        EdgeData(const SearchData &search_data, const UnpackData &unpack_data)
+            : id(unpack_data.id), shortcut(unpack_data.shortcut), weight(search_data.weight),
+              forward(search_data.forward), backward(search_data.backward)
+        {
+        }
+
         template <class OtherT> EdgeData(const OtherT &other)
         {
             weight = other.weight;
@@ -53,6 +91,11 @@ struct QueryEdge
                 data.id == right.data.id);
     }
 };
+
+#ifndef _MSC_VER // MSVC does not pack bit fields of different types together
+static_assert(sizeof(QueryEdge::SearchData) == 4, "SearchData is not packed into 32 bit");
+static_assert(sizeof(QueryEdge::UnpackData) == 4, "UnpackData is not packed into 32 bit");
+#endif
 }
 }
 
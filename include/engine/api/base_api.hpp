@@ -6,6 +6,7 @@
 
 #include "engine/api/json_factory.hpp"
 #include "engine/hint.hpp"
+#include "util/binary_writer.hpp"
 
 #include <boost/assert.hpp>
 #include <boost/range/algorithm/transform.hpp>
@@ -53,6 +54,22 @@ class BaseAPI
                                   Hint{phantom, facade.GetCheckSum()});
     }
 
+    void WriteWaypoint(util::json::Writer &writer, const PhantomNode &phantom) const
+    {
+        json::writeWaypoint(writer,
+                            phantom.location,
+                            facade.GetNameForID(phantom.name_id),
+                            Hint{phantom, facade.GetCheckSum()});
+    }
+
+    void WriteWaypoint(util::binary::Writer &writer, const PhantomNode &phantom) const
+    {
+        writer.Int32(static_cast<std::int32_t>(phantom.location.lon));
+        writer.Int32(static_cast<std::int32_t>(phantom.location.lat));
+        writer.String(facade.GetNameForID(phantom.name_id));
+        writer.String(Hint{phantom, facade.GetCheckSum()}.ToBase64());
+    }
+
     const datafacade::BaseDataFacade &facade;
     const BaseParameters &parameters;
 };
@@ -11,6 +11,7 @@
 #include "engine/polyline_compressor.hpp"
 #include "util/coordinate.hpp"
 #include "util/json_container.hpp"
+#include "util/json_writer.hpp"
 
 #include <boost/optional.hpp>
 
@@ -83,6 +84,12 @@ util::json::Object makeRoute(const guidance::Route &route,
 util::json::Object
 makeWaypoint(const util::Coordinate location, std::string name, const Hint &hint);
 
+// Streaming counterpart of makeWaypoint
+void writeWaypoint(util::json::Writer &writer,
+                   const util::Coordinate location,
+                   const std::string &name,
+                   const Hint &hint);
+
 util::json::Object makeRouteLeg(guidance::RouteLeg leg, util::json::Array steps);
 
 util::json::Array makeRouteLegs(std::vector<guidance::RouteLeg> legs,
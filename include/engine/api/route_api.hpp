@@ -17,6 +17,7 @@
 
 #include "engine/internal_route_result.hpp"
 
+#include "util/binary_writer.hpp"
 #include "util/coordinate.hpp"
 #include "util/integer_range.hpp"
 
@@ -49,8 +50,9 @@ class RouteAPI : public BaseAPI
                                      raw_route.target_traversed_in_reverse);
         if (raw_route.has_alternative())
         {
-            std::vector<std::vector<PathData>> wrapped_leg(1);
-            wrapped_leg.front() = std::move(raw_route.unpacked_alternative);
+            // raw_route is const, std::move would copy anyway
+            const std::vector<std::vector<PathData>> wrapped_leg(1,
+                                                                 raw_route.unpacked_alternative);
             routes.values[1] = MakeRoute(raw_route.segment_end_coordinates,
                                          wrapped_leg,
                                          raw_route.alt_source_traversed_in_reverse,
@@ -61,6 +63,41 @@ class RouteAPI : public BaseAPI
         response.values["code"] = "Ok";
     }
 
+    // Writes the binary format: waypoints followed by the routes with their legs and the
+    // overview geometry as packed int32 lon/lat pairs. Steps and annotations are not encoded.
+    void MakeResponse(const InternalRouteResult &raw_route, util::binary::Writer &writer) const
+    {
+        BOOST_ASSERT(!parameters.steps && !parameters.annotations);
+
+        writer.Header();
+        writer.String("Ok");
+
+        writer.UInt32(static_cast<std::uint32_t>(parameters.coordinates.size()));
+        BaseAPI::WriteWaypoint(writer, raw_route.segment_end_coordinates.front().source_phantom);
+        for (const auto &phantoms : raw_route.segment_end_coordinates)
+        {
+            BaseAPI::WriteWaypoint(writer, phantoms.target_phantom);
+        }
+
+        writer.UInt32(raw_route.has_alternative() ? 2 : 1);
+        WriteRoute(writer,
+                   raw_route.segment_end_coordinates,
+                   raw_route.unpacked_path_segments,
+                   raw_route.source_traversed_in_reverse,
+                   raw_route.target_traversed_in_reverse);
+        if (raw_route.has_alternative())
+        {
+            // raw_route is const, std::move would copy anyway
+            const std::vector<std::vector<PathData>> wrapped_leg(1,
+                                                                 raw_route.unpacked_alternative);
+            WriteRoute(writer,
+                       raw_route.segment_end_coordinates,
+                       wrapped_leg,
+                       raw_route.alt_source_traversed_in_reverse,
+                       raw_route.alt_target_traversed_in_reverse);
+        }
+    }
+
     // FIXME gcc 4.8 doesn't support for lambdas to call protected member functions
     //  protected:
     template <typename ForwardIter>
@@ -75,13 +112,13 @@ class RouteAPI : public BaseAPI
         return json::makeGeoJSONGeometry(begin, end);
     }
 
-    util::json::Object MakeRoute(const std::vector<PhantomNodes> &segment_end_coordinates,
-                                 const std::vector<std::vector<PathData>> &unpacked_path_segments,
-                                 const std::vector<bool> &source_traversed_in_reverse,
-                                 const std::vector<bool> &target_traversed_in_reverse) const
+    void AssembleLegs(const std::vector<PhantomNodes> &segment_end_coordinates,
+                      const std::vector<std::vector<PathData>> &unpacked_path_segments,
+                      const std::vector<bool> &source_traversed_in_reverse,
+                      const std::vector<bool> &target_traversed_in_reverse,
+                      std::vector<guidance::RouteLeg> &legs,
+                      std::vector<guidance::LegGeometry> &leg_geometries) const
     {
-        std::vector<guidance::RouteLeg> legs;
-        std::vector<guidance::LegGeometry> leg_geometries;
         auto number_of_legs = segment_end_coordinates.size();
         legs.reserve(number_of_legs);
         leg_geometries.reserve(number_of_legs);
@@ -159,6 +196,21 @@ class RouteAPI : public BaseAPI
             leg_geometries.push_back(std::move(leg_geometry));
             legs.push_back(std::move(leg));
         }
+    }
+
+    util::json::Object MakeRoute(const std::vector<PhantomNodes> &segment_end_coordinates,
+                                 const std::vector<std::vector<PathData>> &unpacked_path_segments,
+                                 const std::vector<bool> &source_traversed_in_reverse,
+                                 const std::vector<bool> &target_traversed_in_reverse) const
+    {
+        std::vector<guidance::RouteLeg> legs;
+        std::vector<guidance::LegGeometry> leg_geometries;
+        AssembleLegs(segment_end_coordinates,
+                     unpacked_path_segments,
+                     source_traversed_in_reverse,
+                     target_traversed_in_reverse,
+                     legs,
+                     leg_geometries);
 
         auto route = guidance::assembleRoute(legs);
         boost::optional<util::json::Value> json_overview;
@@ -246,6 +298,47 @@ class RouteAPI : public BaseAPI
         return result;
     }
 
+    void WriteRoute(util::binary::Writer &writer,
+                    const std::vector<PhantomNodes> &segment_end_coordinates,
+                    const std::vector<std::vector<PathData>> &unpacked_path_segments,
+                    const std::vector<bool> &source_traversed_in_reverse,
+                    const std::vector<bool> &target_traversed_in_reverse) const
+    {
+        std::vector<guidance::RouteLeg> legs;
+        std::vector<guidance::LegGeometry> leg_geometries;
+        AssembleLegs(segment_end_coordinates,
+                     unpacked_path_segments,
+                     source_traversed_in_reverse,
+                     target_traversed_in_reverse,
+                     legs,
+                     leg_geometries);
+
+        const auto route = guidance::assembleRoute(legs);
+        writer.Double(route.distance);
+        writer.Double(route.duration);
+
+        writer.UInt32(static_cast<std::uint32_t>(legs.size()));
+        for (const auto &leg : legs)
+        {
+            writer.Double(leg.distance);
+            writer.Double(leg.duration);
+            writer.String(leg.summary);
+        }
+
+        std::vector<util::Coordinate> overview;
+        if (parameters.overview != RouteParameters::OverviewType::False)
+        {
+            overview = guidance::assembleOverview(
+                leg_geometries, parameters.overview == RouteParameters::OverviewType::Simplified);
+        }
+        writer.StartInt32Array(2 * overview.size());
+        for (const auto &coordinate : overview)
+        {
+            writer.Int32(static_cast<std::int32_t>(coordinate.lon));
+            writer.Int32(static_cast<std::int32_t>(coordinate.lat));
+        }
+    }
+
     const RouteParameters &parameters;
 };
 
@@ -15,10 +15,12 @@
 
 #include "engine/internal_route_result.hpp"
 
+#include "util/binary_writer.hpp"
 #include "util/integer_range.hpp"
 
 #include <boost/range/algorithm/transform.hpp>
 
+#include <algorithm>
 #include <iterator>
 
 namespace osrm
@@ -70,6 +72,79 @@ class TableAPI final : public BaseAPI
         response.values["code"] = "Ok";
     }
 
+    // Streams the same response as above without building a json::Object first
+    virtual void MakeResponse(const std::vector<EdgeWeight> &durations,
+                              const std::vector<PhantomNode> &phantoms,
+                              util::json::Writer &writer) const
+    {
+        auto number_of_sources = parameters.sources.size();
+        auto number_of_destinations = parameters.destinations.size();
+
+        writer.StartObject();
+        writer.Key("code");
+        writer.String("Ok");
+
+        writer.Key("sources");
+        if (parameters.sources.empty())
+        {
+            WriteWaypoints(writer, phantoms);
+            number_of_sources = phantoms.size();
+        }
+        else
+        {
+            WriteWaypoints(writer, phantoms, parameters.sources);
+        }
+
+        writer.Key("destinations");
+        if (parameters.destinations.empty())
+        {
+            WriteWaypoints(writer, phantoms);
+            number_of_destinations = phantoms.size();
+        }
+        else
+        {
+            WriteWaypoints(writer, phantoms, parameters.destinations);
+        }
+
+        writer.Key("durations");
+        WriteTable(writer, durations, number_of_sources, number_of_destinations);
+        writer.EndObject();
+    }
+
+    // Writes the binary format: sources, destinations and the row-major durations in tenths
+    // of a second as a packed int32 array, -1 if there is no route
+    virtual void MakeResponse(const std::vector<EdgeWeight> &durations,
+                              const std::vector<PhantomNode> &phantoms,
+                              util::binary::Writer &writer) const
+    {
+        writer.Header();
+        writer.String("Ok");
+
+        if (parameters.sources.empty())
+        {
+            WriteWaypoints(writer, phantoms);
+        }
+        else
+        {
+            WriteWaypoints(writer, phantoms, parameters.sources);
+        }
+
+        if (parameters.destinations.empty())
+        {
+            WriteWaypoints(writer, phantoms);
+        }
+        else
+        {
+            WriteWaypoints(writer, phantoms, parameters.destinations);
+        }
+
+        writer.StartInt32Array(durations.size());
+        for (const EdgeWeight duration : durations)
+        {
+            writer.Int32(duration == INVALID_EDGE_WEIGHT ? -1 : duration);
+        }
+    }
+
     // FIXME gcc 4.8 doesn't support for lambdas to call protected member functions
     //  protected:
     virtual util::json::Array MakeWaypoints(const std::vector<PhantomNode> &phantoms) const
@@ -125,6 +200,79 @@ class TableAPI final : public BaseAPI
         return json_table;
     }
 
+    virtual void WriteWaypoints(util::json::Writer &writer,
+                                const std::vector<PhantomNode> &phantoms) const
+    {
+        BOOST_ASSERT(phantoms.size() == parameters.coordinates.size());
+        writer.StartArray();
+        for (const auto &phantom : phantoms)
+        {
+            BaseAPI::WriteWaypoint(writer, phantom);
+        }
+        writer.EndArray();
+    }
+
+    virtual void WriteWaypoints(util::json::Writer &writer,
+                                const std::vector<PhantomNode> &phantoms,
+                                const std::vector<std::size_t> &indices) const
+    {
+        writer.StartArray();
+        for (const auto idx : indices)
+        {
+            BOOST_ASSERT(idx < phantoms.size());
+            BaseAPI::WriteWaypoint(writer, phantoms[idx]);
+        }
+        writer.EndArray();
+    }
+
+    virtual void WriteTable(util::json::Writer &writer,
+                            const std::vector<EdgeWeight> &values,
+                            std::size_t number_of_rows,
+                            std::size_t number_of_columns) const
+    {
+        writer.StartArray();
+        for (const auto row : util::irange<std::size_t>(0UL, number_of_rows))
+        {
+            writer.StartArray();
+            const auto row_begin = values.begin() + (row * number_of_columns);
+            std::for_each(row_begin, row_begin + number_of_columns, [&](const EdgeWeight duration) {
+                if (duration == INVALID_EDGE_WEIGHT)
+                {
+                    writer.Null();
+                }
+                else
+                {
+                    writer.Number(duration / 10.);
+                }
+            });
+            writer.EndArray();
+        }
+        writer.EndArray();
+    }
+
+    virtual void WriteWaypoints(util::binary::Writer &writer,
+                                const std::vector<PhantomNode> &phantoms) const
+    {
+        BOOST_ASSERT(phantoms.size() == parameters.coordinates.size());
+        writer.UInt32(static_cast<std::uint32_t>(phantoms.size()));
+        for (const auto &phantom : phantoms)
+        {
+            BaseAPI::WriteWaypoint(writer, phantom);
+        }
+    }
+
+    virtual void WriteWaypoints(util::binary::Writer &writer,
+                                const std::vector<PhantomNode> &phantoms,
+                                const std::vector<std::size_t> &indices) const
+    {
+        writer.UInt32(static_cast<std::uint32_t>(indices.size()));
+        for (const auto idx : indices)
+        {
+            BOOST_ASSERT(idx < phantoms.size());
+            BaseAPI::WriteWaypoint(writer, phantoms[idx]);
+        }
+    }
+
     const TableParameters &parameters;
 };
 
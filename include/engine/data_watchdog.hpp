@@ -6,13 +6,19 @@
 #include "storage/shared_barriers.hpp"
 #include "storage/shared_datatype.hpp"
 #include "storage/shared_memory.hpp"
+#include "util/rtree_warmup.hpp"
+#include "util/simple_logger.hpp"
 
+#include <boost/filesystem/path.hpp>
 #include <boost/interprocess/sync/named_upgradable_mutex.hpp>
-#include <boost/thread/lock_types.hpp>
-#include <boost/thread/locks.hpp>
-#include <boost/thread/shared_mutex.hpp>
+#include <boost/interprocess/sync/sharable_lock.hpp>
 
+#include <chrono>
+#include <condition_variable>
+#include <exception>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 namespace osrm
 {
@@ -23,104 +29,142 @@ namespace engine
 // the data and layout regions that should be used. This region is updated
 // once a new dataset arrives.
 //
-// TODO: This also needs a shared memory reader lock with other clients and
-// possibly osrm-datastore since updating the CURRENT_REGIONS data is not atomic.
-// Currently we enfore this by waiting that all queries have finished before
-// osrm-datastore writes to this section.
+// Queries never touch the interprocess mutexes: they atomically load a reference counted
+// snapshot of the current facade. A background thread polls the regions table and publishes a
+// new facade once osrm-datastore has loaded a new dataset. Every facade holds a sharable lock
+// on its data region for as long as it lives, so the old region is only released to
+// osrm-datastore once the last query that still uses it has finished.
 class DataWatchdog
 {
   public:
-    DataWatchdog()
+    explicit DataWatchdog(const util::RTreeWarmup rtree_warmup_ = util::RTreeWarmup::None,
+                          boost::filesystem::path rtree_hot_pages_path_ = {})
         : shared_barriers{std::make_shared<storage::SharedBarriers>()},
           shared_regions(storage::makeSharedMemory(storage::CURRENT_REGIONS)),
-          current_timestamp{storage::LAYOUT_NONE, storage::DATA_NONE, 0}
+          current_timestamp{storage::LAYOUT_NONE, storage::DATA_NONE, 0},
+          rtree_warmup(rtree_warmup_), rtree_hot_pages_path(std::move(rtree_hot_pages_path_)),
+          active(true)
     {
+        // Load the initial dataset synchronously, so the first query already has data
+        Update();
+        watcher = std::thread(&DataWatchdog::Run, this);
     }
 
+    ~DataWatchdog()
+    {
+        {
+            std::lock_guard<std::mutex> lock(watcher_mutex);
+            active = false;
+        }
+        watcher_condition.notify_one();
+        watcher.join();
+
+        // the next start warms up with the pages of the last dataset
+        std::lock_guard<std::mutex> lock(watcher_mutex);
+        SaveHotLeafPages();
+    }
+
+    DataWatchdog(const DataWatchdog &) = delete;
+    DataWatchdog &operator=(const DataWatchdog &) = delete;
+
     // Tries to connect to the shared memory containing the regions table
     static bool TryConnect()
     {
         return storage::SharedMemory::RegionExists(storage::CURRENT_REGIONS);
     }
 
-    using RegionsLock =
-        boost::interprocess::sharable_lock<boost::interprocess::named_sharable_mutex>;
-    using LockAndFacade = std::pair<RegionsLock, std::shared_ptr<datafacade::BaseDataFacade>>;
-
-    // This will either update the contens of facade or just leave it as is
-    // if the update was already done by another thread
-    LockAndFacade GetDataFacade()
+    // Returns a snapshot of the newest dataset. The data stays valid for as long as the returned
+    // pointer is held, even if a new dataset is published in the meantime.
+    std::shared_ptr<datafacade::BaseDataFacade> GetDataFacade() const
     {
-        const boost::interprocess::sharable_lock<boost::interprocess::named_upgradable_mutex> lock(
-            shared_barriers->current_regions_mutex);
+        return std::atomic_load(&facade);
+    }
 
-        const auto shared_timestamp =
-            static_cast<const storage::SharedDataTimestamp *>(shared_regions->Ptr());
+  private:
+    void Run()
+    {
+        // how often the regions table is checked for a new dataset
+        const std::chrono::milliseconds poll_interval{100};
 
-        const auto get_locked_facade = [this, shared_timestamp]() {
-            if (current_timestamp.data == storage::DATA_1)
+        std::unique_lock<std::mutex> lock(watcher_mutex);
+        while (!watcher_condition.wait_for(lock, poll_interval, [this] { return !active; }))
+        {
+            try
             {
-                BOOST_ASSERT(current_timestamp.layout == storage::LAYOUT_1);
-                return std::make_pair(RegionsLock(shared_barriers->regions_1_mutex), facade);
+                Update();
             }
-            else
+            catch (const std::exception &e)
             {
-                BOOST_ASSERT(current_timestamp.layout == storage::LAYOUT_2);
-                BOOST_ASSERT(current_timestamp.data == storage::DATA_2);
-                return std::make_pair(RegionsLock(shared_barriers->regions_2_mutex), facade);
+                // keep serving the old dataset, the next poll will try again
+                util::SimpleLogger().Write(logWARNING) << "Could not load new dataset: "
+                                                       << e.what();
             }
-        };
+        }
+    }
 
-        // this blocks handle the common case when there is no data update -> we will only need a
-        // shared lock
-        {
-            boost::shared_lock<boost::shared_mutex> facade_lock(facade_mutex);
+    // Only ever called from the constructor and the watcher thread, so there is no concurrent
+    // writer of facade and current_timestamp
+    void Update()
+    {
+        // declared before the lock: if no query holds the old facade any more, it is destroyed
+        // here and its destructor needs to take the regions lock itself
+        std::shared_ptr<datafacade::BaseDataFacade> old_facade;
 
-            if (shared_timestamp->timestamp == current_timestamp.timestamp)
-            {
-                BOOST_ASSERT(shared_timestamp->layout == current_timestamp.layout);
-                BOOST_ASSERT(shared_timestamp->data == current_timestamp.data);
-                return get_locked_facade();
-            }
-        }
+        const boost::interprocess::sharable_lock<boost::interprocess::named_upgradable_mutex> lock(
+            shared_barriers->current_regions_mutex);
 
-        // if we reach this code there is a data update to be made. multiple
-        // requests can reach this, but only ever one goes through at a time.
-        boost::upgrade_lock<boost::shared_mutex> facade_lock(facade_mutex);
+        const auto shared_timestamp =
+            static_cast<const storage::SharedDataTimestamp *>(shared_regions->Ptr());
 
-        // we might get overtaken before we actually do the writing
-        // in that case we don't modify anthing
         if (shared_timestamp->timestamp == current_timestamp.timestamp)
         {
             BOOST_ASSERT(shared_timestamp->layout == current_timestamp.layout);
             BOOST_ASSERT(shared_timestamp->data == current_timestamp.data);
-
-            return get_locked_facade();
+            return;
         }
 
-        // this thread has won and can update the data
-        boost::upgrade_to_unique_lock<boost::upgrade_mutex> unique_facade_lock(facade_lock);
+        // the new dataset warms up with the pages the current one has used so far
+        SaveHotLeafPages();
 
+        std::shared_ptr<datafacade::BaseDataFacade> new_facade =
+            std::make_shared<datafacade::SharedDataFacade>(shared_barriers,
+                                                           shared_timestamp->layout,
+                                                           shared_timestamp->data,
+                                                           shared_timestamp->timestamp,
+                                                           rtree_warmup,
+                                                           rtree_hot_pages_path);
         current_timestamp = *shared_timestamp;
-        facade = std::make_shared<datafacade::SharedDataFacade>(shared_barriers,
-                                                                current_timestamp.layout,
-                                                                current_timestamp.data,
-                                                                current_timestamp.timestamp);
 
-        return get_locked_facade();
+        // queries that still hold the old facade keep it (and its regions lock) alive
+        old_facade = std::atomic_exchange(&facade, std::move(new_facade));
+    }
+
+    // The hot pages file is only written here, on the watcher thread or once it has stopped, so
+    // the writes never overlap. Facades that are released on query threads do not save.
+    void SaveHotLeafPages() const
+    {
+        if (const auto current_facade = std::atomic_load(&facade))
+        {
+            static_cast<const datafacade::SharedDataFacade &>(*current_facade).SaveHotLeafPages();
+        }
     }
 
-  private:
-    // mutexes should be mutable even on const objects: This enables
-    // marking functions as logical const and thread-safe.
     std::shared_ptr<storage::SharedBarriers> shared_barriers;
 
     // shared memory table containing pointers to all shared regions
     std::unique_ptr<storage::SharedMemory> shared_regions;
 
-    mutable boost::shared_mutex facade_mutex;
-    std::shared_ptr<datafacade::SharedDataFacade> facade;
+    // only accessed through std::atomic_load / std::atomic_store
+    std::shared_ptr<datafacade::BaseDataFacade> facade;
     storage::SharedDataTimestamp current_timestamp;
+
+    const util::RTreeWarmup rtree_warmup;
+    const boost::filesystem::path rtree_hot_pages_path;
+
+    bool active;
+    std::mutex watcher_mutex;
+    std::condition_variable watcher_condition;
+    std::thread watcher;
 };
 }
 }
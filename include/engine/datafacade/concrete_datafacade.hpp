@@ -0,0 +1,36 @@
+#ifndef CONCRETE_DATAFACADE_HPP
+#define CONCRETE_DATAFACADE_HPP
+
+#include "engine/datafacade/datafacade_base.hpp"
+#include "engine/datafacade/internal_datafacade.hpp"
+#include "engine/datafacade/shared_datafacade.hpp"
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+// Calls function with the facade downcast to its most derived type. Both concrete facades are
+// final, so the routing algorithms instantiated for them call the graph accessors directly
+// instead of through the vtable. Unknown facades, e.g. test mocks, are passed through as is.
+template <typename Function>
+auto CallWithConcreteFacade(const BaseDataFacade &facade, Function &&function)
+    -> decltype(function(facade))
+{
+    if (const auto *internal_facade = dynamic_cast<const InternalDataFacade *>(&facade))
+    {
+        return function(*internal_facade);
+    }
+    if (const auto *shared_facade = dynamic_cast<const SharedDataFacade *>(&facade))
+    {
+        return function(*shared_facade);
+    }
+    return function(facade);
+}
+}
+}
+}
+
+#endif // CONCRETE_DATAFACADE_HPP
@@ -9,7 +9,9 @@
 #include "extractor/guidance/turn_instruction.hpp"
 #include "extractor/guidance/turn_lane_types.hpp"
 #include "extractor/original_edge_data.hpp"
+#include "engine/bearing.hpp"
 #include "engine/phantom_node.hpp"
+#include "util/array_view.hpp"
 #include "util/exception.hpp"
 #include "util/guidance/bearing_class.hpp"
 #include "util/guidance/entry_class.hpp"
@@ -21,6 +23,8 @@
 
 #include "osrm/coordinate.hpp"
 
+#include <boost/optional.hpp>
+
 #include <cstddef>
 
 #include <string>
@@ -36,10 +40,14 @@ namespace datafacade
 
 using EdgeRange = util::range<EdgeID>;
 
+// Datasource of every segment if no additional weight data was loaded
+const DatasourceID DEFAULT_DATASOURCE = 0;
+
 class BaseDataFacade
 {
   public:
     using EdgeData = contractor::QueryEdge::EdgeData;
+    using SearchData = contractor::QueryEdge::SearchData;
     using RTreeLeaf = extractor::EdgeBasedNode;
     BaseDataFacade() {}
     virtual ~BaseDataFacade() {}
@@ -53,7 +61,11 @@ class BaseDataFacade
 
     virtual NodeID GetTarget(const EdgeID e) const = 0;
 
-    virtual const EdgeData &GetEdgeData(const EdgeID e) const = 0;
+    // weight and direction of an edge, all that is needed to relax it during the search
+    virtual const SearchData &GetSearchData(const EdgeID e) const = 0;
+
+    // complete data of an edge including the shortcut middle node, needed to unpack it
+    virtual EdgeData GetEdgeData(const EdgeID e) const = 0;
 
     virtual EdgeID BeginEdges(const NodeID n) const = 0;
 
@@ -79,20 +91,25 @@ class BaseDataFacade
 
     virtual GeometryID GetGeometryIndexForEdgeID(const unsigned id) const = 0;
 
-    virtual std::vector<NodeID> GetUncompressedForwardGeometry(const EdgeID id) const = 0;
+    // The geometry accessors return views into the facade's storage that stay valid as long
+    // as the facade itself, reverse views are read back to front without copying.
+    virtual util::ArrayView<NodeID> GetUncompressedForwardGeometry(const EdgeID id) const = 0;
 
-    virtual std::vector<NodeID> GetUncompressedReverseGeometry(const EdgeID id) const = 0;
+    virtual util::ArrayView<NodeID> GetUncompressedReverseGeometry(const EdgeID id) const = 0;
 
     // Gets the weight values for each segment in an uncompressed geometry.
     // Should always be 1 shorter than GetUncompressedGeometry
-    virtual std::vector<EdgeWeight> GetUncompressedForwardWeights(const EdgeID id) const = 0;
+    virtual util::ArrayView<EdgeWeight> GetUncompressedForwardWeights(const EdgeID id) const = 0;
 
-    virtual std::vector<EdgeWeight> GetUncompressedReverseWeights(const EdgeID id) const = 0;
+    virtual util::ArrayView<EdgeWeight> GetUncompressedReverseWeights(const EdgeID id) const = 0;
 
     // Returns the data source ids that were used to supply the edge
-    // weights.  Will return an empty array when only the base profile is used.
-    virtual std::vector<uint8_t> GetUncompressedForwardDatasources(const EdgeID id) const = 0;
-    virtual std::vector<uint8_t> GetUncompressedReverseDatasources(const EdgeID id) const = 0;
+    // weights. Will return DEFAULT_DATASOURCE for every segment when only the base profile
+    // is used.
+    virtual util::ArrayView<DatasourceID>
+    GetUncompressedForwardDatasources(const EdgeID id) const = 0;
+    virtual util::ArrayView<DatasourceID>
+    GetUncompressedReverseDatasources(const EdgeID id) const = 0;
 
     // Gets the name of a datasource
     virtual std::string GetDatasourceName(const uint8_t datasource_name_id) const = 0;
@@ -148,6 +165,17 @@ class BaseDataFacade
                                                       const int bearing,
                                                       const int bearing_range) const = 0;
 
+    // Snaps every coordinate like NearestPhantomNodeWithAlternativeFromBigComponent, the
+    // radiuses and bearings are either empty or given per coordinate. Returns the phantom nodes
+    // in the order of the coordinates. max_parallelism is 1 for sequential, -1 for all
+    // available threads.
+    virtual std::vector<std::pair<PhantomNode, PhantomNode>>
+    NearestPhantomNodesWithAlternativeFromBigComponent(
+        const std::vector<util::Coordinate> &input_coordinates,
+        const std::vector<boost::optional<double>> &radiuses,
+        const std::vector<boost::optional<Bearing>> &bearings,
+        const int max_parallelism) const = 0;
+
     virtual bool hasLaneData(const EdgeID id) const = 0;
     virtual util::guidance::LaneTupleIdPair GetLaneData(const EdgeID id) const = 0;
     virtual extractor::guidance::TurnLaneDescription
@@ -62,7 +62,7 @@ class InternalDataFacade final : public BaseDataFacade
 
   private:
     using super = BaseDataFacade;
-    using QueryGraph = util::StaticGraph<typename super::EdgeData>;
+    using QueryGraph = util::StaticGraph<typename super::SearchData>;
     using InputEdge = QueryGraph::InputEdge;
     using RTreeLeaf = super::RTreeLeaf;
     using InternalRTree =
@@ -73,6 +73,7 @@ class InternalDataFacade final : public BaseDataFacade
 
     unsigned m_check_sum;
     std::unique_ptr<QueryGraph> m_query_graph;
+    util::ShM<contractor::QueryEdge::UnpackData, false>::vector m_edge_unpack_data;
     std::string m_timestamp;
 
     util::ShM<util::Coordinate, false>::vector m_coordinate_list;
@@ -99,6 +100,8 @@ class InternalDataFacade final : public BaseDataFacade
     std::unique_ptr<InternalGeospatialQuery> m_geospatial_query;
     boost::filesystem::path ram_index_path;
     boost::filesystem::path file_index_path;
+    util::RTreeWarmup rtree_warmup = util::RTreeWarmup::None;
+    boost::filesystem::path rtree_hot_pages_path;
     util::RangeTable<16, false> m_name_table;
 
     // bearing classes by node based node
@@ -169,11 +172,13 @@ class InternalDataFacade final : public BaseDataFacade
 
         util::ShM<QueryGraph::NodeArrayEntry, false>::vector node_list(header.number_of_nodes);
         util::ShM<QueryGraph::EdgeArrayEntry, false>::vector edge_list(header.number_of_edges);
+        m_edge_unpack_data.resize(header.number_of_edges);
 
         storage::io::readHSGR(hsgr_input_stream,
                               node_list.data(),
                               header.number_of_nodes,
                               edge_list.data(),
+                              m_edge_unpack_data.data(),
                               header.number_of_edges);
 
         m_query_graph = std::unique_ptr<QueryGraph>(new QueryGraph(node_list, edge_list));
@@ -407,14 +412,23 @@ class InternalDataFacade final : public BaseDataFacade
   public:
     virtual ~InternalDataFacade()
     {
+        // the next start reads the pages that were used by this process
+        if (rtree_warmup == util::RTreeWarmup::HotPages && !rtree_hot_pages_path.empty())
+        {
+            m_static_rtree->SaveHotLeafPages(rtree_hot_pages_path);
+        }
         m_static_rtree.reset();
         m_geospatial_query.reset();
     }
 
-    explicit InternalDataFacade(const storage::StorageConfig &config)
+    explicit InternalDataFacade(const storage::StorageConfig &config,
+                                const util::RTreeWarmup rtree_warmup_ = util::RTreeWarmup::None,
+                                boost::filesystem::path rtree_hot_pages_path_ = {})
     {
         ram_index_path = config.ram_index_path;
         file_index_path = config.file_index_path;
+        rtree_warmup = rtree_warmup_;
+        rtree_hot_pages_path = std::move(rtree_hot_pages_path_);
 
         util::SimpleLogger().Write() << "loading graph data";
         LoadGraph(config.hsgr_data_path);
@@ -445,6 +459,7 @@ class InternalDataFacade final : public BaseDataFacade
 
         util::SimpleLogger().Write() << "loading rtree";
         LoadRTree();
+        m_static_rtree->WarmUpLeaves(rtree_warmup, rtree_hot_pages_path);
 
         util::SimpleLogger().Write() << "loading intersection class data";
         LoadIntersectionClasses(config.intersection_class_path);
@@ -465,11 +480,16 @@ class InternalDataFacade final : public BaseDataFacade
 
     NodeID GetTarget(const EdgeID e) const override final { return m_query_graph->GetTarget(e); }
 
-    EdgeData &GetEdgeData(const EdgeID e) const override final
+    const SearchData &GetSearchData(const EdgeID e) const override final
     {
         return m_query_graph->GetEdgeData(e);
     }
 
+    EdgeData GetEdgeData(const EdgeID e) const override final
+    {
+        return EdgeData(m_query_graph->GetEdgeData(e), m_edge_unpack_data[e]);
+    }
+
     EdgeID BeginEdges(const NodeID n) const override final { return m_query_graph->BeginEdges(n); }
 
     EdgeID EndEdges(const NodeID n) const override final { return m_query_graph->EndEdges(n); }
@@ -500,7 +520,19 @@ class InternalDataFacade final : public BaseDataFacade
                             const NodeID to,
                             std::function<bool(EdgeData)> filter) const override final
     {
-        return m_query_graph->FindSmallestEdge(from, to, filter);
+        EdgeID smallest_edge = SPECIAL_EDGEID;
+        EdgeWeight smallest_weight = INVALID_EDGE_WEIGHT;
+        for (const auto edge : m_query_graph->GetAdjacentEdgeRange(from))
+        {
+            const auto &data = m_query_graph->GetEdgeData(edge);
+            if (m_query_graph->GetTarget(edge) == to && data.weight < smallest_weight &&
+                filter(GetEdgeData(edge)))
+            {
+                smallest_edge = edge;
+                smallest_weight = data.weight;
+            }
+        }
+        return smallest_edge;
     }
 
     // node and edge information access
@@ -640,6 +672,19 @@ class InternalDataFacade final : public BaseDataFacade
             input_coordinate, bearing, bearing_range);
     }
 
+    std::vector<std::pair<PhantomNode, PhantomNode>>
+    NearestPhantomNodesWithAlternativeFromBigComponent(
+        const std::vector<util::Coordinate> &input_coordinates,
+        const std::vector<boost::optional<double>> &radiuses,
+        const std::vector<boost::optional<Bearing>> &bearings,
+        const int max_parallelism) const override final
+    {
+        BOOST_ASSERT(m_geospatial_query.get());
+
+        return m_geospatial_query->NearestPhantomNodesWithAlternativeFromBigComponent(
+            input_coordinates, radiuses, bearings, max_parallelism);
+    }
+
     unsigned GetCheckSum() const override final { return m_check_sum; }
 
     unsigned GetNameIndexFromEdgeID(const unsigned id) const override final
@@ -713,7 +758,8 @@ class InternalDataFacade final : public BaseDataFacade
         }
     }
 
-    virtual std::vector<NodeID> GetUncompressedForwardGeometry(const EdgeID id) const override final
+    virtual util::ArrayView<NodeID>
+    GetUncompressedForwardGeometry(const EdgeID id) const override final
     {
         /*
          * NodeID's for geometries are stored in one place for
@@ -727,18 +773,11 @@ class InternalDataFacade final : public BaseDataFacade
         const unsigned begin = m_geometry_indices.at(id);
         const unsigned end = m_geometry_indices.at(id + 1);
 
-        std::vector<NodeID> result_nodes;
-
-        result_nodes.resize(end - begin);
-
-        std::copy(m_geometry_node_list.begin() + begin,
-                  m_geometry_node_list.begin() + end,
-                  result_nodes.begin());
-
-        return result_nodes;
+        return util::ArrayView<NodeID>::Forward(m_geometry_node_list.data(), begin, end);
     }
 
-    virtual std::vector<NodeID> GetUncompressedReverseGeometry(const EdgeID id) const override final
+    virtual util::ArrayView<NodeID>
+    GetUncompressedReverseGeometry(const EdgeID id) const override final
     {
         /*
          * NodeID's for geometries are stored in one place for
@@ -750,18 +789,10 @@ class InternalDataFacade final : public BaseDataFacade
         const unsigned begin = m_geometry_indices.at(id);
         const unsigned end = m_geometry_indices.at(id + 1);
 
-        std::vector<NodeID> result_nodes;
-
-        result_nodes.resize(end - begin);
-
-        std::copy(m_geometry_node_list.rbegin() + (m_geometry_node_list.size() - end),
-                  m_geometry_node_list.rbegin() + (m_geometry_node_list.size() - begin),
-                  result_nodes.begin());
-
-        return result_nodes;
+        return util::ArrayView<NodeID>::Reverse(m_geometry_node_list.data(), begin, end);
     }
 
-    virtual std::vector<EdgeWeight>
+    virtual util::ArrayView<EdgeWeight>
     GetUncompressedForwardWeights(const EdgeID id) const override final
     {
         /*
@@ -774,17 +805,10 @@ class InternalDataFacade final : public BaseDataFacade
         const unsigned begin = m_geometry_indices.at(id) + 1;
         const unsigned end = m_geometry_indices.at(id + 1);
 
-        std::vector<EdgeWeight> result_weights;
-        result_weights.resize(end - begin);
-
-        std::copy(m_geometry_fwd_weight_list.begin() + begin,
-                  m_geometry_fwd_weight_list.begin() + end,
-                  result_weights.begin());
-
-        return result_weights;
+        return util::ArrayView<EdgeWeight>::Forward(m_geometry_fwd_weight_list.data(), begin, end);
     }
 
-    virtual std::vector<EdgeWeight>
+    virtual util::ArrayView<EdgeWeight>
     GetUncompressedReverseWeights(const EdgeID id) const override final
     {
         /*
@@ -799,19 +823,12 @@ class InternalDataFacade final : public BaseDataFacade
         const unsigned begin = m_geometry_indices.at(id);
         const unsigned end = m_geometry_indices.at(id + 1) - 1;
 
-        std::vector<EdgeWeight> result_weights;
-        result_weights.resize(end - begin);
-
-        std::copy(m_geometry_rev_weight_list.rbegin() + (m_geometry_rev_weight_list.size() - end),
-                  m_geometry_rev_weight_list.rbegin() + (m_geometry_rev_weight_list.size() - begin),
-                  result_weights.begin());
-
-        return result_weights;
+        return util::ArrayView<EdgeWeight>::Reverse(m_geometry_rev_weight_list.data(), begin, end);
     }
 
     // Returns the data source ids that were used to supply the edge
     // weights.
-    virtual std::vector<uint8_t>
+    virtual util::ArrayView<DatasourceID>
     GetUncompressedForwardDatasources(const EdgeID id) const override final
     {
         /*
@@ -826,30 +843,18 @@ class InternalDataFacade final : public BaseDataFacade
         const unsigned begin = m_geometry_indices.at(id) + 1;
         const unsigned end = m_geometry_indices.at(id + 1);
 
-        std::vector<uint8_t> result_datasources;
-        result_datasources.resize(end - begin);
-
         // If there was no datasource info, return an array of 0's.
         if (m_datasource_list.empty())
         {
-            for (unsigned i = 0; i < end - begin; ++i)
-            {
-                result_datasources.push_back(0);
-            }
-        }
-        else
-        {
-            std::copy(m_datasource_list.begin() + begin,
-                      m_datasource_list.begin() + end,
-                      result_datasources.begin());
+            return util::ArrayView<DatasourceID>::Repeat(DEFAULT_DATASOURCE, end - begin);
         }
 
-        return result_datasources;
+        return util::ArrayView<DatasourceID>::Forward(m_datasource_list.data(), begin, end);
     }
 
     // Returns the data source ids that were used to supply the edge
     // weights.
-    virtual std::vector<uint8_t>
+    virtual util::ArrayView<DatasourceID>
     GetUncompressedReverseDatasources(const EdgeID id) const override final
     {
         /*
@@ -864,25 +869,13 @@ class InternalDataFacade final : public BaseDataFacade
         const unsigned begin = m_geometry_indices.at(id);
         const unsigned end = m_geometry_indices.at(id + 1) - 1;
 
-        std::vector<uint8_t> result_datasources;
-        result_datasources.resize(end - begin);
-
         // If there was no datasource info, return an array of 0's.
         if (m_datasource_list.empty())
         {
-            for (unsigned i = 0; i < end - begin; ++i)
-            {
-                result_datasources.push_back(0);
-            }
-        }
-        else
-        {
-            std::copy(m_datasource_list.rbegin() + (m_datasource_list.size() - end),
-                      m_datasource_list.rbegin() + (m_datasource_list.size() - begin),
-                      result_datasources.begin());
+            return util::ArrayView<DatasourceID>::Repeat(DEFAULT_DATASOURCE, end - begin);
         }
 
-        return result_datasources;
+        return util::ArrayView<DatasourceID>::Reverse(m_datasource_list.data(), begin, end);
     }
 
     virtual std::string GetDatasourceName(const uint8_t datasource_name_id) const override final
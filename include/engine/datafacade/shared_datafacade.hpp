@@ -52,9 +52,10 @@ class SharedDataFacade final : public BaseDataFacade
 
   private:
     using super = BaseDataFacade;
-    using QueryGraph = util::StaticGraph<EdgeData, true>;
+    using QueryGraph = util::StaticGraph<SearchData, true>;
     using GraphNode = QueryGraph::NodeArrayEntry;
     using GraphEdge = QueryGraph::EdgeArrayEntry;
+    using GraphEdgeUnpack = contractor::QueryEdge::UnpackData;
     using IndexBlock = util::RangeTable<16, true>::BlockT;
     using InputEdge = QueryGraph::InputEdge;
     using RTreeLeaf = super::RTreeLeaf;
@@ -70,9 +71,13 @@ class SharedDataFacade final : public BaseDataFacade
     storage::SharedDataType layout_region;
     storage::SharedDataType data_region;
     unsigned shared_timestamp;
+    // held for the whole lifetime of the facade, osrm-datastore can only replace the regions
+    // once the last query using this facade has finished
+    boost::interprocess::sharable_lock<boost::interprocess::named_sharable_mutex> regions_lock;
 
     unsigned m_check_sum;
     std::unique_ptr<QueryGraph> m_query_graph;
+    util::ShM<GraphEdgeUnpack, true>::vector m_edge_unpack_data;
     std::unique_ptr<storage::SharedMemory> m_layout_memory;
     std::unique_ptr<storage::SharedMemory> m_large_memory;
     std::string m_timestamp;
@@ -106,6 +111,8 @@ class SharedDataFacade final : public BaseDataFacade
     std::unique_ptr<SharedRTree> m_static_rtree;
     std::unique_ptr<SharedGeospatialQuery> m_geospatial_query;
     boost::filesystem::path file_index_path;
+    util::RTreeWarmup rtree_warmup;
+    boost::filesystem::path rtree_hot_pages_path;
 
     std::shared_ptr<util::RangeTable<16, true>> m_name_table;
     // bearing classes by node based node
@@ -151,20 +158,39 @@ class SharedDataFacade final : public BaseDataFacade
         const auto file_index_ptr = data_layout->GetBlockPtr<char>(
             shared_memory, storage::SharedDataLayout::FILE_INDEX_PATH);
         file_index_path = boost::filesystem::path(file_index_ptr);
-        if (!boost::filesystem::exists(file_index_path))
-        {
-            util::SimpleLogger().Write(logDEBUG) << "Leaf file name " << file_index_path.string();
-            throw util::exception("Could not load " + file_index_path.string() +
-                                  "Is any data loaded into shared memory?");
-        }
 
         auto tree_ptr = data_layout->GetBlockPtr<RTreeNode>(
             shared_memory, storage::SharedDataLayout::R_SEARCH_TREE);
-        m_static_rtree.reset(
-            new SharedRTree(tree_ptr,
-                            data_layout->num_entries[storage::SharedDataLayout::R_SEARCH_TREE],
-                            file_index_path,
-                            m_coordinate_list));
+        const auto number_of_nodes =
+            data_layout->num_entries[storage::SharedDataLayout::R_SEARCH_TREE];
+
+        // osrm-datastore --load-rtree-leaves stored the leaves in shared memory
+        const auto leaves_block_size =
+            data_layout->num_entries[storage::SharedDataLayout::R_SEARCH_LEAVES];
+        if (leaves_block_size > 0)
+        {
+            auto leaves_ptr = data_layout->GetAlignedBlockPtr<SharedRTree::LeafNode>(
+                shared_memory, storage::SharedDataLayout::R_SEARCH_LEAVES);
+            const auto number_of_leaves =
+                (leaves_block_size - (alignof(SharedRTree::LeafNode) - 1)) /
+                sizeof(SharedRTree::LeafNode);
+            m_static_rtree.reset(new SharedRTree(
+                tree_ptr, number_of_nodes, leaves_ptr, number_of_leaves, m_coordinate_list));
+        }
+        else
+        {
+            if (!boost::filesystem::exists(file_index_path))
+            {
+                util::SimpleLogger().Write(logDEBUG) << "Leaf file name "
+                                                     << file_index_path.string();
+                throw util::exception("Could not load " + file_index_path.string() +
+                                      "Is any data loaded into shared memory?");
+            }
+
+            m_static_rtree.reset(
+                new SharedRTree(tree_ptr, number_of_nodes, file_index_path, m_coordinate_list));
+            m_static_rtree->WarmUpLeaves(rtree_warmup, rtree_hot_pages_path);
+        }
         m_geospatial_query.reset(
             new SharedGeospatialQuery(*m_static_rtree, m_coordinate_list, *this));
     }
@@ -182,6 +208,12 @@ class SharedDataFacade final : public BaseDataFacade
         util::ShM<GraphEdge, true>::vector edge_list(
             graph_edges_ptr, data_layout->num_entries[storage::SharedDataLayout::GRAPH_EDGE_LIST]);
         m_query_graph.reset(new QueryGraph(node_list, edge_list));
+
+        auto graph_edge_unpack_ptr = data_layout->GetBlockPtr<GraphEdgeUnpack>(
+            shared_memory, storage::SharedDataLayout::GRAPH_EDGE_UNPACK_LIST);
+        m_edge_unpack_data.reset(
+            graph_edge_unpack_ptr,
+            data_layout->num_entries[storage::SharedDataLayout::GRAPH_EDGE_UNPACK_LIST]);
     }
 
     void LoadNodeAndEdgeInformation()
@@ -417,6 +449,8 @@ class SharedDataFacade final : public BaseDataFacade
     // used anymore
     virtual ~SharedDataFacade()
     {
+        regions_lock.unlock();
+
         boost::interprocess::scoped_lock<boost::interprocess::named_sharable_mutex> exclusive_lock(
             data_region == storage::DATA_1 ? shared_barriers->regions_1_mutex
                                            : shared_barriers->regions_2_mutex,
@@ -449,9 +483,14 @@ class SharedDataFacade final : public BaseDataFacade
     SharedDataFacade(const std::shared_ptr<storage::SharedBarriers> &shared_barriers_,
                      storage::SharedDataType layout_region_,
                      storage::SharedDataType data_region_,
-                     unsigned shared_timestamp_)
+                     unsigned shared_timestamp_,
+                     const util::RTreeWarmup rtree_warmup_ = util::RTreeWarmup::None,
+                     boost::filesystem::path rtree_hot_pages_path_ = {})
         : shared_barriers(shared_barriers_), layout_region(layout_region_),
-          data_region(data_region_), shared_timestamp(shared_timestamp_)
+          data_region(data_region_), shared_timestamp(shared_timestamp_),
+          regions_lock(data_region == storage::DATA_1 ? shared_barriers->regions_1_mutex
+                                                      : shared_barriers->regions_2_mutex),
+          rtree_warmup(rtree_warmup_), rtree_hot_pages_path(std::move(rtree_hot_pages_path_))
     {
         util::SimpleLogger().Write(logDEBUG) << "Loading new data with shared timestamp "
                                              << shared_timestamp;
@@ -479,6 +518,16 @@ class SharedDataFacade final : public BaseDataFacade
         LoadIntersectionClasses();
     }
 
+    // Saves the pages of the R-tree leaves that are in memory, the next dataset reads them
+    // during its warm-up. Not thread safe, DataWatchdog is the only caller.
+    void SaveHotLeafPages() const
+    {
+        if (rtree_warmup == util::RTreeWarmup::HotPages && !rtree_hot_pages_path.empty())
+        {
+            m_static_rtree->SaveHotLeafPages(rtree_hot_pages_path);
+        }
+    }
+
     // search graph access
     unsigned GetNumberOfNodes() const override final { return m_query_graph->GetNumberOfNodes(); }
 
@@ -491,11 +540,16 @@ class SharedDataFacade final : public BaseDataFacade
 
     NodeID GetTarget(const EdgeID e) const override final { return m_query_graph->GetTarget(e); }
 
-    EdgeData &GetEdgeData(const EdgeID e) const override final
+    const SearchData &GetSearchData(const EdgeID e) const override final
     {
         return m_query_graph->GetEdgeData(e);
     }
 
+    EdgeData GetEdgeData(const EdgeID e) const override final
+    {
+        return EdgeData(m_query_graph->GetEdgeData(e), m_edge_unpack_data[e]);
+    }
+
     EdgeID BeginEdges(const NodeID n) const override final { return m_query_graph->BeginEdges(n); }
 
     EdgeID EndEdges(const NodeID n) const override final { return m_query_graph->EndEdges(n); }
@@ -526,7 +580,19 @@ class SharedDataFacade final : public BaseDataFacade
                             const NodeID to,
                             std::function<bool(EdgeData)> filter) const override final
     {
-        return m_query_graph->FindSmallestEdge(from, to, filter);
+        EdgeID smallest_edge = SPECIAL_EDGEID;
+        EdgeWeight smallest_weight = INVALID_EDGE_WEIGHT;
+        for (const auto edge : m_query_graph->GetAdjacentEdgeRange(from))
+        {
+            const auto &data = m_query_graph->GetEdgeData(edge);
+            if (m_query_graph->GetTarget(edge) == to && data.weight < smallest_weight &&
+                filter(GetEdgeData(edge)))
+            {
+                smallest_edge = edge;
+                smallest_weight = data.weight;
+            }
+        }
+        return smallest_edge;
     }
 
     // node and edge information access
@@ -540,7 +606,8 @@ class SharedDataFacade final : public BaseDataFacade
         return m_osmnodeid_list.at(id);
     }
 
-    virtual std::vector<NodeID> GetUncompressedForwardGeometry(const EdgeID id) const override final
+    virtual util::ArrayView<NodeID>
+    GetUncompressedForwardGeometry(const EdgeID id) const override final
     {
         /*
          * NodeID's for geometries are stored in one place for
@@ -554,18 +621,11 @@ class SharedDataFacade final : public BaseDataFacade
         const unsigned begin = m_geometry_indices.at(id);
         const unsigned end = m_geometry_indices.at(id + 1);
 
-        std::vector<NodeID> result_nodes;
-
-        result_nodes.resize(end - begin);
-
-        std::copy(m_geometry_node_list.begin() + begin,
-                  m_geometry_node_list.begin() + end,
-                  result_nodes.begin());
-
-        return result_nodes;
+        return util::ArrayView<NodeID>::Forward(m_geometry_node_list.data(), begin, end);
     }
 
-    virtual std::vector<NodeID> GetUncompressedReverseGeometry(const EdgeID id) const override final
+    virtual util::ArrayView<NodeID>
+    GetUncompressedReverseGeometry(const EdgeID id) const override final
     {
         /*
          * NodeID's for geometries are stored in one place for
@@ -577,18 +637,10 @@ class SharedDataFacade final : public BaseDataFacade
         const unsigned begin = m_geometry_indices.at(id);
         const unsigned end = m_geometry_indices.at(id + 1);
 
-        std::vector<NodeID> result_nodes;
-
-        result_nodes.resize(end - begin);
-
-        std::copy(m_geometry_node_list.rbegin() + (m_geometry_node_list.size() - end),
-                  m_geometry_node_list.rbegin() + (m_geometry_node_list.size() - begin),
-                  result_nodes.begin());
-
-        return result_nodes;
+        return util::ArrayView<NodeID>::Reverse(m_geometry_node_list.data(), begin, end);
     }
 
-    virtual std::vector<EdgeWeight>
+    virtual util::ArrayView<EdgeWeight>
     GetUncompressedForwardWeights(const EdgeID id) const override final
     {
         /*
@@ -601,17 +653,10 @@ class SharedDataFacade final : public BaseDataFacade
         const unsigned begin = m_geometry_indices.at(id) + 1;
         const unsigned end = m_geometry_indices.at(id + 1);
 
-        std::vector<EdgeWeight> result_weights;
-        result_weights.resize(end - begin);
-
-        std::copy(m_geometry_fwd_weight_list.begin() + begin,
-                  m_geometry_fwd_weight_list.begin() + end,
-                  result_weights.begin());
-
-        return result_weights;
+        return util::ArrayView<EdgeWeight>::Forward(m_geometry_fwd_weight_list.data(), begin, end);
     }
 
-    virtual std::vector<EdgeWeight>
+    virtual util::ArrayView<EdgeWeight>
     GetUncompressedReverseWeights(const EdgeID id) const override final
     {
         /*
@@ -626,14 +671,7 @@ class SharedDataFacade final : public BaseDataFacade
         const unsigned begin = m_geometry_indices.at(id);
         const unsigned end = m_geometry_indices.at(id + 1) - 1;
 
-        std::vector<EdgeWeight> result_weights;
-        result_weights.resize(end - begin);
-
-        std::copy(m_geometry_rev_weight_list.rbegin() + (m_geometry_rev_weight_list.size() - end),
-                  m_geometry_rev_weight_list.rbegin() + (m_geometry_rev_weight_list.size() - begin),
-                  result_weights.begin());
-
-        return result_weights;
+        return util::ArrayView<EdgeWeight>::Reverse(m_geometry_rev_weight_list.data(), begin, end);
     }
 
     virtual GeometryID GetGeometryIndexForEdgeID(const unsigned id) const override final
@@ -767,6 +805,19 @@ class SharedDataFacade final : public BaseDataFacade
             input_coordinate, bearing, bearing_range);
     }
 
+    std::vector<std::pair<PhantomNode, PhantomNode>>
+    NearestPhantomNodesWithAlternativeFromBigComponent(
+        const std::vector<util::Coordinate> &input_coordinates,
+        const std::vector<boost::optional<double>> &radiuses,
+        const std::vector<boost::optional<Bearing>> &bearings,
+        const int max_parallelism) const override final
+    {
+        BOOST_ASSERT(m_geospatial_query.get());
+
+        return m_geospatial_query->NearestPhantomNodesWithAlternativeFromBigComponent(
+            input_coordinates, radiuses, bearings, max_parallelism);
+    }
+
     unsigned GetCheckSum() const override final { return m_check_sum; }
 
     unsigned GetNameIndexFromEdgeID(const unsigned id) const override final
@@ -835,7 +886,7 @@ class SharedDataFacade final : public BaseDataFacade
 
     // Returns the data source ids that were used to supply the edge
     // weights.
-    virtual std::vector<uint8_t>
+    virtual util::ArrayView<DatasourceID>
     GetUncompressedForwardDatasources(const EdgeID id) const override final
     {
         /*
@@ -850,30 +901,18 @@ class SharedDataFacade final : public BaseDataFacade
         const unsigned begin = m_geometry_indices.at(id) + 1;
         const unsigned end = m_geometry_indices.at(id + 1);
 
-        std::vector<uint8_t> result_datasources;
-        result_datasources.resize(end - begin);
-
         // If there was no datasource info, return an array of 0's.
         if (m_datasource_list.empty())
         {
-            for (unsigned i = 0; i < end - begin; ++i)
-            {
-                result_datasources.push_back(0);
-            }
-        }
-        else
-        {
-            std::copy(m_datasource_list.begin() + begin,
-                      m_datasource_list.begin() + end,
-                      result_datasources.begin());
+            return util::ArrayView<DatasourceID>::Repeat(DEFAULT_DATASOURCE, end - begin);
         }
 
-        return result_datasources;
+        return util::ArrayView<DatasourceID>::Forward(m_datasource_list.data(), begin, end);
     }
 
     // Returns the data source ids that were used to supply the edge
     // weights.
-    virtual std::vector<uint8_t>
+    virtual util::ArrayView<DatasourceID>
     GetUncompressedReverseDatasources(const EdgeID id) const override final
     {
         /*
@@ -888,25 +927,13 @@ class SharedDataFacade final : public BaseDataFacade
         const unsigned begin = m_geometry_indices.at(id);
         const unsigned end = m_geometry_indices.at(id + 1) - 1;
 
-        std::vector<uint8_t> result_datasources;
-        result_datasources.resize(end - begin);
-
         // If there was no datasource info, return an array of 0's.
         if (m_datasource_list.empty())
         {
-            for (unsigned i = 0; i < end - begin; ++i)
-            {
-                result_datasources.push_back(0);
-            }
-        }
-        else
-        {
-            std::copy(m_datasource_list.rbegin() + (m_datasource_list.size() - end),
-                      m_datasource_list.rbegin() + (m_datasource_list.size() - begin),
-                      result_datasources.begin());
+            return util::ArrayView<DatasourceID>::Repeat(DEFAULT_DATASOURCE, end - begin);
         }
 
-        return result_datasources;
+        return util::ArrayView<DatasourceID>::Reverse(m_datasource_list.data(), begin, end);
     }
 
     virtual std::string GetDatasourceName(const uint8_t datasource_name_id) const override final
@@ -81,7 +81,7 @@ inline void UnpackCHPath(const DataFacadeT &facade,
         // called this function with bad values.
         BOOST_ASSERT_MSG(smaller_edge_id != SPECIAL_EDGEID, "Invalid smaller edge ID");
 
-        const auto &data = facade.GetEdgeData(smaller_edge_id);
+        const auto data = facade.GetEdgeData(smaller_edge_id);
         BOOST_ASSERT_MSG(data.weight != std::numeric_limits<EdgeWeight>::max(),
                          "edge weight invalid");
 
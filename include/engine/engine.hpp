@@ -18,11 +18,14 @@
 #include "engine/plugins/trip.hpp"
 #include "engine/plugins/viaroute.hpp"
 #include "engine/status.hpp"
+#include "util/binary_writer.hpp"
 #include "util/json_container.hpp"
+#include "util/json_writer.hpp"
 
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -41,10 +44,15 @@ class Engine final
     Engine &operator=(const Engine &) = delete;
 
     Status Route(const api::RouteParameters &parameters, util::json::Object &result) const;
+    Status Route(const api::RouteParameters &parameters, util::binary::Writer &result) const;
     Status Table(const api::TableParameters &parameters, util::json::Object &result) const;
+    Status Table(const api::TableParameters &parameters, util::json::Writer &result) const;
+    Status Table(const api::TableParameters &parameters, util::binary::Writer &result) const;
     Status Nearest(const api::NearestParameters &parameters, util::json::Object &result) const;
     Status Trip(const api::TripParameters &parameters, util::json::Object &result) const;
     Status Match(const api::MatchParameters &parameters, util::json::Object &result) const;
+    Status Match(const std::vector<api::MatchParameters> &parameters,
+                 std::vector<util::json::Object> &results) const;
     Status Tile(const api::TileParameters &parameters, std::string &result) const;
 
   private:
@@ -29,6 +29,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define ENGINE_CONFIG_HPP
 
 #include "storage/storage_config.hpp"
+#include "util/rtree_warmup.hpp"
 
 #include <boost/filesystem/path.hpp>
 
@@ -53,6 +54,17 @@ namespace engine
  *  - Match
  *  - Nearest
  *
+ * The number of threads a single Table request may use is capped by
+ * max_parallelism_distance_table (1 for sequential, -1 for all available threads).
+ *
+ * Search heaps use a dense per-thread index for graphs with up to max_dense_heap_nodes nodes
+ * (-1 for unlimited, 0 to always use a hash map). An index takes 8 bytes per node and every
+ * query thread keeps up to six of them.
+ *
+ * The memory mapped leaves of the R-tree are loaded as configured by rtree_warmup before the
+ * first query. RTreeWarmup::HotPages reads the pages listed in rtree_hot_pages_path, which is
+ * rewritten whenever a dataset is unloaded.
+ *
  * In addition, shared memory can be used for datasets loaded with osrm-datastore.
  *
  * \see OSRM, StorageConfig
@@ -67,7 +79,11 @@ struct EngineConfig final
     int max_locations_distance_table = -1;
     int max_locations_map_matching = -1;
     int max_results_nearest = -1;
+    int max_parallelism_distance_table = 1;
+    int max_dense_heap_nodes = 1 << 22;
     bool use_shared_memory = true;
+    util::RTreeWarmup rtree_warmup = util::RTreeWarmup::None;
+    boost::filesystem::path rtree_hot_pages_path;
 };
 }
 }
@@ -1,18 +1,29 @@
 #ifndef GEOSPATIAL_QUERY_HPP
 #define GEOSPATIAL_QUERY_HPP
 
+#include "engine/bearing.hpp"
 #include "engine/phantom_node.hpp"
 #include "util/bearing.hpp"
 #include "util/coordinate_calculation.hpp"
+#include "util/hilbert_value.hpp"
+#include "util/integer_range.hpp"
 #include "util/rectangle.hpp"
 #include "util/typedefs.hpp"
 #include "util/web_mercator.hpp"
 
 #include "osrm/coordinate.hpp"
 
+#include <boost/optional.hpp>
+#include <boost/thread/tss.hpp>
+
+#include <tbb/parallel_for.h>
+#include <tbb/task_scheduler_init.h>
+
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -52,15 +63,17 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     NearestPhantomNodesInRange(const util::Coordinate input_coordinate,
                                const double max_distance) const
     {
-        auto results =
-            rtree.Nearest(input_coordinate,
-                          [this](const CandidateSegment &segment) { return HasValidEdge(segment); },
-                          [this, max_distance, input_coordinate](const std::size_t,
-                                                                 const CandidateSegment &segment) {
-                              return CheckSegmentDistance(input_coordinate, segment, max_distance);
-                          });
-
-        return MakePhantomNodes(input_coordinate, results);
+        auto &nearest_data = GetNearestData();
+        rtree.Nearest(input_coordinate,
+                      [this](const CandidateSegment &segment) { return HasValidEdge(segment); },
+                      [this, max_distance, input_coordinate](const std::size_t,
+                                                             const CandidateSegment &segment) {
+                          return CheckSegmentDistance(input_coordinate, segment, max_distance);
+                      },
+                      nearest_data.queue,
+                      nearest_data.results);
+
+        return MakePhantomNodes(input_coordinate, nearest_data.results);
     }
 
     // Returns nearest PhantomNodes in the given bearing range within max_distance.
@@ -71,7 +84,8 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                                const int bearing,
                                const int bearing_range) const
     {
-        auto results = rtree.Nearest(
+        auto &nearest_data = GetNearestData();
+        rtree.Nearest(
             input_coordinate,
             [this, bearing, bearing_range, max_distance](const CandidateSegment &segment) {
                 return boolPairAnd(CheckSegmentBearing(segment, bearing, bearing_range),
@@ -80,9 +94,11 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
             [this, max_distance, input_coordinate](const std::size_t,
                                                    const CandidateSegment &segment) {
                 return CheckSegmentDistance(input_coordinate, segment, max_distance);
-            });
+            },
+            nearest_data.queue,
+            nearest_data.results);
 
-        return MakePhantomNodes(input_coordinate, results);
+        return MakePhantomNodes(input_coordinate, nearest_data.results);
     }
 
     // Returns max_results nearest PhantomNodes in the given bearing range.
@@ -93,17 +109,19 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                         const int bearing,
                         const int bearing_range) const
     {
-        auto results = rtree.Nearest(
+        auto &nearest_data = GetNearestData();
+        rtree.Nearest(
             input_coordinate,
             [this, bearing, bearing_range](const CandidateSegment &segment) {
                 return boolPairAnd(CheckSegmentBearing(segment, bearing, bearing_range),
                                    HasValidEdge(segment));
             },
-            [max_results](const std::size_t num_results, const CandidateSegment &) {
-                return num_results >= max_results;
-            });
+            [](const std::size_t, const CandidateSegment &) { return false; },
+            max_results,
+            nearest_data.queue,
+            nearest_data.results);
 
-        return MakePhantomNodes(input_coordinate, results);
+        return MakePhantomNodes(input_coordinate, nearest_data.results);
     }
 
     // Returns max_results nearest PhantomNodes in the given bearing range within the maximum
@@ -116,19 +134,22 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                         const int bearing,
                         const int bearing_range) const
     {
-        auto results = rtree.Nearest(
+        auto &nearest_data = GetNearestData();
+        rtree.Nearest(
             input_coordinate,
             [this, bearing, bearing_range](const CandidateSegment &segment) {
                 return boolPairAnd(CheckSegmentBearing(segment, bearing, bearing_range),
                                    HasValidEdge(segment));
             },
-            [this, max_distance, max_results, input_coordinate](const std::size_t num_results,
-                                                                const CandidateSegment &segment) {
-                return num_results >= max_results ||
-                       CheckSegmentDistance(input_coordinate, segment, max_distance);
-            });
+            [this, max_distance, input_coordinate](const std::size_t,
+                                                   const CandidateSegment &segment) {
+                return CheckSegmentDistance(input_coordinate, segment, max_distance);
+            },
+            max_results,
+            nearest_data.queue,
+            nearest_data.results);
 
-        return MakePhantomNodes(input_coordinate, results);
+        return MakePhantomNodes(input_coordinate, nearest_data.results);
     }
 
     // Returns max_results nearest PhantomNodes.
@@ -136,14 +157,15 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     std::vector<PhantomNodeWithDistance>
     NearestPhantomNodes(const util::Coordinate input_coordinate, const unsigned max_results) const
     {
-        auto results =
-            rtree.Nearest(input_coordinate,
-                          [this](const CandidateSegment &segment) { return HasValidEdge(segment); },
-                          [max_results](const std::size_t num_results, const CandidateSegment &) {
-                              return num_results >= max_results;
-                          });
-
-        return MakePhantomNodes(input_coordinate, results);
+        auto &nearest_data = GetNearestData();
+        rtree.Nearest(input_coordinate,
+                      [this](const CandidateSegment &segment) { return HasValidEdge(segment); },
+                      [](const std::size_t, const CandidateSegment &) { return false; },
+                      max_results,
+                      nearest_data.queue,
+                      nearest_data.results);
+
+        return MakePhantomNodes(input_coordinate, nearest_data.results);
     }
 
     // Returns max_results nearest PhantomNodes in the given max distance.
@@ -153,16 +175,18 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                         const unsigned max_results,
                         const double max_distance) const
     {
-        auto results =
-            rtree.Nearest(input_coordinate,
-                          [this](const CandidateSegment &segment) { return HasValidEdge(segment); },
-                          [this, max_distance, max_results, input_coordinate](
-                              const std::size_t num_results, const CandidateSegment &segment) {
-                              return num_results >= max_results ||
-                                     CheckSegmentDistance(input_coordinate, segment, max_distance);
-                          });
-
-        return MakePhantomNodes(input_coordinate, results);
+        auto &nearest_data = GetNearestData();
+        rtree.Nearest(input_coordinate,
+                      [this](const CandidateSegment &segment) { return HasValidEdge(segment); },
+                      [this, max_distance, input_coordinate](const std::size_t,
+                                                             const CandidateSegment &segment) {
+                          return CheckSegmentDistance(input_coordinate, segment, max_distance);
+                      },
+                      max_results,
+                      nearest_data.queue,
+                      nearest_data.results);
+
+        return MakePhantomNodes(input_coordinate, nearest_data.results);
     }
 
     // Returns the nearest phantom node. If this phantom node is not from a big component
@@ -173,7 +197,8 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     {
         bool has_small_component = false;
         bool has_big_component = false;
-        auto results = rtree.Nearest(
+        auto &nearest_data = GetNearestData();
+        rtree.Nearest(
             input_coordinate,
             [this, &has_big_component, &has_small_component](const CandidateSegment &segment) {
                 auto use_segment = (!has_small_component ||
@@ -193,7 +218,10 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                 const std::size_t num_results, const CandidateSegment &segment) {
                 return (num_results > 0 && has_big_component) ||
                        CheckSegmentDistance(input_coordinate, segment, max_distance);
-            });
+            },
+            nearest_data.queue,
+            nearest_data.results);
+        const auto &results = nearest_data.results;
 
         if (results.size() == 0)
         {
@@ -212,7 +240,8 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     {
         bool has_small_component = false;
         bool has_big_component = false;
-        auto results = rtree.Nearest(
+        auto &nearest_data = GetNearestData();
+        rtree.Nearest(
             input_coordinate,
             [this, &has_big_component, &has_small_component](const CandidateSegment &segment) {
                 auto use_segment = (!has_small_component ||
@@ -234,7 +263,10 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
             },
             [&has_big_component](const std::size_t num_results, const CandidateSegment &) {
                 return num_results > 0 && has_big_component;
-            });
+            },
+            nearest_data.queue,
+            nearest_data.results);
+        const auto &results = nearest_data.results;
 
         if (results.size() == 0)
         {
@@ -253,7 +285,8 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     {
         bool has_small_component = false;
         bool has_big_component = false;
-        auto results = rtree.Nearest(
+        auto &nearest_data = GetNearestData();
+        rtree.Nearest(
             input_coordinate,
             [this, bearing, bearing_range, &has_big_component, &has_small_component](
                 const CandidateSegment &segment) {
@@ -278,7 +311,10 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
             },
             [&has_big_component](const std::size_t num_results, const CandidateSegment &) {
                 return num_results > 0 && has_big_component;
-            });
+            },
+            nearest_data.queue,
+            nearest_data.results);
+        const auto &results = nearest_data.results;
 
         if (results.size() == 0)
         {
@@ -300,7 +336,8 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     {
         bool has_small_component = false;
         bool has_big_component = false;
-        auto results = rtree.Nearest(
+        auto &nearest_data = GetNearestData();
+        rtree.Nearest(
             input_coordinate,
             [this, bearing, bearing_range, &has_big_component, &has_small_component](
                 const CandidateSegment &segment) {
@@ -327,7 +364,10 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                 const std::size_t num_results, const CandidateSegment &segment) {
                 return (num_results > 0 && has_big_component) ||
                        CheckSegmentDistance(input_coordinate, segment, max_distance);
-            });
+            },
+            nearest_data.queue,
+            nearest_data.results);
+        const auto &results = nearest_data.results;
 
         if (results.size() == 0)
         {
@@ -339,7 +379,108 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                               MakePhantomNode(input_coordinate, results.back()).phantom_node);
     }
 
+    // Snaps every coordinate like NearestPhantomNodeWithAlternativeFromBigComponent and returns
+    // the phantom nodes in input order. The coordinates are snapped in the order of their
+    // Hilbert values, so consecutive searches descend through the same tree nodes and leaves.
+    // Contiguous ranges of that order are snapped on up to max_parallelism threads. Fewer
+    // coordinates than a chunk are snapped in input order, sorting them does not pay off.
+    std::vector<std::pair<PhantomNode, PhantomNode>>
+    NearestPhantomNodesWithAlternativeFromBigComponent(
+        const std::vector<util::Coordinate> &input_coordinates,
+        const std::vector<boost::optional<double>> &radiuses,
+        const std::vector<boost::optional<Bearing>> &bearings,
+        const int max_parallelism) const
+    {
+        BOOST_ASSERT(radiuses.empty() || radiuses.size() == input_coordinates.size());
+        BOOST_ASSERT(bearings.empty() || bearings.size() == input_coordinates.size());
+
+        std::vector<std::pair<std::uint64_t, std::size_t>> hilbert_order;
+        if (input_coordinates.size() >= MIN_SNAPPINGS_PER_CHUNK)
+        {
+            hilbert_order.reserve(input_coordinates.size());
+            for (const auto index : util::irange<std::size_t>(0, input_coordinates.size()))
+            {
+                hilbert_order.emplace_back(util::hilbertCode(input_coordinates[index]), index);
+            }
+            std::sort(hilbert_order.begin(), hilbert_order.end());
+        }
+
+        std::vector<std::pair<PhantomNode, PhantomNode>> phantom_node_pairs(
+            input_coordinates.size());
+        const auto snap = [&](const std::size_t begin, const std::size_t end) {
+            for (const auto position : util::irange(begin, end))
+            {
+                const auto index =
+                    hilbert_order.empty() ? position : hilbert_order[position].second;
+                phantom_node_pairs[index] = NearestPhantomNodeWithAlternativeFromBigComponent(
+                    input_coordinates[index],
+                    radiuses.empty() ? boost::none : radiuses[index],
+                    bearings.empty() ? boost::none : bearings[index]);
+            }
+        };
+
+        const std::size_t max_chunks =
+            max_parallelism < 0 ? tbb::task_scheduler_init::default_num_threads()
+                                : static_cast<std::size_t>(max_parallelism);
+        const std::size_t number_of_chunks = std::max<std::size_t>(
+            1, std::min(max_chunks, input_coordinates.size() / MIN_SNAPPINGS_PER_CHUNK));
+        if (number_of_chunks == 1)
+        {
+            snap(0, input_coordinates.size());
+        }
+        else
+        {
+            const auto count = input_coordinates.size();
+            tbb::parallel_for(std::size_t{0}, number_of_chunks, [&](const std::size_t chunk) {
+                snap(chunk * count / number_of_chunks, (chunk + 1) * count / number_of_chunks);
+            });
+        }
+
+        return phantom_node_pairs;
+    }
+
   private:
+    // Parallel batches snap at least this many coordinates per thread
+    static constexpr std::size_t MIN_SNAPPINGS_PER_CHUNK = 32;
+
+    std::pair<PhantomNode, PhantomNode>
+    NearestPhantomNodeWithAlternativeFromBigComponent(const util::Coordinate input_coordinate,
+                                                      const boost::optional<double> &radius,
+                                                      const boost::optional<Bearing> &bearing) const
+    {
+        if (bearing)
+        {
+            if (radius)
+            {
+                return NearestPhantomNodeWithAlternativeFromBigComponent(
+                    input_coordinate, *radius, bearing->bearing, bearing->range);
+            }
+            return NearestPhantomNodeWithAlternativeFromBigComponent(
+                input_coordinate, bearing->bearing, bearing->range);
+        }
+        if (radius)
+        {
+            return NearestPhantomNodeWithAlternativeFromBigComponent(input_coordinate, *radius);
+        }
+        return NearestPhantomNodeWithAlternativeFromBigComponent(input_coordinate);
+    }
+
+    // Memory of the nearest queries that is kept per thread
+    struct NearestData
+    {
+        typename RTreeT::NearestQueue queue;
+        std::vector<EdgeData> results;
+    };
+
+    NearestData &GetNearestData() const
+    {
+        if (!nearest_data.get())
+        {
+            nearest_data.reset(new NearestData());
+        }
+        return *nearest_data;
+    }
+
     std::vector<PhantomNodeWithDistance>
     MakePhantomNodes(const util::Coordinate input_coordinate,
                      const std::vector<EdgeData> &results) const
@@ -372,9 +513,9 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
         int forward_offset = 0, forward_weight = 0;
         int reverse_offset = 0, reverse_weight = 0;
 
-        const std::vector<EdgeWeight> forward_weight_vector =
+        const auto forward_weight_vector =
             datafacade.GetUncompressedForwardWeights(data.packed_geometry_id);
-        const std::vector<EdgeWeight> reverse_weight_vector =
+        const auto reverse_weight_vector =
             datafacade.GetUncompressedReverseWeights(data.packed_geometry_id);
 
         for (std::size_t i = 0; i < data.fwd_segment_position; i++)
@@ -470,7 +611,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
         bool forward_edge_valid = false;
         bool reverse_edge_valid = false;
 
-        const std::vector<EdgeWeight> forward_weight_vector =
+        const auto forward_weight_vector =
             datafacade.GetUncompressedForwardWeights(segment.data.packed_geometry_id);
 
         if (forward_weight_vector[segment.data.fwd_segment_position] != INVALID_EDGE_WEIGHT)
@@ -478,7 +619,7 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
             forward_edge_valid = segment.data.forward_segment_id.enabled;
         }
 
-        const std::vector<EdgeWeight> reverse_weight_vector =
+        const auto reverse_weight_vector =
             datafacade.GetUncompressedReverseWeights(segment.data.packed_geometry_id);
         if (reverse_weight_vector[reverse_weight_vector.size() - segment.data.fwd_segment_position -
                                   1] != INVALID_EDGE_WEIGHT)
@@ -492,7 +633,13 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     const RTreeT &rtree;
     const CoordinateList &coordinates;
     DataFacadeT &datafacade;
+
+    static boost::thread_specific_ptr<NearestData> nearest_data;
 };
+
+template <typename RTreeT, typename DataFacadeT>
+boost::thread_specific_ptr<typename GeospatialQuery<RTreeT, DataFacadeT>::NearestData>
+    GeospatialQuery<RTreeT, DataFacadeT>::nearest_data;
 }
 }
 
@@ -45,7 +45,7 @@ inline LegGeometry assembleGeometry(const datafacade::BaseDataFacade &facade,
 
     // Need to get the node ID preceding the source phantom node
     // TODO: check if this was traversed in reverse?
-    const std::vector<NodeID> source_geometry =
+    const auto source_geometry =
         facade.GetUncompressedForwardGeometry(source_node.packed_geometry_id);
     geometry.osm_node_ids.push_back(
         facade.GetOSMNodeIDOfNode(source_geometry[source_node.fwd_segment_position]));
@@ -80,7 +80,7 @@ inline LegGeometry assembleGeometry(const datafacade::BaseDataFacade &facade,
     // segment leading to the target node
     geometry.segment_distances.push_back(cumulative_distance);
 
-    const std::vector<DatasourceID> forward_datasources =
+    const auto forward_datasources =
         facade.GetUncompressedForwardDatasources(target_node.packed_geometry_id);
 
     geometry.annotations.emplace_back(
@@ -92,7 +92,7 @@ inline LegGeometry assembleGeometry(const datafacade::BaseDataFacade &facade,
 
     // Need to get the node ID following the destination phantom node
     // TODO: check if this was traversed in reverse??
-    const std::vector<NodeID> target_geometry =
+    const auto target_geometry =
         facade.GetUncompressedForwardGeometry(target_node.packed_geometry_id);
     geometry.osm_node_ids.push_back(
         facade.GetOSMNodeIDOfNode(target_geometry[target_node.fwd_segment_position + 1]));
@@ -27,9 +27,10 @@ class MatchPlugin : public BasePlugin
     static const constexpr double DEFAULT_GPS_PRECISION = 5;
     static const constexpr double RADIUS_MULTIPLIER = 3;
 
-    MatchPlugin(const int max_locations_map_matching)
-        : map_matching(heaps, DEFAULT_GPS_PRECISION), shortest_path(heaps),
-          max_locations_map_matching(max_locations_map_matching)
+    MatchPlugin(const int max_locations_map_matching,
+                const std::size_t max_dense_heap_nodes =
+                    SearchEngineData::DEFAULT_MAX_DENSE_HEAP_NODES)
+        : heaps(max_dense_heap_nodes), max_locations_map_matching(max_locations_map_matching)
     {
     }
 
@@ -39,8 +40,6 @@ class MatchPlugin : public BasePlugin
 
   private:
     mutable SearchEngineData heaps;
-    mutable routing_algorithms::MapMatching<datafacade::BaseDataFacade> map_matching;
-    mutable routing_algorithms::ShortestPathRouting<datafacade::BaseDataFacade> shortest_path;
     const int max_locations_map_matching;
 };
 }
@@ -6,10 +6,12 @@
 #include "engine/phantom_node.hpp"
 #include "engine/status.hpp"
 
+#include "util/binary_writer.hpp"
 #include "util/coordinate.hpp"
 #include "util/coordinate_calculation.hpp"
 #include "util/integer_range.hpp"
 #include "util/json_container.hpp"
+#include "util/json_writer.hpp"
 
 #include <algorithm>
 #include <iterator>
@@ -43,6 +45,29 @@ class BasePlugin
         return Status::Error;
     }
 
+    Status Error(const std::string &code,
+                 const std::string &message,
+                 util::json::Writer &writer) const
+    {
+        writer.StartObject();
+        writer.Key("code");
+        writer.String(code);
+        writer.Key("message");
+        writer.String(message);
+        writer.EndObject();
+        return Status::Error;
+    }
+
+    Status Error(const std::string &code,
+                 const std::string &message,
+                 util::binary::Writer &writer) const
+    {
+        writer.Header();
+        writer.String(code);
+        writer.String(message);
+        return Status::Error;
+    }
+
     // Decides whether to use the phantom node from a big or small component if both are found.
     // Returns true if all phantom nodes are in the same component after snapping.
     std::vector<PhantomNode>
@@ -218,6 +243,16 @@ class BasePlugin
 
     std::vector<PhantomNodePair> GetPhantomNodes(const datafacade::BaseDataFacade &facade,
                                                  const api::BaseParameters &parameters) const
+    {
+        return GetPhantomNodesWithParallelism(facade, parameters, 1);
+    }
+
+    // Snaps the coordinates that have no valid hint as one batch, on up to max_parallelism
+    // threads (1 for sequential, -1 for all available threads).
+    std::vector<PhantomNodePair>
+    GetPhantomNodesWithParallelism(const datafacade::BaseDataFacade &facade,
+                                   const api::BaseParameters &parameters,
+                                   const int max_parallelism) const
     {
         std::vector<PhantomNodePair> phantom_node_pairs(parameters.coordinates.size());
 
@@ -226,6 +261,10 @@ class BasePlugin
         const bool use_radiuses = !parameters.radiuses.empty();
 
         BOOST_ASSERT(parameters.IsValid());
+        std::vector<std::size_t> snapped_indices;
+        std::vector<util::Coordinate> snapped_coordinates;
+        std::vector<boost::optional<double>> snapped_radiuses;
+        std::vector<boost::optional<Bearing>> snapped_bearings;
         for (const auto i : util::irange<std::size_t>(0UL, parameters.coordinates.size()))
         {
             if (use_hints && parameters.hints[i] &&
@@ -236,42 +275,28 @@ class BasePlugin
                 continue;
             }
 
-            if (use_bearings && parameters.bearings[i])
+            snapped_indices.push_back(i);
+            snapped_coordinates.push_back(parameters.coordinates[i]);
+            if (use_radiuses)
             {
-                if (use_radiuses && parameters.radiuses[i])
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i],
-                            *parameters.radiuses[i],
-                            parameters.bearings[i]->bearing,
-                            parameters.bearings[i]->range);
-                }
-                else
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i],
-                            parameters.bearings[i]->bearing,
-                            parameters.bearings[i]->range);
-                }
+                snapped_radiuses.push_back(parameters.radiuses[i]);
             }
-            else
+            if (use_bearings)
             {
-                if (use_radiuses && parameters.radiuses[i])
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i], *parameters.radiuses[i]);
-                }
-                else
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i]);
-                }
+                snapped_bearings.push_back(parameters.bearings[i]);
             }
+        }
 
+        const auto snapped_pairs = facade.NearestPhantomNodesWithAlternativeFromBigComponent(
+            snapped_coordinates, snapped_radiuses, snapped_bearings, max_parallelism);
+        BOOST_ASSERT(snapped_pairs.size() == snapped_indices.size());
+        for (const auto j : util::irange<std::size_t>(0UL, snapped_indices.size()))
+        {
+            phantom_node_pairs[snapped_indices[j]] = snapped_pairs[j];
+        }
+
+        for (const auto i : snapped_indices)
+        {
             // we didn't find a fitting node, return error
             if (!phantom_node_pairs[i].first.IsValid(facade.GetNumberOfNodes()))
             {
@@ -6,7 +6,9 @@
 #include "engine/api/table_parameters.hpp"
 #include "engine/routing_algorithms/many_to_many.hpp"
 #include "engine/search_engine_data.hpp"
+#include "util/binary_writer.hpp"
 #include "util/json_container.hpp"
+#include "util/json_writer.hpp"
 
 namespace osrm
 {
@@ -18,16 +20,22 @@ namespace plugins
 class TablePlugin final : public BasePlugin
 {
   public:
-    explicit TablePlugin(const int max_locations_distance_table);
+    explicit TablePlugin(const int max_locations_distance_table,
+                         const int max_parallelism_distance_table = 1,
+                         const std::size_t max_dense_heap_nodes =
+                             SearchEngineData::DEFAULT_MAX_DENSE_HEAP_NODES);
 
+    // ResultT is either a util::json::Object, a util::json::Writer streaming the response or a
+    // util::binary::Writer
+    template <typename ResultT>
     Status HandleRequest(const std::shared_ptr<datafacade::BaseDataFacade> facade,
                          const api::TableParameters &params,
-                         util::json::Object &result) const;
+                         ResultT &result) const;
 
   private:
     mutable SearchEngineData heaps;
-    mutable routing_algorithms::ManyToManyRouting<datafacade::BaseDataFacade> distance_table;
     const int max_locations_distance_table;
+    const int max_parallelism_distance_table;
 };
 }
 }
@@ -30,17 +30,18 @@ class TripPlugin final : public BasePlugin
 {
   private:
     mutable SearchEngineData heaps;
-    mutable routing_algorithms::ShortestPathRouting<datafacade::BaseDataFacade> shortest_path;
-    mutable routing_algorithms::ManyToManyRouting<datafacade::BaseDataFacade> duration_table;
     const int max_locations_trip;
 
-    InternalRouteResult ComputeRoute(const datafacade::BaseDataFacade &facade,
+    template <typename DataFacadeT>
+    InternalRouteResult ComputeRoute(const DataFacadeT &facade,
                                      const std::vector<PhantomNode> &phantom_node_list,
                                      const std::vector<NodeID> &trip) const;
 
   public:
-    explicit TripPlugin(const int max_locations_trip_)
-        : shortest_path(heaps), duration_table(heaps), max_locations_trip(max_locations_trip_)
+    explicit TripPlugin(const int max_locations_trip_,
+                        const std::size_t max_dense_heap_nodes =
+                            SearchEngineData::DEFAULT_MAX_DENSE_HEAP_NODES)
+        : heaps(max_dense_heap_nodes), max_locations_trip(max_locations_trip_)
     {
     }
 
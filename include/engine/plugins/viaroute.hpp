@@ -9,6 +9,7 @@
 #include "engine/routing_algorithms/direct_shortest_path.hpp"
 #include "engine/routing_algorithms/shortest_path.hpp"
 #include "engine/search_engine_data.hpp"
+#include "util/binary_writer.hpp"
 #include "util/json_container.hpp"
 
 #include <cstdlib>
@@ -29,18 +30,18 @@ class ViaRoutePlugin final : public BasePlugin
 {
   private:
     mutable SearchEngineData heaps;
-    mutable routing_algorithms::ShortestPathRouting<datafacade::BaseDataFacade> shortest_path;
-    mutable routing_algorithms::AlternativeRouting<datafacade::BaseDataFacade> alternative_path;
-    mutable routing_algorithms::DirectShortestPathRouting<datafacade::BaseDataFacade>
-        direct_shortest_path;
     const int max_locations_viaroute;
 
   public:
-    explicit ViaRoutePlugin(int max_locations_viaroute);
+    explicit ViaRoutePlugin(int max_locations_viaroute,
+                            const std::size_t max_dense_heap_nodes =
+                                SearchEngineData::DEFAULT_MAX_DENSE_HEAP_NODES);
 
+    // ResultT is either a util::json::Object or a util::binary::Writer
+    template <typename ResultT>
     Status HandleRequest(const std::shared_ptr<datafacade::BaseDataFacade> facade,
                          const api::RouteParameters &route_parameters,
-                         util::json::Object &json_result) const;
+                         ResultT &result) const;
 };
 }
 }
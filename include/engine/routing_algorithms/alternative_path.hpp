@@ -31,6 +31,7 @@ class AlternativeRouting final
 {
     using super = BasicRoutingInterface<DataFacadeT, AlternativeRouting<DataFacadeT>>;
     using EdgeData = typename DataFacadeT::EdgeData;
+    using SearchData = typename DataFacadeT::SearchData;
     using QueryHeap = SearchEngineData::QueryHeap;
     using SearchSpaceEdge = std::pair<NodeID, NodeID>;
 
@@ -487,7 +488,7 @@ class AlternativeRouting final
             {
                 EdgeID edgeID = facade.FindEdgeInEitherDirection(packed_s_v_path[current_node],
                                                                  packed_s_v_path[current_node + 1]);
-                *sharing_of_via_path += facade.GetEdgeData(edgeID).weight;
+                *sharing_of_via_path += facade.GetSearchData(edgeID).weight;
             }
             else
             {
@@ -520,7 +521,7 @@ class AlternativeRouting final
             EdgeID selected_edge =
                 facade.FindEdgeInEitherDirection(partially_unpacked_via_path[current_node],
                                                  partially_unpacked_via_path[current_node + 1]);
-            *sharing_of_via_path += facade.GetEdgeData(selected_edge).weight;
+            *sharing_of_via_path += facade.GetSearchData(selected_edge).weight;
         }
 
         // Second, partially unpack v-->t in reverse order until paths deviate and note lengths
@@ -535,7 +536,7 @@ class AlternativeRouting final
             {
                 EdgeID edgeID = facade.FindEdgeInEitherDirection(
                     packed_v_t_path[via_path_index - 1], packed_v_t_path[via_path_index]);
-                *sharing_of_via_path += facade.GetEdgeData(edgeID).weight;
+                *sharing_of_via_path += facade.GetSearchData(edgeID).weight;
             }
             else
             {
@@ -567,7 +568,7 @@ class AlternativeRouting final
                 EdgeID edgeID = facade.FindEdgeInEitherDirection(
                     partially_unpacked_via_path[via_path_index - 1],
                     partially_unpacked_via_path[via_path_index]);
-                *sharing_of_via_path += facade.GetEdgeData(edgeID).weight;
+                *sharing_of_via_path += facade.GetSearchData(edgeID).weight;
             }
             else
             {
@@ -690,7 +691,7 @@ class AlternativeRouting final
 
         for (auto edge : facade.GetAdjacentEdgeRange(node))
         {
-            const EdgeData &data = facade.GetEdgeData(edge);
+            const SearchData &data = facade.GetSearchData(edge);
             const bool edge_is_forward_directed =
                 (is_forward_directed ? data.forward : data.backward);
             if (edge_is_forward_directed)
@@ -812,7 +813,7 @@ class AlternativeRouting final
         {
             const EdgeID current_edge_id =
                 facade.FindEdgeInEitherDirection(packed_s_v_path[i - 1], packed_s_v_path[i]);
-            const int length_of_current_edge = facade.GetEdgeData(current_edge_id).weight;
+            const int length_of_current_edge = facade.GetSearchData(current_edge_id).weight;
             if ((length_of_current_edge + unpacked_until_weight) >= T_threshold)
             {
                 unpack_stack.emplace(packed_s_v_path[i - 1], packed_s_v_path[i]);
@@ -836,14 +837,15 @@ class AlternativeRouting final
                 return false;
             }
 
-            const EdgeData &current_edge_data = facade.GetEdgeData(edge_in_via_path_id);
+            const EdgeData current_edge_data = facade.GetEdgeData(edge_in_via_path_id);
             const bool current_edge_is_shortcut = current_edge_data.shortcut;
             if (current_edge_is_shortcut)
             {
                 const NodeID via_path_middle_node_id = current_edge_data.id;
                 const EdgeID second_segment_edge_id =
                     facade.FindEdgeInEitherDirection(via_path_middle_node_id, via_path_edge.second);
-                const int second_segment_length = facade.GetEdgeData(second_segment_edge_id).weight;
+                const int second_segment_length =
+                    facade.GetSearchData(second_segment_edge_id).weight;
                 // attention: !unpacking in reverse!
                 // Check if second segment is the one to go over treshold? if yes add second segment
                 // to stack, else push first segment to stack and add weight of second one.
@@ -875,7 +877,7 @@ class AlternativeRouting final
         {
             const EdgeID edgeID =
                 facade.FindEdgeInEitherDirection(packed_v_t_path[i], packed_v_t_path[i + 1]);
-            int length_of_current_edge = facade.GetEdgeData(edgeID).weight;
+            int length_of_current_edge = facade.GetSearchData(edgeID).weight;
             if (length_of_current_edge + unpacked_until_weight >= T_threshold)
             {
                 unpack_stack.emplace(packed_v_t_path[i], packed_v_t_path[i + 1]);
@@ -898,14 +900,14 @@ class AlternativeRouting final
                 return false;
             }
 
-            const EdgeData &current_edge_data = facade.GetEdgeData(edge_in_via_path_id);
+            const EdgeData current_edge_data = facade.GetEdgeData(edge_in_via_path_id);
             const bool IsViaEdgeShortCut = current_edge_data.shortcut;
             if (IsViaEdgeShortCut)
             {
                 const NodeID middleOfViaPath = current_edge_data.id;
                 EdgeID edgeIDOfFirstSegment =
                     facade.FindEdgeInEitherDirection(via_path_edge.first, middleOfViaPath);
-                int lengthOfFirstSegment = facade.GetEdgeData(edgeIDOfFirstSegment).weight;
+                int lengthOfFirstSegment = facade.GetSearchData(edgeIDOfFirstSegment).weight;
                 // Check if first segment is the one to go over treshold? if yes first segment to
                 // stack, else push second segment to stack and add weight of first one.
                 if (unpacked_until_weight + lengthOfFirstSegment >= T_threshold)
@@ -1,15 +1,22 @@
 #ifndef MANY_TO_MANY_ROUTING_HPP
 #define MANY_TO_MANY_ROUTING_HPP
 
+#include "engine/routing_algorithms/node_bucket_index.hpp"
 #include "engine/routing_algorithms/routing_base.hpp"
 #include "engine/search_engine_data.hpp"
+#include "util/integer_range.hpp"
 #include "util/typedefs.hpp"
 
 #include <boost/assert.hpp>
 
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/task_scheduler_init.h>
+
+#include <algorithm>
 #include <limits>
 #include <memory>
-#include <unordered_map>
+#include <tuple>
 #include <vector>
 
 namespace osrm
@@ -29,21 +36,53 @@ class ManyToManyRouting final
 
     struct NodeBucket
     {
+        NodeID middle_node;
         unsigned target_id; // essentially a row in the weight matrix
         EdgeWeight weight;
-        NodeBucket(const unsigned target_id, const EdgeWeight weight)
-            : target_id(target_id), weight(weight)
+        NodeBucket(const NodeID middle_node, const unsigned target_id, const EdgeWeight weight)
+            : middle_node(middle_node), target_id(target_id), weight(weight)
         {
         }
+
+        // keeps the buckets of a node ordered by column so that the forward searches
+        // walk the result table row in order, independent of the order they were added in
+        bool operator<(const NodeBucket &rhs) const
+        {
+            return std::tie(middle_node, target_id) < std::tie(rhs.middle_node, rhs.target_id);
+        }
     };
 
-    // FIXME This should be replaced by an std::unordered_multimap, though this needs benchmarking
-    using SearchSpaceWithBuckets = std::unordered_map<NodeID, std::vector<NodeBucket>>;
+    // All buckets of all backward searches in one flat array. The backward searches append to
+    // it in settle order, afterwards it is sorted by middle node once so that the buckets of a
+    // node are contiguous. The forward searches look them up in a NodeBucketIndex.
+    using SearchSpaceWithBuckets = std::vector<NodeBucket>;
+
+    // Buckets of backward searches whose paths are unpacked afterwards, parent is the node
+    // middle_node was reached from in the backward search of target_id.
+    struct PathNodeBucket : NodeBucket
+    {
+        NodeID parent;
+        PathNodeBucket(const NodeID middle_node,
+                       const unsigned target_id,
+                       const EdgeWeight weight,
+                       const NodeID parent)
+            : NodeBucket(middle_node, target_id, weight), parent(parent)
+        {
+        }
+    };
+
+    using SearchSpaceWithPathBuckets = std::vector<PathNodeBucket>;
+
+    // Below this number of searches per direction splitting the work is not worth the overhead
+    static constexpr std::size_t MIN_SEARCHES_PER_CHUNK = 8;
 
   public:
-    ManyToManyRouting(SearchEngineData &engine_working_data)
-        : engine_working_data(engine_working_data)
+    // max_parallelism caps the number of threads a single request may occupy:
+    // 1 runs all searches on the calling thread, -1 uses as many threads as TBB offers.
+    ManyToManyRouting(SearchEngineData &engine_working_data, const int max_parallelism = 1)
+        : engine_working_data(engine_working_data), max_parallelism(max_parallelism)
     {
+        BOOST_ASSERT(max_parallelism == -1 || max_parallelism > 0);
     }
 
     std::vector<EdgeWeight> operator()(const DataFacadeT &facade,
@@ -59,103 +98,271 @@ class ManyToManyRouting final
         std::vector<EdgeWeight> result_table(number_of_entries,
                                              std::numeric_limits<EdgeWeight>::max());
 
-        engine_working_data.InitializeOrClearFirstThreadLocalStorage(facade.GetNumberOfNodes());
+        const auto get_source_phantom = [&](const std::size_t row_idx) -> const PhantomNode & {
+            return source_indices.empty() ? phantom_nodes[row_idx]
+                                          : phantom_nodes[source_indices[row_idx]];
+        };
+        const auto get_target_phantom = [&](const std::size_t column_idx) -> const PhantomNode & {
+            return target_indices.empty() ? phantom_nodes[column_idx]
+                                          : phantom_nodes[target_indices[column_idx]];
+        };
 
-        QueryHeap &query_heap = *(engine_working_data.forward_heap_1);
+        // Every chunk runs its backward searches into its own shard of buckets, the shards
+        // are merged into one array before the forward searches start.
+        const auto number_of_target_chunks = GetNumberOfChunks(number_of_targets);
+        std::vector<SearchSpaceWithBuckets> bucket_shards(number_of_target_chunks);
+        ForEachChunk(number_of_targets,
+                     number_of_target_chunks,
+                     [&](const std::size_t chunk, const std::size_t begin, const std::size_t end) {
+                         engine_working_data.InitializeOrClearFirstThreadLocalStorage(
+                             facade.GetNumberOfNodes());
+                         QueryHeap &query_heap = *(engine_working_data.forward_heap_1);
+                         for (auto column_idx = begin; column_idx < end; ++column_idx)
+                         {
+                             SearchTargetPhantom(facade,
+                                                 get_target_phantom(column_idx),
+                                                 column_idx,
+                                                 query_heap,
+                                                 bucket_shards[chunk]);
+                         }
+                     });
 
         SearchSpaceWithBuckets search_space_with_buckets;
+        if (bucket_shards.size() == 1)
+        {
+            search_space_with_buckets = std::move(bucket_shards.front());
+        }
+        else
+        {
+            std::size_t number_of_buckets = 0;
+            for (const auto &shard : bucket_shards)
+            {
+                number_of_buckets += shard.size();
+            }
+            search_space_with_buckets.reserve(number_of_buckets);
+            for (auto &shard : bucket_shards)
+            {
+                search_space_with_buckets.insert(
+                    search_space_with_buckets.end(), shard.begin(), shard.end());
+                SearchSpaceWithBuckets().swap(shard);
+            }
+        }
 
-        unsigned column_idx = 0;
-        const auto search_target_phantom = [&](const PhantomNode &phantom) {
-            query_heap.Clear();
-            // insert target(s) at weight 0
+        if (number_of_target_chunks > 1)
+        {
+            tbb::parallel_sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+        }
+        else
+        {
+            std::sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+        }
+        NodeBucketIndex bucket_index;
+        bucket_index.Build(search_space_with_buckets);
+
+        // Every row of the result table is written by exactly one forward search
+        ForEachChunk(number_of_sources,
+                     GetNumberOfChunks(number_of_sources),
+                     [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+                         engine_working_data.InitializeOrClearFirstThreadLocalStorage(
+                             facade.GetNumberOfNodes());
+                         QueryHeap &query_heap = *(engine_working_data.forward_heap_1);
+                         for (auto row_idx = begin; row_idx < end; ++row_idx)
+                         {
+                             SearchSourcePhantom(facade,
+                                                 get_source_phantom(row_idx),
+                                                 row_idx,
+                                                 number_of_targets,
+                                                 query_heap,
+                                                 search_space_with_buckets,
+                                                 bucket_index,
+                                                 result_table);
+                         }
+                     });
 
+        return result_table;
+    }
+
+    // Network distances in meters of the shortest paths from every source to every target, row
+    // by row. This is what GetNetworkDistance computes for a single pair, e.g. the map matching
+    // gets all transitions between the candidates of two timestamps in one pass this way.
+    // Paths with a weight of weight_upper_bound or more are not reported and have a distance of
+    // std::numeric_limits<double>::max().
+    std::vector<double>
+    GetNetworkDistances(const DataFacadeT &facade,
+                        const std::vector<PhantomNode> &source_phantoms,
+                        const std::vector<PhantomNode> &target_phantoms,
+                        const EdgeWeight weight_upper_bound = INVALID_EDGE_WEIGHT) const
+    {
+        const auto number_of_targets = target_phantoms.size();
+        std::vector<double> distances(source_phantoms.size() * number_of_targets,
+                                      std::numeric_limits<double>::max());
+        if (distances.empty())
+        {
+            return distances;
+        }
+
+        engine_working_data.InitializeOrClearFirstThreadLocalStorage(facade.GetNumberOfNodes());
+        QueryHeap &query_heap = *(engine_working_data.forward_heap_1);
+
+        // the forward searches start with negative offsets, so the backward searches need to
+        // settle all nodes that can still be combined with them to a path below the bound
+        EdgeWeight min_source_offset = 0;
+        for (const auto &phantom : source_phantoms)
+        {
             if (phantom.forward_segment_id.enabled)
             {
-                query_heap.Insert(phantom.forward_segment_id.id,
-                                  phantom.GetForwardWeightPlusOffset(),
-                                  phantom.forward_segment_id.id);
+                min_source_offset =
+                    std::min(min_source_offset, -phantom.GetForwardWeightPlusOffset());
             }
             if (phantom.reverse_segment_id.enabled)
             {
-                query_heap.Insert(phantom.reverse_segment_id.id,
-                                  phantom.GetReverseWeightPlusOffset(),
-                                  phantom.reverse_segment_id.id);
+                min_source_offset =
+                    std::min(min_source_offset, -phantom.GetReverseWeightPlusOffset());
             }
+        }
+        const EdgeWeight backward_upper_bound = weight_upper_bound == INVALID_EDGE_WEIGHT
+                                                    ? INVALID_EDGE_WEIGHT
+                                                    : weight_upper_bound - min_source_offset;
 
-            // explore search space
-            while (!query_heap.Empty())
-            {
-                BackwardRoutingStep(facade, column_idx, query_heap, search_space_with_buckets);
-            }
-            ++column_idx;
-        };
+        SearchSpaceWithPathBuckets search_space_with_buckets;
+        for (const auto column_idx : util::irange<std::size_t>(0UL, number_of_targets))
+        {
+            SearchTargetPhantom(facade,
+                                target_phantoms[column_idx],
+                                column_idx,
+                                query_heap,
+                                search_space_with_buckets,
+                                backward_upper_bound);
+        }
+        std::sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+        NodeBucketIndex bucket_index;
+        bucket_index.Build(search_space_with_buckets);
+
+        std::vector<EdgeWeight> weights(number_of_targets);
+        std::vector<NodeID> middle_nodes(number_of_targets);
+        std::vector<NodeID> packed_path;
+        for (const auto row_idx : util::irange<std::size_t>(0UL, source_phantoms.size()))
+        {
+            const auto &source_phantom = source_phantoms[row_idx];
+            std::fill(weights.begin(), weights.end(), weight_upper_bound);
+            std::fill(middle_nodes.begin(), middle_nodes.end(), SPECIAL_NODEID);
 
-        // for each source do forward search
-        unsigned row_idx = 0;
-        const auto search_source_phantom = [&](const PhantomNode &phantom) {
             query_heap.Clear();
-            // insert target(s) at weight 0
-
-            if (phantom.forward_segment_id.enabled)
+            if (source_phantom.forward_segment_id.enabled)
             {
-                query_heap.Insert(phantom.forward_segment_id.id,
-                                  -phantom.GetForwardWeightPlusOffset(),
-                                  phantom.forward_segment_id.id);
+                query_heap.Insert(source_phantom.forward_segment_id.id,
+                                  -source_phantom.GetForwardWeightPlusOffset(),
+                                  source_phantom.forward_segment_id.id);
             }
-            if (phantom.reverse_segment_id.enabled)
+            if (source_phantom.reverse_segment_id.enabled)
             {
-                query_heap.Insert(phantom.reverse_segment_id.id,
-                                  -phantom.GetReverseWeightPlusOffset(),
-                                  phantom.reverse_segment_id.id);
+                query_heap.Insert(source_phantom.reverse_segment_id.id,
+                                  -source_phantom.GetReverseWeightPlusOffset(),
+                                  source_phantom.reverse_segment_id.id);
             }
 
-            // explore search space
-            while (!query_heap.Empty())
+            // bucket weights are never negative, so nothing below the bound is left once the
+            // forward search reaches it
+            while (!query_heap.Empty() && query_heap.MinKey() < weight_upper_bound)
             {
-                ForwardRoutingStep(facade,
-                                   row_idx,
-                                   number_of_targets,
-                                   query_heap,
-                                   search_space_with_buckets,
-                                   result_table);
+                ForwardPathRoutingStep(facade,
+                                       query_heap,
+                                       search_space_with_buckets,
+                                       bucket_index,
+                                       weights,
+                                       middle_nodes);
             }
-            ++row_idx;
-        };
 
-        if (target_indices.empty())
-        {
-            for (const auto &phantom : phantom_nodes)
+            for (const auto column_idx : util::irange<std::size_t>(0UL, number_of_targets))
             {
-                search_target_phantom(phantom);
+                if (middle_nodes[column_idx] == SPECIAL_NODEID)
+                {
+                    continue;
+                }
+
+                packed_path.clear();
+                RetrievePackedPathFromBuckets(query_heap,
+                                              search_space_with_buckets,
+                                              bucket_index,
+                                              middle_nodes[column_idx],
+                                              column_idx,
+                                              weights[column_idx],
+                                              packed_path);
+                distances[row_idx * number_of_targets + column_idx] = super::GetPathDistance(
+                    facade, packed_path, source_phantom, target_phantoms[column_idx]);
             }
         }
-        else
+
+        return distances;
+    }
+
+    template <typename BucketsT>
+    void SearchTargetPhantom(const DataFacadeT &facade,
+                             const PhantomNode &phantom,
+                             const unsigned column_idx,
+                             QueryHeap &query_heap,
+                             BucketsT &search_space_with_buckets,
+                             const EdgeWeight weight_upper_bound = INVALID_EDGE_WEIGHT) const
+    {
+        query_heap.Clear();
+        // insert target(s) at weight 0
+
+        if (phantom.forward_segment_id.enabled)
         {
-            for (const auto index : target_indices)
-            {
-                const auto &phantom = phantom_nodes[index];
-                search_target_phantom(phantom);
-            }
+            query_heap.Insert(phantom.forward_segment_id.id,
+                              phantom.GetForwardWeightPlusOffset(),
+                              phantom.forward_segment_id.id);
+        }
+        if (phantom.reverse_segment_id.enabled)
+        {
+            query_heap.Insert(phantom.reverse_segment_id.id,
+                              phantom.GetReverseWeightPlusOffset(),
+                              phantom.reverse_segment_id.id);
         }
 
-        if (source_indices.empty())
+        // explore search space
+        while (!query_heap.Empty() && query_heap.MinKey() < weight_upper_bound)
         {
-            for (const auto &phantom : phantom_nodes)
-            {
-                search_source_phantom(phantom);
-            }
+            BackwardRoutingStep(facade, column_idx, query_heap, search_space_with_buckets);
         }
-        else
+    }
+
+    void SearchSourcePhantom(const DataFacadeT &facade,
+                             const PhantomNode &phantom,
+                             const unsigned row_idx,
+                             const unsigned number_of_targets,
+                             QueryHeap &query_heap,
+                             const SearchSpaceWithBuckets &search_space_with_buckets,
+                             const NodeBucketIndex &bucket_index,
+                             std::vector<EdgeWeight> &result_table) const
+    {
+        query_heap.Clear();
+        // insert target(s) at weight 0
+
+        if (phantom.forward_segment_id.enabled)
         {
-            for (const auto index : source_indices)
-            {
-                const auto &phantom = phantom_nodes[index];
-                search_source_phantom(phantom);
-            }
+            query_heap.Insert(phantom.forward_segment_id.id,
+                              -phantom.GetForwardWeightPlusOffset(),
+                              phantom.forward_segment_id.id);
+        }
+        if (phantom.reverse_segment_id.enabled)
+        {
+            query_heap.Insert(phantom.reverse_segment_id.id,
+                              -phantom.GetReverseWeightPlusOffset(),
+                              phantom.reverse_segment_id.id);
         }
 
-        return result_table;
+        // explore search space
+        while (!query_heap.Empty())
+        {
+            ForwardRoutingStep(facade,
+                               row_idx,
+                               number_of_targets,
+                               query_heap,
+                               search_space_with_buckets,
+                               bucket_index,
+                               result_table);
+        }
     }
 
     void ForwardRoutingStep(const DataFacadeT &facade,
@@ -163,38 +370,76 @@ class ManyToManyRouting final
                             const unsigned number_of_targets,
                             QueryHeap &query_heap,
                             const SearchSpaceWithBuckets &search_space_with_buckets,
+                            const NodeBucketIndex &bucket_index,
                             std::vector<EdgeWeight> &result_table) const
     {
         const NodeID node = query_heap.DeleteMin();
         const int source_weight = query_heap.GetKey(node);
 
         // check if each encountered node has an entry
-        const auto bucket_iterator = search_space_with_buckets.find(node);
-        // iterate bucket if there exists one
-        if (bucket_iterator != search_space_with_buckets.end())
+        const auto bucket_range = bucket_index.Find(node);
+        for (auto bucket_idx = bucket_range.first; bucket_idx < bucket_range.second; ++bucket_idx)
         {
-            const std::vector<NodeBucket> &bucket_list = bucket_iterator->second;
-            for (const NodeBucket &current_bucket : bucket_list)
+            const auto &current_bucket = search_space_with_buckets[bucket_idx];
+            // get target id from bucket entry
+            const unsigned column_idx = current_bucket.target_id;
+            const int target_weight = current_bucket.weight;
+            auto &current_weight = result_table[row_idx * number_of_targets + column_idx];
+            // check if new weight is better
+            const EdgeWeight new_weight = source_weight + target_weight;
+            if (new_weight < 0)
             {
-                // get target id from bucket entry
-                const unsigned column_idx = current_bucket.target_id;
-                const int target_weight = current_bucket.weight;
-                auto &current_weight = result_table[row_idx * number_of_targets + column_idx];
-                // check if new weight is better
-                const EdgeWeight new_weight = source_weight + target_weight;
-                if (new_weight < 0)
+                const EdgeWeight loop_weight = super::GetLoopWeight(facade, node);
+                const int new_weight_with_loop = new_weight + loop_weight;
+                if (loop_weight != INVALID_EDGE_WEIGHT && new_weight_with_loop >= 0)
                 {
-                    const EdgeWeight loop_weight = super::GetLoopWeight(facade, node);
-                    const int new_weight_with_loop = new_weight + loop_weight;
-                    if (loop_weight != INVALID_EDGE_WEIGHT && new_weight_with_loop >= 0)
-                    {
-                        current_weight = std::min(current_weight, new_weight_with_loop);
-                    }
+                    current_weight = std::min(current_weight, new_weight_with_loop);
                 }
-                else if (new_weight < current_weight)
+            }
+            else if (new_weight < current_weight)
+            {
+                result_table[row_idx * number_of_targets + column_idx] = new_weight;
+            }
+        }
+        if (StallAtNode<true>(facade, node, source_weight, query_heap))
+        {
+            return;
+        }
+        RelaxOutgoingEdges<true>(facade, node, source_weight, query_heap);
+    }
+
+    // Like ForwardRoutingStep, but remembers the middle node of the best path to each target
+    // instead of only its weight so the path can be unpacked after the search.
+    void ForwardPathRoutingStep(const DataFacadeT &facade,
+                                QueryHeap &query_heap,
+                                const SearchSpaceWithPathBuckets &search_space_with_buckets,
+                                const NodeBucketIndex &bucket_index,
+                                std::vector<EdgeWeight> &weights,
+                                std::vector<NodeID> &middle_nodes) const
+    {
+        const NodeID node = query_heap.DeleteMin();
+        const int source_weight = query_heap.GetKey(node);
+
+        const auto bucket_range = bucket_index.Find(node);
+        for (auto bucket_idx = bucket_range.first; bucket_idx < bucket_range.second; ++bucket_idx)
+        {
+            const auto &current_bucket = search_space_with_buckets[bucket_idx];
+            const unsigned column_idx = current_bucket.target_id;
+            EdgeWeight new_weight = source_weight + current_bucket.weight;
+            // source and target on the same segment with the target before the source
+            if (new_weight < 0)
+            {
+                const EdgeWeight loop_weight = super::GetLoopWeight(facade, node);
+                if (loop_weight == INVALID_EDGE_WEIGHT || new_weight + loop_weight < 0)
                 {
-                    result_table[row_idx * number_of_targets + column_idx] = new_weight;
+                    continue;
                 }
+                new_weight += loop_weight;
+            }
+            if (new_weight < weights[column_idx])
+            {
+                weights[column_idx] = new_weight;
+                middle_nodes[column_idx] = node;
             }
         }
         if (StallAtNode<true>(facade, node, source_weight, query_heap))
@@ -204,16 +449,21 @@ class ManyToManyRouting final
         RelaxOutgoingEdges<true>(facade, node, source_weight, query_heap);
     }
 
+    template <typename BucketsT>
     void BackwardRoutingStep(const DataFacadeT &facade,
                              const unsigned column_idx,
                              QueryHeap &query_heap,
-                             SearchSpaceWithBuckets &search_space_with_buckets) const
+                             BucketsT &search_space_with_buckets) const
     {
         const NodeID node = query_heap.DeleteMin();
         const int target_weight = query_heap.GetKey(node);
 
         // store settled nodes in search space bucket
-        search_space_with_buckets[node].emplace_back(column_idx, target_weight);
+        AddBucket(search_space_with_buckets,
+                  node,
+                  column_idx,
+                  target_weight,
+                  query_heap.GetData(node).parent);
 
         if (StallAtNode<false>(facade, node, target_weight, query_heap))
         {
@@ -231,7 +481,7 @@ class ManyToManyRouting final
     {
         for (auto edge : facade.GetAdjacentEdgeRange(node))
         {
-            const auto &data = facade.GetEdgeData(edge);
+            const auto &data = facade.GetSearchData(edge);
             const bool direction_flag = (forward_direction ? data.forward : data.backward);
             if (direction_flag)
             {
@@ -266,7 +516,7 @@ class ManyToManyRouting final
     {
         for (auto edge : facade.GetAdjacentEdgeRange(node))
         {
-            const auto &data = facade.GetEdgeData(edge);
+            const auto &data = facade.GetSearchData(edge);
             const bool reverse_flag = ((!forward_direction) ? data.forward : data.backward);
             if (reverse_flag)
             {
@@ -284,6 +534,106 @@ class ManyToManyRouting final
         }
         return false;
     }
+
+  private:
+    static void AddBucket(SearchSpaceWithBuckets &search_space_with_buckets,
+                          const NodeID node,
+                          const unsigned column_idx,
+                          const EdgeWeight weight,
+                          const NodeID /* parent */)
+    {
+        search_space_with_buckets.emplace_back(node, column_idx, weight);
+    }
+
+    static void AddBucket(SearchSpaceWithPathBuckets &search_space_with_buckets,
+                          const NodeID node,
+                          const unsigned column_idx,
+                          const EdgeWeight weight,
+                          const NodeID parent)
+    {
+        search_space_with_buckets.emplace_back(node, column_idx, weight, parent);
+    }
+
+    static typename SearchSpaceWithPathBuckets::const_iterator
+    FindBucket(const SearchSpaceWithPathBuckets &search_space_with_buckets,
+               const NodeBucketIndex &bucket_index,
+               const NodeID node,
+               const unsigned column_idx)
+    {
+        // the buckets of a node are sorted by column
+        const auto bucket_range = bucket_index.Find(node);
+        const auto bucket =
+            std::lower_bound(search_space_with_buckets.begin() + bucket_range.first,
+                             search_space_with_buckets.begin() + bucket_range.second,
+                             NodeBucket(node, column_idx, 0));
+        BOOST_ASSERT(bucket != search_space_with_buckets.end() && bucket->middle_node == node &&
+                     bucket->target_id == column_idx);
+        return bucket;
+    }
+
+    // Counterpart of RetrievePackedPathFromHeap for a forward heap and the backward search
+    // that is stored in the buckets of the target.
+    void RetrievePackedPathFromBuckets(QueryHeap &forward_heap,
+                                       const SearchSpaceWithPathBuckets &search_space_with_buckets,
+                                       const NodeBucketIndex &bucket_index,
+                                       const NodeID middle_node,
+                                       const unsigned column_idx,
+                                       const EdgeWeight weight,
+                                       std::vector<NodeID> &packed_path) const
+    {
+        auto bucket =
+            FindBucket(search_space_with_buckets, bucket_index, middle_node, column_idx);
+
+        // make sure to correctly unpack loops
+        if (weight != forward_heap.GetKey(middle_node) + bucket->weight)
+        {
+            // self loop makes up the full path
+            packed_path.push_back(middle_node);
+            packed_path.push_back(middle_node);
+            return;
+        }
+
+        super::RetrievePackedPathFromSingleHeap(forward_heap, middle_node, packed_path);
+        std::reverse(packed_path.begin(), packed_path.end());
+        packed_path.push_back(middle_node);
+        // the backward searches start at nodes that are their own parent
+        while (bucket->parent != bucket->middle_node)
+        {
+            bucket =
+                FindBucket(search_space_with_buckets, bucket_index, bucket->parent, column_idx);
+            packed_path.push_back(bucket->middle_node);
+        }
+    }
+
+    std::size_t GetNumberOfChunks(const std::size_t number_of_searches) const
+    {
+        const std::size_t max_chunks =
+            max_parallelism < 0 ? tbb::task_scheduler_init::default_num_threads()
+                                : static_cast<std::size_t>(max_parallelism);
+        return std::max<std::size_t>(
+            1, std::min(max_chunks, number_of_searches / MIN_SEARCHES_PER_CHUNK));
+    }
+
+    // Splits [0, count) into number_of_chunks contiguous ranges and calls
+    // chunk_function(chunk, begin, end) for each of them, in parallel if there is more than one.
+    template <typename ChunkFunction>
+    void ForEachChunk(const std::size_t count,
+                      const std::size_t number_of_chunks,
+                      ChunkFunction chunk_function) const
+    {
+        if (number_of_chunks <= 1)
+        {
+            chunk_function(0, 0, count);
+            return;
+        }
+
+        tbb::parallel_for(std::size_t{0}, number_of_chunks, [&](const std::size_t chunk) {
+            chunk_function(
+                chunk, chunk * count / number_of_chunks, (chunk + 1) * count / number_of_chunks);
+        });
+    }
+
+    const int max_parallelism;
 };
 }
 }
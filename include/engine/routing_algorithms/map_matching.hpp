@@ -1,6 +1,7 @@
 #ifndef MAP_MATCHING_HPP
 #define MAP_MATCHING_HPP
 
+#include "engine/routing_algorithms/many_to_many.hpp"
 #include "engine/routing_algorithms/routing_base.hpp"
 
 #include "engine/map_matching/hidden_markov_model.hpp"
@@ -41,8 +42,9 @@ template <class DataFacadeT>
 class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<DataFacadeT>>
 {
     using super = BasicRoutingInterface<DataFacadeT, MapMatching<DataFacadeT>>;
-    using QueryHeap = SearchEngineData::QueryHeap;
     SearchEngineData &engine_working_data;
+    // computes all transitions between the candidates of two timestamps at once
+    ManyToManyRouting<DataFacadeT> transition_routing;
     map_matching::EmissionLogProbability default_emission_log_probability;
     map_matching::TransitionLogProbability transition_log_probability;
     map_matching::MatchingConfidence confidence;
@@ -64,7 +66,7 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
 
   public:
     MapMatching(SearchEngineData &engine_working_data, const double default_gps_precision)
-        : engine_working_data(engine_working_data),
+        : engine_working_data(engine_working_data), transition_routing(engine_working_data),
           default_emission_log_probability(default_gps_precision),
           transition_log_probability(MATCHING_BETA)
     {
@@ -157,13 +159,9 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
             return sub_matchings;
         }
 
-        engine_working_data.InitializeOrClearFirstThreadLocalStorage(facade.GetNumberOfNodes());
-        engine_working_data.InitializeOrClearSecondThreadLocalStorage(facade.GetNumberOfNodes());
-
-        QueryHeap &forward_heap = *(engine_working_data.forward_heap_1);
-        QueryHeap &reverse_heap = *(engine_working_data.reverse_heap_1);
-        QueryHeap &forward_core_heap = *(engine_working_data.forward_heap_2);
-        QueryHeap &reverse_core_heap = *(engine_working_data.reverse_heap_2);
+        std::vector<std::size_t> transition_sources;
+        std::vector<PhantomNode> source_phantoms;
+        std::vector<PhantomNode> target_phantoms;
 
         std::size_t breakage_begin = map_matching::INVALID_STATE;
         std::vector<std::size_t> split_points;
@@ -236,18 +234,37 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
             // assumes minumum of 0.1 m/s
             const int duration_uppder_bound =
                 ((haversine_distance + max_distance_delta) * 0.25) * 10;
-
-            // compute d_t for this timestamp and the next one
+            // only the search with core was ever bounded, without core the transitions stay
+            // unbounded so the matching does not change
+            const EdgeWeight transition_upper_bound =
+                facade.GetCoreSize() > 0 ? duration_uppder_bound : INVALID_EDGE_WEIGHT;
+
+            // network distances from all unpruned candidates of the previous timestamp to all
+            // candidates of this one, one many-to-many search instead of one search per pair
+            transition_sources.clear();
+            source_phantoms.clear();
             for (const auto s : util::irange<std::size_t>(0UL, prev_viterbi.size()))
             {
-                if (prev_pruned[s])
+                if (!prev_pruned[s])
                 {
-                    continue;
+                    transition_sources.push_back(s);
+                    source_phantoms.push_back(prev_unbroken_timestamps_list[s].phantom_node);
                 }
+            }
+            target_phantoms.clear();
+            for (const auto &candidate : current_timestamps_list)
+            {
+                target_phantoms.push_back(candidate.phantom_node);
+            }
+            const auto network_distances = transition_routing.GetNetworkDistances(
+                facade, source_phantoms, target_phantoms, transition_upper_bound);
 
+            // compute d_t for this timestamp and the next one
+            for (const auto row_idx : util::irange<std::size_t>(0UL, transition_sources.size()))
+            {
+                const auto s = transition_sources[row_idx];
                 for (const auto s_prime : util::irange<std::size_t>(0UL, current_viterbi.size()))
                 {
-                    
                     const double emission_pr = emission_log_probabilities[t][s_prime];
                     double new_value = prev_viterbi[s] + emission_pr;
                     if (current_viterbi[s_prime] > new_value)
@@ -255,33 +272,8 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
                         continue;
                     }
 
-                    forward_heap.Clear();
-                    reverse_heap.Clear();
-
-                    double network_distance;
-                    if (facade.GetCoreSize() > 0)
-                    {
-                        forward_core_heap.Clear();
-                        reverse_core_heap.Clear();
-                        network_distance = super::GetNetworkDistanceWithCore(
-                            facade,
-                            forward_heap,
-                            reverse_heap,
-                            forward_core_heap,
-                            reverse_core_heap,
-                            prev_unbroken_timestamps_list[s].phantom_node,
-                            current_timestamps_list[s_prime].phantom_node,
-                            duration_uppder_bound);
-                    }
-                    else
-                    {
-                        network_distance = super::GetNetworkDistance(
-                            facade,
-                            forward_heap,
-                            reverse_heap,
-                            prev_unbroken_timestamps_list[s].phantom_node,
-                            current_timestamps_list[s_prime].phantom_node);
-                    }
+                    const double network_distance =
+                        network_distances[row_idx * target_phantoms.size() + s_prime];
 
                     // get distance diff between loc1/2 and locs/s_prime
                     const auto d_t = std::abs(network_distance - haversine_distance);
@@ -289,7 +281,7 @@ class MapMatching final : public BasicRoutingInterface<DataFacadeT, MapMatching<
                     // very low probability transition -> prune
                     if (d_t >= max_distance_delta)
                     {
-                       continue;
+                        continue;
                     }
 
                     const double transition_pr = transition_log_probability(d_t);
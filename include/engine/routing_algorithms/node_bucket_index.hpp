@@ -0,0 +1,109 @@
+#ifndef NODE_BUCKET_INDEX_HPP
+#define NODE_BUCKET_INDEX_HPP
+
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+
+// Offsets of the buckets of every middle node in an array of buckets sorted by middle node, the
+// CSR index of the many-to-many buckets. The forward searches settle far more nodes than there
+// are nodes with buckets, so instead of an offset array over all nodes of the graph only the
+// nodes with buckets are stored in an open addressing hash table. It is at most half full, a
+// probe for a node without buckets ends at the first empty slot.
+class NodeBucketIndex
+{
+  public:
+    using BucketRange = std::pair<std::uint32_t, std::uint32_t>;
+
+    // buckets needs to be sorted by middle_node
+    template <typename BucketsT> void Build(const BucketsT &buckets)
+    {
+        BOOST_ASSERT(buckets.size() < std::numeric_limits<std::uint32_t>::max());
+
+        std::size_t number_of_nodes = 0;
+        for (std::size_t index = 0; index < buckets.size(); ++index)
+        {
+            if (index == 0 || buckets[index - 1].middle_node != buckets[index].middle_node)
+            {
+                ++number_of_nodes;
+            }
+        }
+
+        shift = 63;
+        while ((std::size_t{1} << (64 - shift)) < 2 * number_of_nodes)
+        {
+            --shift;
+        }
+        slots.assign(std::size_t{1} << (64 - shift), Slot{SPECIAL_NODEID, 0, 0});
+
+        std::uint32_t begin = 0;
+        while (begin < buckets.size())
+        {
+            const auto node = buckets[begin].middle_node;
+            auto end = begin + 1;
+            while (end < buckets.size() && buckets[end].middle_node == node)
+            {
+                ++end;
+            }
+
+            auto slot = GetSlot(node);
+            while (slots[slot].node != SPECIAL_NODEID)
+            {
+                slot = (slot + 1) & (slots.size() - 1);
+            }
+            slots[slot] = Slot{node, begin, end};
+            begin = end;
+        }
+    }
+
+    // Returns the range of the buckets of node, empty if it has none
+    BucketRange Find(const NodeID node) const
+    {
+        for (auto slot = GetSlot(node);; slot = (slot + 1) & (slots.size() - 1))
+        {
+            if (slots[slot].node == node)
+            {
+                return {slots[slot].begin, slots[slot].end};
+            }
+            if (slots[slot].node == SPECIAL_NODEID)
+            {
+                return {0, 0};
+            }
+        }
+    }
+
+  private:
+    struct Slot
+    {
+        NodeID node;
+        std::uint32_t begin;
+        std::uint32_t end;
+    };
+
+    // Fibonacci hashing, the upper bits of the product are well mixed even for consecutive
+    // node ids
+    std::size_t GetSlot(const NodeID node) const
+    {
+        return static_cast<std::size_t>((node * UINT64_C(0x9E3779B97F4A7C15)) >> shift);
+    }
+
+    std::vector<Slot> slots;
+    unsigned shift = 63;
+};
+}
+}
+}
+
+#endif
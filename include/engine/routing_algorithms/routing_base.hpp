@@ -5,6 +5,7 @@
 #include "engine/edge_unpacker.hpp"
 #include "engine/internal_route_result.hpp"
 #include "engine/search_engine_data.hpp"
+#include "util/array_view.hpp"
 #include "util/coordinate_calculation.hpp"
 #include "util/guidance/turn_bearing.hpp"
 #include "util/typedefs.hpp"
@@ -33,6 +34,7 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
 {
   private:
     using EdgeData = typename DataFacadeT::EdgeData;
+    using SearchData = typename DataFacadeT::SearchData;
 
   public:
     /*
@@ -93,7 +95,7 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
                     // check whether there is a loop present at the node
                     for (const auto edge : facade.GetAdjacentEdgeRange(node))
                     {
-                        const EdgeData &data = facade.GetEdgeData(edge);
+                        const SearchData &data = facade.GetSearchData(edge);
                         bool forward_directionFlag =
                             (forward_direction ? data.forward : data.backward);
                         if (forward_directionFlag)
@@ -136,7 +138,7 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
         {
             for (const auto edge : facade.GetAdjacentEdgeRange(node))
             {
-                const EdgeData &data = facade.GetEdgeData(edge);
+                const SearchData &data = facade.GetSearchData(edge);
                 const bool reverse_flag = ((!forward_direction) ? data.forward : data.backward);
                 if (reverse_flag)
                 {
@@ -158,7 +160,7 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
 
         for (const auto edge : facade.GetAdjacentEdgeRange(node))
         {
-            const EdgeData &data = facade.GetEdgeData(edge);
+            const SearchData &data = facade.GetSearchData(edge);
             bool forward_directionFlag = (forward_direction ? data.forward : data.backward);
             if (forward_directionFlag)
             {
@@ -189,7 +191,7 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
         EdgeWeight loop_weight = INVALID_EDGE_WEIGHT;
         for (auto edge : facade.GetAdjacentEdgeRange(node))
         {
-            const auto &data = facade.GetEdgeData(edge);
+            const auto &data = facade.GetSearchData(edge);
             if (data.forward)
             {
                 const NodeID to = facade.GetTarget(edge);
@@ -243,9 +245,9 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
                         : facade.GetTravelModeForEdgeID(edge_data.id);
 
                 const auto geometry_index = facade.GetGeometryIndexForEdgeID(edge_data.id);
-                std::vector<NodeID> id_vector;
-                std::vector<EdgeWeight> weight_vector;
-                std::vector<DatasourceID> datasource_vector;
+                util::ArrayView<NodeID> id_vector;
+                util::ArrayView<EdgeWeight> weight_vector;
+                util::ArrayView<DatasourceID> datasource_vector;
                 if (geometry_index.forward)
                 {
                     id_vector = facade.GetUncompressedForwardGeometry(geometry_index.id);
@@ -305,9 +307,9 @@ template <class DataFacadeT, class Derived> class BasicRoutingInterface
             });
 
         std::size_t start_index = 0, end_index = 0;
-        std::vector<unsigned> id_vector;
-        std::vector<EdgeWeight> weight_vector;
-        std::vector<DatasourceID> datasource_vector;
+        util::ArrayView<NodeID> id_vector;
+        util::ArrayView<EdgeWeight> weight_vector;
+        util::ArrayView<DatasourceID> datasource_vector;
         const bool is_local_path = (phantom_node_pair.source_phantom.packed_geometry_id ==
                                     phantom_node_pair.target_phantom.packed_geometry_id) &&
                                    unpacked_path.empty();
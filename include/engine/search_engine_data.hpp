@@ -3,7 +3,10 @@
 
 #include <boost/thread/tss.hpp>
 
+#include <cstddef>
+
 #include "util/binary_heap.hpp"
+#include "util/search_heap.hpp"
 #include "util/typedefs.hpp"
 
 namespace osrm
@@ -20,9 +23,18 @@ struct HeapData
 struct SearchEngineData
 {
     using QueryHeap =
-        util::BinaryHeap<NodeID, NodeID, int, HeapData, util::UnorderedMapStorage<NodeID, int>>;
+        util::SearchHeap<NodeID, NodeID, int, HeapData, util::GenerationArrayStorage<NodeID, int>>;
     using SearchEngineHeapPtr = boost::thread_specific_ptr<QueryHeap>;
 
+    // A dense heap index takes 8 bytes per node and every thread keeps up to six heaps, 2^22
+    // nodes keep a single index at 32 MiB
+    static constexpr std::size_t DEFAULT_MAX_DENSE_HEAP_NODES = 1u << 22;
+
+    explicit SearchEngineData(const std::size_t max_dense_heap_nodes = DEFAULT_MAX_DENSE_HEAP_NODES)
+        : max_dense_heap_nodes(max_dense_heap_nodes)
+    {
+    }
+
     static SearchEngineHeapPtr forward_heap_1;
     static SearchEngineHeapPtr reverse_heap_1;
     static SearchEngineHeapPtr forward_heap_2;
@@ -35,6 +47,24 @@ struct SearchEngineData
     void InitializeOrClearSecondThreadLocalStorage(const unsigned number_of_nodes);
 
     void InitializeOrClearThirdThreadLocalStorage(const unsigned number_of_nodes);
+
+  private:
+    // Heaps for graphs with more nodes than this use a hash map instead of a dense array. The
+    // heaps of a thread are shared by all instances, a heap that was created for another graph
+    // size is replaced. A heap of the other storage kind is kept as a spare, so instances whose
+    // limits differ on the same graph do not reallocate each other's heaps.
+    const std::size_t max_dense_heap_nodes;
+
+    static SearchEngineHeapPtr spare_forward_heap_1;
+    static SearchEngineHeapPtr spare_reverse_heap_1;
+    static SearchEngineHeapPtr spare_forward_heap_2;
+    static SearchEngineHeapPtr spare_reverse_heap_2;
+    static SearchEngineHeapPtr spare_forward_heap_3;
+    static SearchEngineHeapPtr spare_reverse_heap_3;
+
+    void InitializeOrClearHeap(SearchEngineHeapPtr &heap,
+                               SearchEngineHeapPtr &spare_heap,
+                               const unsigned number_of_nodes) const;
 };
 }
 }
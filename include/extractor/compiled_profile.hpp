@@ -0,0 +1,71 @@
+#ifndef COMPILED_PROFILE_HPP
+#define COMPILED_PROFILE_HPP
+
+#include "extractor/guidance/turn_lane_types.hpp"
+#include "extractor/internal_extractor_edge.hpp"
+#include "extractor/profile_properties.hpp"
+#include "util/coordinate.hpp"
+
+#include <string>
+#include <vector>
+
+namespace osmium
+{
+class Node;
+class Way;
+}
+
+namespace osrm
+{
+namespace extractor
+{
+
+struct ExtractionNode;
+struct ExtractionWay;
+
+/**
+ * Interface of a profile that is compiled into a shared library instead of being written in lua.
+ * The hooks mirror the functions of a lua profile, hooks that are not overridden behave like a
+ * lua profile that does not define the function.
+ *
+ * The hooks are called concurrently from all extractor threads and must not modify shared state.
+ *
+ * The library makes the profile known with OSRM_COMPILED_PROFILE(ProfileClass).
+ */
+class CompiledProfile
+{
+  public:
+    virtual ~CompiledProfile() = default;
+
+    virtual ProfileProperties GetProfileProperties() const = 0;
+
+    virtual std::vector<std::string> GetNameSuffixList() const { return {}; }
+    virtual std::vector<std::string> GetRestrictions() const { return {}; }
+
+    virtual void ProcessNode(const osmium::Node &, ExtractionNode &) const {}
+    virtual void ProcessWay(const osmium::Way &, ExtractionWay &) const {}
+
+    // Turn penalty in deci-seconds for a turn angle in degrees, see turn_function
+    virtual double GetTurnPenalty(const double) const { return 0; }
+
+    virtual void ProcessSegment(const util::Coordinate &,
+                                const util::Coordinate &,
+                                const double,
+                                InternalExtractorEdge::WeightData &) const
+    {
+    }
+};
+
+// Name of the function exported by a compiled profile library that creates the profile
+const constexpr char *COMPILED_PROFILE_FACTORY = "osrm_create_compiled_profile";
+using CompiledProfileFactory = CompiledProfile *(*)();
+}
+}
+
+#define OSRM_COMPILED_PROFILE(ProfileClass)                                                        \
+    extern "C" osrm::extractor::CompiledProfile *osrm_create_compiled_profile()                   \
+    {                                                                                              \
+        return new ProfileClass();                                                                 \
+    }
+
+#endif // COMPILED_PROFILE_HPP
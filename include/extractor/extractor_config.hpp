@@ -70,6 +70,7 @@ struct ExtractorConfig
         edge_graph_output_path = basepath + ".osrm.ebg";
         rtree_nodes_output_path = basepath + ".osrm.ramIndex";
         rtree_leafs_output_path = basepath + ".osrm.fileIndex";
+        node_order_output_path = basepath + ".osrm.node_order";
         edge_segment_lookup_path = basepath + ".osrm.edge_segment_lookup";
         edge_penalty_path = basepath + ".osrm.edge_penalties";
         edge_based_node_weights_output_path = basepath + ".osrm.enw";
@@ -77,6 +78,13 @@ struct ExtractorConfig
         intersection_class_data_output_path = basepath + ".osrm.icd";
     }
 
+    // Profiles in a shared library are compiled profiles, all others are lua scripts
+    bool IsCompiledProfile() const
+    {
+        const auto extension = profile_path.extension().string();
+        return extension == ".so" || extension == ".dylib";
+    }
+
     boost::filesystem::path input_path;
     boost::filesystem::path profile_path;
 
@@ -93,6 +101,7 @@ struct ExtractorConfig
     std::string node_output_path;
     std::string rtree_nodes_output_path;
     std::string rtree_leafs_output_path;
+    std::string node_order_output_path;
     std::string profile_properties_output_path;
     std::string intersection_class_data_output_path;
 
@@ -58,13 +58,24 @@ class ScriptingEnvironment
                                 const osrm::util::Coordinate &target,
                                 double distance,
                                 InternalExtractorEdge::WeightData &weight) = 0;
-    virtual void
+    // Batched version of GetTurnPenalty that looks up the profile function only once for all
+    // angles
+    virtual std::vector<int32_t> GetTurnPenalties(const std::vector<double> &angles) = 0;
+
+    // Processes the elements in parallel with ProcessNode, ProcessWay and the restriction parser,
+    // the results are stored with the index of their element
+    void
     ProcessElements(const std::vector<osmium::memory::Buffer::const_iterator> &osm_elements,
                     const RestrictionParser &restriction_parser,
                     tbb::concurrent_vector<std::pair<std::size_t, ExtractionNode>> &resulting_nodes,
                     tbb::concurrent_vector<std::pair<std::size_t, ExtractionWay>> &resulting_ways,
                     tbb::concurrent_vector<boost::optional<InputRestrictionContainer>>
-                        &resulting_restrictions) = 0;
+                        &resulting_restrictions);
+
+  protected:
+    // Called concurrently from the worker threads of ProcessElements with a cleared result
+    virtual void ProcessNode(const osmium::Node &node, ExtractionNode &result) = 0;
+    virtual void ProcessWay(const osmium::Way &way, ExtractionWay &result) = 0;
 };
 }
 }
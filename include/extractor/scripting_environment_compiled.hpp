@@ -0,0 +1,50 @@
+#ifndef SCRIPTING_ENVIRONMENT_COMPILED_HPP
+#define SCRIPTING_ENVIRONMENT_COMPILED_HPP
+
+#include "extractor/compiled_profile.hpp"
+#include "extractor/scripting_environment.hpp"
+
+#include <memory>
+#include <string>
+
+namespace osrm
+{
+namespace extractor
+{
+
+/**
+ * Loads a profile from a shared library that implements CompiledProfile and calls its hooks
+ * directly, which avoids the cost of calling into lua for every way and node.
+ *
+ * The profile is shared by all threads.
+ */
+class CompiledScriptingEnvironment final : public ScriptingEnvironment
+{
+  public:
+    explicit CompiledScriptingEnvironment(const std::string &file_name);
+    ~CompiledScriptingEnvironment() override;
+
+    const ProfileProperties &GetProfileProperties() override;
+
+    std::vector<std::string> GetNameSuffixList() override;
+    std::vector<std::string> GetRestrictions() override;
+    void SetupSources() override;
+    int32_t GetTurnPenalty(double angle) override;
+    void ProcessSegment(const osrm::util::Coordinate &source,
+                        const osrm::util::Coordinate &target,
+                        double distance,
+                        InternalExtractorEdge::WeightData &weight) override;
+    std::vector<int32_t> GetTurnPenalties(const std::vector<double> &angles) override;
+
+  private:
+    void ProcessNode(const osmium::Node &node, ExtractionNode &result) override;
+    void ProcessWay(const osmium::Way &way, ExtractionWay &result) override;
+
+    void *library_handle;
+    std::unique_ptr<CompiledProfile> profile;
+    ProfileProperties properties;
+};
+}
+}
+
+#endif /* SCRIPTING_ENVIRONMENT_COMPILED_HPP */
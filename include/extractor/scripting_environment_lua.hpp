@@ -30,6 +30,7 @@ struct LuaScriptingContext final
     util::LuaState state;
 
     bool has_turn_penalty_function;
+    bool has_turn_penalties_function;
     bool has_node_function;
     bool has_way_function;
     bool has_segment_function;
@@ -40,7 +41,8 @@ struct LuaScriptingContext final
  * ExtractionWay and ExtractionNode to lua objects.
  *
  * Each thread has its own lua state which is implemented with thread specific
- * storage from TBB.
+ * storage from TBB. A state is created and loads the profile the first time a thread asks for
+ * it, only this initialization is serialized.
  */
 class LuaScriptingEnvironment final : public ScriptingEnvironment
 {
@@ -60,15 +62,12 @@ class LuaScriptingEnvironment final : public ScriptingEnvironment
                         const osrm::util::Coordinate &target,
                         double distance,
                         InternalExtractorEdge::WeightData &weight) override;
-    void
-    ProcessElements(const std::vector<osmium::memory::Buffer::const_iterator> &osm_elements,
-                    const RestrictionParser &restriction_parser,
-                    tbb::concurrent_vector<std::pair<std::size_t, ExtractionNode>> &resulting_nodes,
-                    tbb::concurrent_vector<std::pair<std::size_t, ExtractionWay>> &resulting_ways,
-                    tbb::concurrent_vector<boost::optional<InputRestrictionContainer>>
-                        &resulting_restrictions) override;
+    std::vector<int32_t> GetTurnPenalties(const std::vector<double> &angles) override;
 
   private:
+    void ProcessNode(const osmium::Node &node, ExtractionNode &result) override;
+    void ProcessWay(const osmium::Way &way, ExtractionWay &result) override;
+
     void InitContext(LuaScriptingContext &context);
     std::mutex init_mutex;
     std::string file_name;
@@ -33,6 +33,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -85,6 +86,15 @@ class OSRM final
      */
     Status Route(const RouteParameters &parameters, json::Object &result) const;
 
+    /**
+     * Shortest path queries for coordinates, written in the packed binary format.
+     *
+     * \param parameters route query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, RouteParameters and util::binary::Writer
+     */
+    Status Route(const RouteParameters &parameters, util::binary::Writer &result) const;
+
     /**
      * Distance tables for coordinates.
      *
@@ -94,6 +104,26 @@ class OSRM final
      */
     Status Table(const TableParameters &parameters, json::Object &result) const;
 
+    /**
+     * Distance tables for coordinates, streamed into a buffer as JSON.
+     *
+     * Faster than building the json::Object for large tables.
+     *
+     * \param parameters table query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, TableParameters and json::Writer
+     */
+    Status Table(const TableParameters &parameters, json::Writer &result) const;
+
+    /**
+     * Distance tables for coordinates, written in the packed binary format.
+     *
+     * \param parameters table query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, TableParameters and util::binary::Writer
+     */
+    Status Table(const TableParameters &parameters, util::binary::Writer &result) const;
+
     /**
      * Nearest street segment for coordinate.
      *
@@ -121,6 +151,18 @@ class OSRM final
      */
     Status Match(const MatchParameters &parameters, json::Object &result) const;
 
+    /**
+     * Match: snaps a batch of noisy coordinate traces to the road network
+     *
+     * The traces are matched concurrently, results[i] is the response for parameters[i].
+     *
+     * \param parameters match query specific parameters of every trace
+     * \return Status::Ok if every trace was matched, Status::Error if any one failed
+     * \see Status, MatchParameters and json::Object
+     */
+    Status Match(const std::vector<MatchParameters> &parameters,
+                 std::vector<json::Object> &results) const;
+
     /**
      * Tile: vector tiles with internal graph representation
      *
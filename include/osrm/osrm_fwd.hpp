@@ -29,7 +29,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define OSRM_FWD_HPP
 
 // OSRM API forward declarations for usage in interfaces. Exposes forward declarations for:
-// osrm::util::json::Object, osrm::engine::api::XParameters
+// osrm::util::json::Object, osrm::util::json::Writer, osrm::util::binary::Writer,
+// osrm::engine::api::XParameters
 
 namespace osrm
 {
@@ -39,7 +40,13 @@ namespace util
 namespace json
 {
 struct Object;
+class Writer;
 } // ns json
+
+namespace binary
+{
+class Writer;
+} // ns binary
 } // ns util
 
 namespace engine
@@ -146,11 +146,20 @@ struct BaseParametersGrammar : boost::spirit::qi::grammar<Iterator, Signature>
             (-(qi::short_ > ',' > qi::short_))[ph::bind(add_bearing, qi::_r1, qi::_1)] % ';';
 
         base_rule = radiuses_rule(qi::_r1) | hints_rule(qi::_r1) | bearings_rule(qi::_r1);
+
+        format_type.add("json", engine::api::BaseParameters::OutputFormatType::JSON)(
+            "binary", engine::api::BaseParameters::OutputFormatType::Binary);
+
+        // not part of base_rule, only services that can write a binary response accept it
+        format_rule =
+            qi::lit("format=") >
+            format_type[ph::bind(&engine::api::BaseParameters::format, qi::_r1) = qi::_1];
     }
 
   protected:
     qi::rule<Iterator, Signature> base_rule;
     qi::rule<Iterator, Signature> query_rule;
+    qi::rule<Iterator, Signature> format_rule;
 
   private:
     qi::rule<Iterator, Signature> bearings_rule;
@@ -165,6 +174,8 @@ struct BaseParametersGrammar : boost::spirit::qi::grammar<Iterator, Signature>
     qi::rule<Iterator, std::string()> polyline_chars;
     qi::rule<Iterator, double()> unlimited_rule;
     qi::real_parser<double, json_policy> double_;
+
+    qi::symbols<char, engine::api::BaseParameters::OutputFormatType> format_type;
 };
 }
 }
@@ -34,7 +34,8 @@ struct RouteParametersGrammar : public BaseParametersGrammar<Iterator, Signature
             (qi::lit("continue_straight=") >
              (qi::lit("default") |
               qi::bool_[ph::bind(&engine::api::RouteParameters::continue_straight, qi::_r1) =
-                            qi::_1]));
+                            qi::_1])) |
+            BaseGrammar::format_rule(qi::_r1);
 
         root_rule = query_rule(qi::_r1) > -qi::lit(".json") >
                     -('?' > (route_rule(qi::_r1) | base_rule(qi::_r1)) % '&');
@@ -32,12 +32,19 @@ namespace server
 {
 
 class RequestHandler;
+class WorkerPool;
 
 /// Represents a single connection from a client.
 class Connection : public std::enable_shared_from_this<Connection>
 {
   public:
-    explicit Connection(boost::asio::io_service &io_service, RequestHandler &handler);
+    // keepalive_timeout is the time in seconds an idle connection is kept open for further
+    // requests, at most keepalive_max_requests are served on a single connection
+    explicit Connection(boost::asio::io_service &io_service,
+                        RequestHandler &handler,
+                        WorkerPool &worker_pool,
+                        const int keepalive_timeout,
+                        const int keepalive_max_requests);
     Connection(const Connection &) = delete;
     Connection &operator=(const Connection &) = delete;
 
@@ -47,19 +54,44 @@ class Connection : public std::enable_shared_from_this<Connection>
     void start();
 
   private:
+    /// Reads the next chunk of the request, closing the connection if it stays idle
+    void read();
+
     void handle_read(const boost::system::error_code &e, std::size_t bytes_transferred);
 
+    /// Parses the request in [begin, end) and hands it to the worker pool, further pipelined
+    /// requests are kept
+    void handle_data(char *begin, char *end);
+
+    /// Runs on a worker thread: computes and compresses the reply
+    void handle_request(const http::compression_type compression_type);
+
+    /// Starts writing the reply that is stored in output_buffer
+    void write_reply();
+
     /// Handle completion of a write operation.
     void handle_write(const boost::system::error_code &e);
 
+    /// Closes an idle keep-alive connection
+    void handle_timeout(const boost::system::error_code &e);
+
     std::vector<char> compress_buffers(const std::vector<char> &uncompressed_data,
                                        const http::compression_type compression_type);
 
     boost::asio::io_service::strand strand;
     boost::asio::ip::tcp::socket TCP_socket;
+    boost::asio::deadline_timer timer;
     RequestHandler &request_handler;
+    WorkerPool &worker_pool;
+    const int keepalive_timeout;
+    const int keepalive_max_requests;
+    int processed_requests;
+    bool keep_alive;
     RequestParser request_parser;
     boost::array<char, 8192> incoming_data_buffer;
+    // received but not yet parsed part of incoming_data_buffer (pipelined requests)
+    char *unparsed_begin;
+    char *unparsed_end;
     http::request current_request;
     http::reply current_reply;
     std::vector<char> compressed_output;
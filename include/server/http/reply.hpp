@@ -21,7 +21,8 @@ class reply
     {
         ok = 200,
         bad_request = 400,
-        internal_server_error = 500
+        internal_server_error = 500,
+        service_unavailable = 503
     } status;
 
     std::vector<header> headers;
@@ -31,12 +32,17 @@ class reply
     static reply stock_reply(const status_type status);
     void set_size(const std::size_t size);
     void set_uncompressed_size();
+    void set_keep_alive(const bool keep_alive);
+    // Replies with the version of the request, HTTP/1.1 for all later versions
+    void set_http_version(const unsigned major, const unsigned minor);
 
     reply();
 
   private:
     std::string status_to_string(reply::status_type status);
     boost::asio::const_buffer status_to_buffer(reply::status_type status);
+
+    bool http_1_1;
 };
 }
 }
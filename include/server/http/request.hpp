@@ -18,6 +18,10 @@ struct request
     std::string referrer;
     std::string agent;
     boost::asio::ip::address endpoint;
+    // whether the client wants to reuse the connection for further requests
+    bool keep_alive = false;
+    unsigned http_version_major = 1;
+    unsigned http_version_minor = 0;
 };
 }
 }
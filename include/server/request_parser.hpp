@@ -28,9 +28,14 @@ class RequestParser
         indeterminate
     };
 
-    std::tuple<RequestStatus, http::compression_type>
+    // Parses at most one request from [begin, end). The returned pointer marks the first
+    // character that was not consumed, with pipelining it is the start of the next request.
+    std::tuple<RequestStatus, http::compression_type, char *>
     parse(http::request &current_request, char *begin, char *end);
 
+    // Prepares the parser for the next request on the same connection
+    void reset();
+
   private:
     RequestStatus consume(http::request &current_request, const char input);
 
@@ -69,6 +74,8 @@ class RequestParser
 
     http::header current_header;
     http::compression_type selected_compression;
+    unsigned http_version_major;
+    unsigned http_version_minor;
 };
 }
 }
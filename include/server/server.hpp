@@ -4,6 +4,7 @@
 #include "server/connection.hpp"
 #include "server/request_handler.hpp"
 #include "server/service_handler.hpp"
+#include "server/worker_pool.hpp"
 
 #include "util/integer_range.hpp"
 #include "util/simple_logger.hpp"
@@ -33,19 +34,51 @@ class Server
 {
   public:
     // Note: returns a shared instead of a unique ptr as it is captured in a lambda somewhere else
-    static std::shared_ptr<Server>
-    CreateServer(std::string &ip_address, int ip_port, unsigned requested_num_threads)
+    //
+    // requested_num_threads is the number of threads computing queries, socket I/O is done by
+    // separate requested_io_threads threads.
+    static std::shared_ptr<Server> CreateServer(std::string &ip_address,
+                                                int ip_port,
+                                                unsigned requested_num_threads,
+                                                unsigned requested_io_threads,
+                                                int keepalive_timeout,
+                                                int keepalive_max_requests,
+                                                int max_queue_size,
+                                                const WorkerPool::ServiceLimits &service_limits)
     {
         util::SimpleLogger().Write() << "http 1.1 compression handled by zlib version "
                                      << zlibVersion();
         const unsigned hardware_threads = std::max(1u, std::thread::hardware_concurrency());
-        const unsigned real_num_threads = std::min(hardware_threads, requested_num_threads);
-        return std::make_shared<Server>(ip_address, ip_port, real_num_threads);
+        const unsigned real_num_threads =
+            std::max(1u, std::min(hardware_threads, requested_num_threads));
+        const unsigned real_io_threads =
+            std::max(1u, std::min(hardware_threads, requested_io_threads));
+        return std::make_shared<Server>(ip_address,
+                                        ip_port,
+                                        real_io_threads,
+                                        keepalive_timeout,
+                                        keepalive_max_requests,
+                                        real_num_threads,
+                                        max_queue_size,
+                                        service_limits);
     }
 
-    explicit Server(const std::string &address, const int port, const unsigned thread_pool_size)
-        : thread_pool_size(thread_pool_size), acceptor(io_service),
-          new_connection(std::make_shared<Connection>(io_service, request_handler))
+    explicit Server(const std::string &address,
+                    const int port,
+                    const unsigned thread_pool_size,
+                    const int keepalive_timeout,
+                    const int keepalive_max_requests,
+                    const unsigned worker_pool_size,
+                    const int max_queue_size,
+                    const WorkerPool::ServiceLimits &service_limits)
+        : thread_pool_size(thread_pool_size), keepalive_timeout(keepalive_timeout),
+          keepalive_max_requests(keepalive_max_requests), acceptor(io_service),
+          new_connection(std::make_shared<Connection>(io_service,
+                                                      request_handler,
+                                                      worker_pool,
+                                                      keepalive_timeout,
+                                                      keepalive_max_requests)),
+          worker_pool(worker_pool_size, max_queue_size, service_limits)
     {
         const auto port_string = std::to_string(port);
 
@@ -84,7 +117,11 @@ class Server
         }
     }
 
-    void Stop() { io_service.stop(); }
+    void Stop()
+    {
+        io_service.stop();
+        worker_pool.Stop();
+    }
 
     void RegisterServiceHandler(std::unique_ptr<ServiceHandler> service_handler_)
     {
@@ -97,7 +134,11 @@ class Server
         if (!e)
         {
             new_connection->start();
-            new_connection = std::make_shared<Connection>(io_service, request_handler);
+            new_connection = std::make_shared<Connection>(io_service,
+                                                          request_handler,
+                                                          worker_pool,
+                                                          keepalive_timeout,
+                                                          keepalive_max_requests);
             acceptor.async_accept(
                 new_connection->socket(),
                 boost::bind(&Server::HandleAccept, this, boost::asio::placeholders::error));
@@ -105,10 +146,14 @@ class Server
     }
 
     unsigned thread_pool_size;
+    int keepalive_timeout;
+    int keepalive_max_requests;
     boost::asio::io_service io_service;
     boost::asio::ip::tcp::acceptor acceptor;
     std::shared_ptr<Connection> new_connection;
     RequestHandler request_handler;
+    // destroyed first, running queries still use the request handler and the io_service
+    WorkerPool worker_pool;
 };
 }
 }
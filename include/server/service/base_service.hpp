@@ -20,7 +20,8 @@ namespace service
 class BaseService
 {
   public:
-    using ResultT = mapbox::util::variant<util::json::Object, std::string>;
+    // a json::Object, a protobuf vector tile or JSON streamed with json::Writer
+    using ResultT = mapbox::util::variant<util::json::Object, std::string, std::vector<char>>;
 
     BaseService(OSRM &routing_machine) : routing_machine(routing_machine) {}
     virtual ~BaseService() = default;
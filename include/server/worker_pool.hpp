@@ -0,0 +1,82 @@
+#ifndef WORKER_POOL_HPP
+#define WORKER_POOL_HPP
+
+#include <boost/asio.hpp>
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+
+/// Runs queries on a set of threads separate from the ones doing socket I/O.
+///
+/// Admission is bounded: if max_queue_size requests are already queued or running, new requests
+/// are rejected so the caller can shed load instead of letting the backlog grow. A service with a
+/// concurrency limit runs at most that many requests at a time, further requests of the service
+/// wait in its own queue until one of them finishes. That queue holds at most max_queue_size
+/// requests and does not count towards the global bound, so limiting expensive services (e.g.
+/// table or match) keeps both workers and queue slots available for cheap ones.
+class WorkerPool
+{
+  public:
+    using ServiceLimits = std::unordered_map<std::string, int>;
+
+    /// max_queue_size and the service limits use -1 for unlimited, a service limit of 0 rejects
+    /// all requests of the service
+    WorkerPool(const unsigned num_threads,
+               const int max_queue_size,
+               const ServiceLimits &service_limits);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    /// Queues task for execution on a worker thread. Returns false without running the task if
+    /// the queue or the queue of the service is full, the service is disabled or the pool is
+    /// stopped.
+    bool TryPost(const std::string &service, std::function<void()> task);
+
+    /// Rejects new tasks and waits until all queued tasks have run
+    void Stop();
+
+  private:
+    struct ServiceQueue
+    {
+        explicit ServiceQueue(const int limit) : limit(limit), running(0) {}
+
+        const int limit;
+        int running;
+        // waiting for one of the running tasks of the service to finish
+        std::deque<std::function<void()>> waiting;
+    };
+
+    // needs to hold mutex
+    void Post(ServiceQueue *service_queue, std::function<void()> task);
+    // runs after each task, starts the next waiting task of its service
+    void Finish(ServiceQueue *service_queue);
+
+    boost::asio::io_service io_service;
+    std::unique_ptr<boost::asio::io_service::work> work;
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    bool stopped;
+    const int max_queue_size;
+    // queued or running, without the tasks waiting for their service
+    int queue_size;
+    // the set of services is fixed after construction, the queues are guarded by mutex
+    std::unordered_map<std::string, ServiceQueue> service_queues;
+};
+}
+}
+
+#endif // WORKER_POOL_HPP
@@ -11,7 +11,9 @@
 
 #include <boost/filesystem/fstream.hpp>
 
+#include <algorithm>
 #include <tuple>
+#include <vector>
 
 namespace osrm
 {
@@ -78,18 +80,36 @@ inline HSGRHeader readHSGRHeader(boost::filesystem::ifstream &input_stream)
 
 // Reads the graph data of a `.hsgr` file into memory
 // Needs to be called after readHSGRHeader() to get the correct offset in the stream
-using NodeT = typename util::StaticGraph<contractor::QueryEdge::EdgeData>::NodeArrayEntry;
-using EdgeT = typename util::StaticGraph<contractor::QueryEdge::EdgeData>::EdgeArrayEntry;
+// The edges are split into the search graph and the parallel array of their unpack data.
+using NodeT = typename util::StaticGraph<contractor::QueryEdge::SearchData>::NodeArrayEntry;
+using EdgeT = typename util::StaticGraph<contractor::QueryEdge::SearchData>::EdgeArrayEntry;
+using EdgeUnpackT = contractor::QueryEdge::UnpackData;
 inline void readHSGR(boost::filesystem::ifstream &input_stream,
                      NodeT *node_buffer,
                      const std::uint64_t number_of_nodes,
                      EdgeT *edge_buffer,
+                     EdgeUnpackT *edge_unpack_buffer,
                      const std::uint64_t number_of_edges)
 {
     BOOST_ASSERT(node_buffer);
-    BOOST_ASSERT(edge_buffer);
+    BOOST_ASSERT(number_of_edges == 0 || (edge_buffer && edge_unpack_buffer));
     input_stream.read(reinterpret_cast<char *>(node_buffer), number_of_nodes * sizeof(NodeT));
-    input_stream.read(reinterpret_cast<char *>(edge_buffer), number_of_edges * sizeof(EdgeT));
+
+    // the file stores the complete EdgeData of every edge
+    using FileEdgeT = util::StaticGraph<contractor::QueryEdge::EdgeData>::EdgeArrayEntry;
+    const constexpr std::uint64_t BATCH_SIZE = 64 * 1024;
+    std::vector<FileEdgeT> batch(std::min(BATCH_SIZE, number_of_edges));
+    for (std::uint64_t first = 0; first < number_of_edges; first += BATCH_SIZE)
+    {
+        const auto count = std::min(BATCH_SIZE, number_of_edges - first);
+        input_stream.read(reinterpret_cast<char *>(batch.data()), count * sizeof(FileEdgeT));
+        for (std::uint64_t index = 0; index < count; ++index)
+        {
+            edge_buffer[first + index].target = batch[index].target;
+            edge_buffer[first + index].data = batch[index].data;
+            edge_unpack_buffer[first + index] = batch[index].data;
+        }
+    }
 }
 
 // Loads properties from a `.properties` file into memory
@@ -23,6 +23,7 @@ const constexpr char *block_id_to_name[] = {"NAME_OFFSETS",
                                             "VIA_NODE_LIST",
                                             "GRAPH_NODE_LIST",
                                             "GRAPH_EDGE_LIST",
+                                            "GRAPH_EDGE_UNPACK_LIST",
                                             "COORDINATE_LIST",
                                             "OSM_NODE_ID_LIST",
                                             "TURN_INSTRUCTION",
@@ -52,7 +53,8 @@ const constexpr char *block_id_to_name[] = {"NAME_OFFSETS",
                                             "POST_TURN_BEARING",
                                             "TURN_LANE_DATA",
                                             "LANE_DESCRIPTION_OFFSETS",
-                                            "LANE_DESCRIPTION_MASKS"};
+                                            "LANE_DESCRIPTION_MASKS",
+                                            "R_SEARCH_LEAVES"};
 
 struct SharedDataLayout
 {
@@ -65,6 +67,7 @@ struct SharedDataLayout
         VIA_NODE_LIST,
         GRAPH_NODE_LIST,
         GRAPH_EDGE_LIST,
+        GRAPH_EDGE_UNPACK_LIST,
         COORDINATE_LIST,
         OSM_NODE_ID_LIST,
         TURN_INSTRUCTION,
@@ -95,6 +98,7 @@ struct SharedDataLayout
         TURN_LANE_DATA,
         LANE_DESCRIPTION_OFFSETS,
         LANE_DESCRIPTION_MASKS,
+        R_SEARCH_LEAVES,
         NUM_BLOCKS
     };
 
@@ -171,6 +175,16 @@ struct SharedDataLayout
 
         return ptr;
     }
+
+    // Blocks are only aligned to 4 bytes. Blocks of types with a larger alignment reserve
+    // alignof(T) - 1 additional bytes and start at the next aligned address.
+    template <typename T, bool WRITE_CANARY = false>
+    inline T *GetAlignedBlockPtr(char *shared_memory, BlockID bid)
+    {
+        const auto address =
+            reinterpret_cast<std::uintptr_t>(GetBlockPtr<char, WRITE_CANARY>(shared_memory, bid));
+        return reinterpret_cast<T *>((address + alignof(T) - 1) & ~(alignof(T) - 1));
+    }
 };
 
 enum SharedDataType
@@ -41,7 +41,9 @@ namespace storage
 class Storage
 {
   public:
-    Storage(StorageConfig config);
+    // With load_rtree_leaves the leaves of the R-tree are copied into shared memory, otherwise
+    // every osrm-routed maps the leaf file.
+    Storage(StorageConfig config, bool load_rtree_leaves = false);
 
     enum ReturnCode
     {
@@ -54,6 +56,7 @@ class Storage
 
   private:
     StorageConfig config;
+    bool load_rtree_leaves;
 };
 }
 }
@@ -0,0 +1,131 @@
+#ifndef ARRAY_VIEW_HPP
+#define ARRAY_VIEW_HPP
+
+#include <boost/assert.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <cstddef>
+#include <iterator>
+
+namespace osrm
+{
+namespace util
+{
+
+// Random access iterator over a contiguous array that moves by a fixed stride. A stride of -1
+// walks the array backwards, a stride of 0 repeats the same element.
+template <typename DataT>
+class StridedIterator : public boost::iterator_facade<StridedIterator<DataT>,
+                                                      const DataT,
+                                                      std::random_access_iterator_tag>
+{
+  public:
+    StridedIterator() : ptr(nullptr), index(0), stride(1) {}
+    StridedIterator(const DataT *ptr_, const std::ptrdiff_t index_, const std::ptrdiff_t stride_)
+        : ptr(ptr_), index(index_), stride(stride_)
+    {
+    }
+
+  private:
+    friend class boost::iterator_core_access;
+
+    const DataT &dereference() const { return ptr[index * stride]; }
+
+    bool equal(const StridedIterator &other) const { return index == other.index; }
+
+    void increment() { ++index; }
+
+    void decrement() { --index; }
+
+    void advance(const std::ptrdiff_t n) { index += n; }
+
+    std::ptrdiff_t distance_to(const StridedIterator &other) const { return other.index - index; }
+
+    const DataT *ptr;
+    std::ptrdiff_t index;
+    std::ptrdiff_t stride;
+};
+
+/**
+ * Read-only view of a slice of an array that is not owned by the view, e.g. the geometry arrays
+ * of the data facades that may live in shared memory. Copying a view is as cheap as copying a
+ * pointer, so it is returned by value instead of a std::vector with a copy of the data.
+ *
+ * The slice is either read in storage order, in reverse or as the same value repeated size
+ * times, which is how missing per-segment data is represented without allocating.
+ */
+template <typename DataT> class ArrayView
+{
+  public:
+    using value_type = DataT;
+    using const_iterator = StridedIterator<DataT>;
+    using iterator = const_iterator;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    ArrayView() : first(nullptr), length(0), stride(1) {}
+
+    // Elements [begin, end) of data in storage order
+    static ArrayView Forward(const DataT *data, const std::size_t begin, const std::size_t end)
+    {
+        BOOST_ASSERT(begin <= end);
+        return ArrayView(data + begin, end - begin, 1);
+    }
+
+    // Elements [begin, end) of data starting from end - 1
+    static ArrayView Reverse(const DataT *data, const std::size_t begin, const std::size_t end)
+    {
+        BOOST_ASSERT(begin <= end);
+        if (begin == end)
+            return ArrayView();
+        return ArrayView(data + end - 1, end - begin, -1);
+    }
+
+    // The element referenced by value repeated count times
+    static ArrayView Repeat(const DataT &value, const std::size_t count)
+    {
+        return ArrayView(&value, count, 0);
+    }
+
+    ArrayView Reversed() const
+    {
+        if (length == 0)
+            return *this;
+        return ArrayView(first + (static_cast<std::ptrdiff_t>(length) - 1) * stride,
+                         length,
+                         -stride);
+    }
+
+    const_iterator begin() const { return const_iterator(first, 0, stride); }
+    const_iterator end() const
+    {
+        return const_iterator(first, static_cast<std::ptrdiff_t>(length), stride);
+    }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    std::size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+
+    const DataT &operator[](const std::size_t index) const
+    {
+        BOOST_ASSERT(index < length);
+        return first[static_cast<std::ptrdiff_t>(index) * stride];
+    }
+
+    const DataT &front() const { return (*this)[0]; }
+    const DataT &back() const { return (*this)[length - 1]; }
+
+  private:
+    ArrayView(const DataT *first_, const std::size_t length_, const std::ptrdiff_t stride_)
+        : first(first_), length(length_), stride(stride_)
+    {
+    }
+
+    const DataT *first;
+    std::size_t length;
+    std::ptrdiff_t stride;
+};
+}
+}
+
+#endif // ARRAY_VIEW_HPP
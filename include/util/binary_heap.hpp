@@ -4,10 +4,12 @@
 #include <boost/assert.hpp>
 
 #include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <map>
 #include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -84,6 +86,100 @@ template <typename NodeID, typename Key> class UnorderedMapStorage
     std::unordered_map<NodeID, Key> nodes;
 };
 
+// Dense array indexed by node id, lookups are a single array access. Every cell carries the time
+// stamp of the search that wrote it, so Clear() only advances the current time stamp instead of
+// touching the array. Graphs with more than max_dense_size nodes fall back to a hash map to keep
+// the memory use of the per-thread heaps bounded.
+template <typename NodeID, typename Key> class GenerationArrayStorage
+{
+  public:
+    explicit GenerationArrayStorage(size_t size,
+                                    size_t max_dense_size = std::numeric_limits<size_t>::max())
+        : use_dense_storage(size <= max_dense_size), positions(use_dense_storage ? size : 0),
+          sparse_positions(0), current_timestamp{1u}
+    {
+    }
+
+    Key &operator[](const NodeID node)
+    {
+        if (!use_dense_storage)
+        {
+            return sparse_positions[node];
+        }
+
+        // the graph may have grown since the storage was sized, e.g. after a dataset swap
+        if (node >= positions.size())
+        {
+            positions.resize(node + 1);
+        }
+
+        auto &cell = positions[node];
+        if (cell.time != current_timestamp)
+        {
+            cell.time = current_timestamp;
+            cell.key = std::numeric_limits<Key>::max();
+        }
+        return cell.key;
+    }
+
+    Key peek_index(const NodeID node) const
+    {
+        if (!use_dense_storage)
+        {
+            return sparse_positions.peek_index(node);
+        }
+
+        if (node < positions.size() && positions[node].time == current_timestamp)
+        {
+            return positions[node].key;
+        }
+        return std::numeric_limits<Key>::max();
+    }
+
+    bool IsDense() const { return use_dense_storage; }
+
+    // Whether the storage is what a new storage for size nodes with the given limit would be.
+    // Dense storages need to match the size, so they neither waste memory on a smaller graph
+    // nor grow past the limit on a larger one.
+    bool Fits(const size_t size, const size_t max_dense_size) const
+    {
+        if (!use_dense_storage)
+        {
+            return size > max_dense_size;
+        }
+        return size <= max_dense_size && positions.size() == size;
+    }
+
+    void Clear()
+    {
+        if (!use_dense_storage)
+        {
+            sparse_positions.Clear();
+            return;
+        }
+
+        ++current_timestamp;
+        if (0 == current_timestamp)
+        {
+            // cells of a previous wrap around could be mistaken for current ones
+            std::fill(positions.begin(), positions.end(), Cell());
+            current_timestamp = 1u;
+        }
+    }
+
+  private:
+    struct Cell
+    {
+        Key key = std::numeric_limits<Key>::max();
+        std::uint32_t time = 0u;
+    };
+
+    bool use_dense_storage;
+    std::vector<Cell> positions;
+    UnorderedMapStorage<NodeID, Key> sparse_positions;
+    std::uint32_t current_timestamp;
+};
+
 template <typename NodeID,
           typename Key,
           typename Weight,
@@ -99,7 +195,13 @@ class BinaryHeap
     using WeightType = Weight;
     using DataType = Data;
 
-    explicit BinaryHeap(size_t maxID) : node_index(maxID) { Clear(); }
+    // additional arguments are forwarded to the index storage
+    template <typename... StorageArgs>
+    explicit BinaryHeap(size_t maxID, StorageArgs &&... storage_args)
+        : node_index(maxID, std::forward<StorageArgs>(storage_args)...)
+    {
+        Clear();
+    }
 
     void Clear()
     {
@@ -111,6 +213,8 @@ class BinaryHeap
 
     std::size_t Size() const { return (heap.size() - 1); }
 
+    const IndexStorage &GetIndexStorage() const { return node_index; }
+
     bool Empty() const { return 0 == Size(); }
 
     void Insert(NodeID node, Weight weight, const Data &data)
@@ -0,0 +1,90 @@
+#ifndef BINARY_WRITER_HPP
+#define BINARY_WRITER_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace osrm
+{
+namespace util
+{
+namespace binary
+{
+
+// Identifies the binary responses, see docs/http.md for the layout
+constexpr const char MAGIC[] = {'O', 'S', 'R', 'M'};
+constexpr const std::uint32_t VERSION = 1;
+
+/**
+ * Writes a packed little-endian buffer.
+ *
+ * Scalars are written without any padding. Arrays are prefixed with their length and aligned
+ * to the size of their elements relative to the start of the buffer, so a client can read them
+ * in place without copying. Strings are prefixed with their length in bytes.
+ */
+class Writer
+{
+  public:
+    explicit Writer(std::string &out_) : out(out_) {}
+
+    void Header()
+    {
+        out.append(MAGIC, sizeof(MAGIC));
+        UInt32(VERSION);
+    }
+
+    void UInt32(const std::uint32_t value) { Append(value); }
+
+    void Int32(const std::int32_t value) { Append(static_cast<std::uint32_t>(value)); }
+
+    void Double(const double value)
+    {
+        static_assert(sizeof(double) == sizeof(std::uint64_t), "double is not 64 bit");
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        Append(bits);
+    }
+
+    void String(const std::string &value)
+    {
+        UInt32(static_cast<std::uint32_t>(value.size()));
+        out.append(value);
+    }
+
+    // Writes the element count followed by the padding and the elements. The caller writes
+    // exactly count values with Int32 afterwards.
+    void StartInt32Array(const std::size_t count)
+    {
+        UInt32(static_cast<std::uint32_t>(count));
+        Align(sizeof(std::int32_t));
+        out.reserve(out.size() + count * sizeof(std::int32_t));
+    }
+
+  private:
+    template <typename T> void Append(const T value)
+    {
+        char bytes[sizeof(T)];
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+        }
+        out.append(bytes, sizeof(T));
+    }
+
+    void Align(const std::size_t alignment)
+    {
+        const auto remainder = out.size() % alignment;
+        if (remainder != 0)
+        {
+            out.append(alignment - remainder, '\0');
+        }
+    }
+
+    std::string &out;
+};
+}
+}
+}
+
+#endif // BINARY_WRITER_HPP
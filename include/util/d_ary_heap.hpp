@@ -0,0 +1,257 @@
+#ifndef D_ARY_HEAP_HPP
+#define D_ARY_HEAP_HPP
+
+#include "util/binary_heap.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/cache_aligned_allocator.h>
+
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+// Drop-in replacement for BinaryHeap with Arity children per node. A higher arity makes the heap
+// shallower, so DecreaseKey and Insert touch fewer levels, at the cost of more comparisons in
+// DeleteMin. The root is placed at position Arity - 1, so that all children of a node start at a
+// multiple of Arity and, with a cache aligned base address, share a single cache line.
+template <typename NodeID,
+          typename Key,
+          typename Weight,
+          typename Data,
+          typename IndexStorage = ArrayStorage<NodeID, NodeID>,
+          unsigned Arity = 4>
+class DAryHeap
+{
+    static_assert(Arity >= 2, "a heap needs at least two children per node");
+
+  private:
+    DAryHeap(const DAryHeap &right);
+    void operator=(const DAryHeap &right);
+
+  public:
+    using WeightType = Weight;
+    using DataType = Data;
+
+    // additional arguments are forwarded to the index storage
+    template <typename... StorageArgs>
+    explicit DAryHeap(size_t maxID, StorageArgs &&... storage_args)
+        : node_index(maxID, std::forward<StorageArgs>(storage_args)...)
+    {
+        Clear();
+    }
+
+    void Clear()
+    {
+        heap.resize(ROOT);
+        inserted_nodes.clear();
+        node_index.Clear();
+    }
+
+    std::size_t Size() const { return (heap.size() - ROOT); }
+
+    const IndexStorage &GetIndexStorage() const { return node_index; }
+
+    bool Empty() const { return 0 == Size(); }
+
+    void Insert(NodeID node, Weight weight, const Data &data)
+    {
+        HeapElement element;
+        element.index = static_cast<NodeID>(inserted_nodes.size());
+        element.weight = weight;
+        const Key key = static_cast<Key>(heap.size());
+        heap.emplace_back(element);
+        inserted_nodes.emplace_back(node, key, weight, data);
+        node_index[node] = element.index;
+        Upheap(key);
+        CheckHeap();
+    }
+
+    Data &GetData(NodeID node)
+    {
+        const Key index = node_index.peek_index(node);
+        return inserted_nodes[index].data;
+    }
+
+    Data const &GetData(NodeID node) const
+    {
+        const Key index = node_index.peek_index(node);
+        return inserted_nodes[index].data;
+    }
+
+    Weight &GetKey(NodeID node)
+    {
+        const Key index = node_index[node];
+        return inserted_nodes[index].weight;
+    }
+
+    bool WasRemoved(const NodeID node) const
+    {
+        BOOST_ASSERT(WasInserted(node));
+        const Key index = node_index.peek_index(node);
+        return inserted_nodes[index].key == 0;
+    }
+
+    bool WasInserted(const NodeID node) const
+    {
+        const auto index = node_index.peek_index(node);
+        if (index >= static_cast<decltype(index)>(inserted_nodes.size()))
+        {
+            return false;
+        }
+        return inserted_nodes[index].node == node;
+    }
+
+    NodeID Min() const
+    {
+        BOOST_ASSERT(heap.size() > ROOT);
+        return inserted_nodes[heap[ROOT].index].node;
+    }
+
+    Weight MinKey() const
+    {
+        BOOST_ASSERT(heap.size() > ROOT);
+        return heap[ROOT].weight;
+    }
+
+    NodeID DeleteMin()
+    {
+        BOOST_ASSERT(heap.size() > ROOT);
+        const Key removedIndex = heap[ROOT].index;
+        heap[ROOT] = heap[heap.size() - 1];
+        heap.pop_back();
+        if (heap.size() > ROOT)
+        {
+            Downheap(ROOT);
+        }
+        inserted_nodes[removedIndex].key = 0;
+        CheckHeap();
+        return inserted_nodes[removedIndex].node;
+    }
+
+    void DeleteAll()
+    {
+        auto iend = heap.end();
+        for (auto i = heap.begin() + ROOT; i != iend; ++i)
+        {
+            inserted_nodes[i->index].key = 0;
+        }
+        heap.resize(ROOT);
+    }
+
+    void DecreaseKey(NodeID node, Weight weight)
+    {
+        BOOST_ASSERT(std::numeric_limits<NodeID>::max() != node);
+        const Key &index = node_index.peek_index(node);
+        Key &key = inserted_nodes[index].key;
+        BOOST_ASSERT(key >= ROOT);
+
+        inserted_nodes[index].weight = weight;
+        heap[key].weight = weight;
+        Upheap(key);
+        CheckHeap();
+    }
+
+  private:
+    // position of the root, positions before it are padding. Since positions are never 0 it is
+    // also used to mark removed nodes, like in BinaryHeap.
+    static constexpr Key ROOT = Arity - 1;
+
+    class HeapNode
+    {
+      public:
+        HeapNode(NodeID n, Key k, Weight w, Data d) : node(n), key(k), weight(w), data(std::move(d))
+        {
+        }
+
+        NodeID node;
+        Key key;
+        Weight weight;
+        Data data;
+    };
+    struct HeapElement
+    {
+        Key index;
+        Weight weight;
+    };
+
+    static Key FirstChild(const Key key) { return Arity * (key - ROOT + 1); }
+
+    static Key Parent(const Key key) { return key / Arity + ROOT - 1; }
+
+    std::vector<HeapNode> inserted_nodes;
+    std::vector<HeapElement, tbb::cache_aligned_allocator<HeapElement>> heap;
+    IndexStorage node_index;
+
+    void Downheap(Key key)
+    {
+        const Key droppingIndex = heap[key].index;
+        const Weight weight = heap[key].weight;
+        const Key heap_size = static_cast<Key>(heap.size());
+        Key firstChild = FirstChild(key);
+        while (firstChild < heap_size)
+        {
+            // find the smallest of the (up to Arity) children
+            const Key lastChild = std::min<Key>(firstChild + Arity, heap_size);
+            Key nextKey = firstChild;
+            for (Key child = firstChild + 1; child < lastChild; ++child)
+            {
+                if (heap[child].weight < heap[nextKey].weight)
+                {
+                    nextKey = child;
+                }
+            }
+            if (weight <= heap[nextKey].weight)
+            {
+                break;
+            }
+            heap[key] = heap[nextKey];
+            inserted_nodes[heap[key].index].key = key;
+            key = nextKey;
+            firstChild = FirstChild(key);
+        }
+        heap[key].index = droppingIndex;
+        heap[key].weight = weight;
+        inserted_nodes[droppingIndex].key = key;
+    }
+
+    void Upheap(Key key)
+    {
+        const Key risingIndex = heap[key].index;
+        const Weight weight = heap[key].weight;
+        while (key > ROOT)
+        {
+            const Key nextKey = Parent(key);
+            if (heap[nextKey].weight <= weight)
+            {
+                break;
+            }
+            heap[key] = heap[nextKey];
+            inserted_nodes[heap[key].index].key = key;
+            key = nextKey;
+        }
+        heap[key].index = risingIndex;
+        heap[key].weight = weight;
+        inserted_nodes[risingIndex].key = key;
+    }
+
+    void CheckHeap()
+    {
+#ifndef NDEBUG
+        for (std::size_t i = ROOT + 1; i < heap.size(); ++i)
+        {
+            BOOST_ASSERT(heap[i].weight >= heap[Parent(i)].weight);
+        }
+#endif
+    }
+};
+}
+}
+
+#endif // D_ARY_HEAP_HPP
@@ -5,6 +5,7 @@
 #define JSON_RENDERER_HPP
 
 #include "util/cast.hpp"
+#include "util/json_writer.hpp"
 #include "util/string_util.hpp"
 
 #include "osrm/json_container.hpp"
@@ -84,15 +85,15 @@ struct ArrayRenderer
     void operator()(const String &string) const
     {
         out.push_back('\"');
-        const auto string_to_insert = escape_JSON(string.value);
-        out.insert(std::end(out), std::begin(string_to_insert), std::end(string_to_insert));
+        escape_JSON(string.value, out);
         out.push_back('\"');
     }
 
     void operator()(const Number &number) const
     {
-        const std::string number_string = cast::to_string_with_precision(number.value);
-        out.insert(out.end(), number_string.begin(), number_string.end());
+        char buffer[512];
+        char *end = detail::formatNumber(number.value, buffer);
+        out.insert(out.end(), buffer, end);
     }
 
     void operator()(const Object &object) const
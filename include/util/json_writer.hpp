@@ -0,0 +1,233 @@
+#ifndef JSON_WRITER_HPP
+#define JSON_WRITER_HPP
+
+#include "util/string_util.hpp"
+#include "osrm/json_container.hpp"
+
+#include <variant/variant.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+namespace json
+{
+
+namespace detail
+{
+// Formats a number like cast::to_string_with_precision<double, 6>: fixed notation with six
+// digits after the decimal point, trailing zeros and a trailing point removed. Returns a pointer
+// past the last written character. buffer needs space for at least 32 characters, the
+// exponential fallback aside.
+inline char *formatNumber(const double value, char *buffer)
+{
+    constexpr double SCALE = 1e6;
+    // integers up to this size are exactly representable as double and int64
+    constexpr double MAX_EXACT = 9007199254740992.;
+
+    const double scaled = std::abs(value) * SCALE;
+    // values close to a rounding tie are left to printf, which rounds based on the exact decimal
+    // expansion of the binary value. The scaling above is off by at most half an ulp.
+    const double fraction = scaled - std::floor(scaled);
+    if (!(scaled < MAX_EXACT) || std::abs(fraction - 0.5) <= scaled * 1e-15 + 1e-9)
+    {
+        const int length = std::snprintf(buffer, 512, "%.6f", value);
+        char *end = buffer + length;
+        if (std::memchr(buffer, '.', length) != nullptr)
+        {
+            while (end[-1] == '0')
+                --end;
+            if (end[-1] == '.')
+                --end;
+        }
+        return end;
+    }
+
+    const auto fixed = static_cast<std::uint64_t>(std::llround(scaled));
+    auto integral = fixed / 1000000;
+    auto decimals = static_cast<std::uint32_t>(fixed % 1000000);
+
+    char *out = buffer;
+    if (std::signbit(value))
+    {
+        *out++ = '-';
+    }
+
+    // integral part, written backwards into a scratch space and copied over
+    char digits[20];
+    int num_digits = 0;
+    do
+    {
+        digits[num_digits++] = static_cast<char>('0' + integral % 10);
+        integral /= 10;
+    } while (integral != 0);
+    while (num_digits > 0)
+    {
+        *out++ = digits[--num_digits];
+    }
+
+    if (decimals != 0)
+    {
+        *out++ = '.';
+        int num_decimals = 6;
+        while (decimals % 10 == 0)
+        {
+            decimals /= 10;
+            --num_decimals;
+        }
+        for (int i = num_decimals - 1; i >= 0; --i)
+        {
+            out[i] = static_cast<char>('0' + decimals % 10);
+            decimals /= 10;
+        }
+        out += num_decimals;
+    }
+
+    return out;
+}
+}
+
+/**
+ * Streams JSON into a character buffer as the response is generated.
+ *
+ * In contrast to building a json::Object and rendering it afterwards no intermediate tree is
+ * allocated. The caller is responsible for the structure of the document: calls to Start* and
+ * End* need to match and every value inside an object needs to be preceded by a Key. Separators
+ * are inserted by the writer.
+ */
+class Writer
+{
+  public:
+    explicit Writer(std::vector<char> &out_) : out(out_), first(true) {}
+
+    void StartObject()
+    {
+        Separate();
+        out.push_back('{');
+        first = true;
+    }
+
+    void EndObject()
+    {
+        out.push_back('}');
+        first = false;
+    }
+
+    void StartArray()
+    {
+        Separate();
+        out.push_back('[');
+        first = true;
+    }
+
+    void EndArray()
+    {
+        out.push_back(']');
+        first = false;
+    }
+
+    // Keys are not escaped, they are expected to be plain identifiers
+    void Key(const char *key)
+    {
+        Separate();
+        out.push_back('"');
+        out.insert(out.end(), key, key + std::strlen(key));
+        out.push_back('"');
+        out.push_back(':');
+        // the value following the key must not be separated by a comma
+        first = true;
+    }
+
+    void String(const std::string &value)
+    {
+        Separate();
+        out.push_back('"');
+        escape_JSON(value, out);
+        out.push_back('"');
+    }
+
+    void Number(const double value)
+    {
+        Separate();
+        char buffer[512];
+        char *end = detail::formatNumber(value, buffer);
+        out.insert(out.end(), buffer, end);
+    }
+
+    void Bool(const bool value)
+    {
+        Separate();
+        Append(value ? "true" : "false");
+    }
+
+    void Null()
+    {
+        Separate();
+        Append("null");
+    }
+
+    // Writes an already built tree, e.g. parts of a response that are shared with the json::Object
+    // code path
+    void Value(const json::Value &value) { mapbox::util::apply_visitor(ValueWriter{*this}, value); }
+
+  private:
+    struct ValueWriter
+    {
+        void operator()(const json::String &string) const { writer.String(string.value); }
+        void operator()(const json::Number &number) const { writer.Number(number.value); }
+        void operator()(const json::Object &object) const
+        {
+            writer.StartObject();
+            for (const auto &key_value : object.values)
+            {
+                writer.Key(key_value.first.c_str());
+                mapbox::util::apply_visitor(*this, key_value.second);
+            }
+            writer.EndObject();
+        }
+        void operator()(const json::Array &array) const
+        {
+            writer.StartArray();
+            for (const auto &value : array.values)
+            {
+                mapbox::util::apply_visitor(*this, value);
+            }
+            writer.EndArray();
+        }
+        void operator()(const json::True &) const { writer.Bool(true); }
+        void operator()(const json::False &) const { writer.Bool(false); }
+        void operator()(const json::Null &) const { writer.Null(); }
+
+        Writer &writer;
+    };
+
+    void Separate()
+    {
+        if (!first)
+        {
+            out.push_back(',');
+        }
+        first = false;
+    }
+
+    void Append(const char *literal)
+    {
+        out.insert(out.end(), literal, literal + std::strlen(literal));
+    }
+
+    std::vector<char> &out;
+    // true if the next value is the first one in its array / object or follows a key
+    bool first;
+};
+}
+}
+}
+
+#endif // JSON_WRITER_HPP
@@ -0,0 +1,47 @@
+#ifndef OSRM_UTIL_PAGE_FAULTS_HPP
+#define OSRM_UTIL_PAGE_FAULTS_HPP
+
+#include <cstdint>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace osrm
+{
+namespace util
+{
+
+// Page faults of the process. Major faults had to read the page from disk, minor faults found
+// the page in the page cache. Both are zero on platforms without getrusage.
+struct PageFaults
+{
+    std::uint64_t minor = 0;
+    std::uint64_t major = 0;
+};
+
+inline PageFaults getPageFaults()
+{
+    PageFaults faults;
+#ifndef _WIN32
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        faults.minor = usage.ru_minflt;
+        faults.major = usage.ru_majflt;
+    }
+#endif
+    return faults;
+}
+
+inline PageFaults operator-(const PageFaults &lhs, const PageFaults &rhs)
+{
+    PageFaults difference;
+    difference.minor = lhs.minor - rhs.minor;
+    difference.major = lhs.major - rhs.major;
+    return difference;
+}
+}
+}
+
+#endif
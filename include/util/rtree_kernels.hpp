@@ -0,0 +1,67 @@
+#ifndef OSRM_UTIL_RTREE_KERNELS_HPP
+#define OSRM_UTIL_RTREE_KERNELS_HPP
+
+#include "util/coordinate.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace osrm
+{
+namespace util
+{
+
+// Distance computations of the StaticRTree that process all segments of a leaf or all children
+// of a tree node at once. The inputs are arrays of fixed point Web Mercator coordinates, the
+// distances are squared euclidean distances like coordinate_calculation::squaredEuclideanDistance.
+//
+// The kernels use the widest instruction set the CPU supports, which is detected at runtime.
+// All instruction sets compute the same results up to rounding of the closest points.
+namespace rtree_kernels
+{
+
+enum class InstructionSet
+{
+    Scalar,
+    SSE41,
+    AVX2
+};
+
+// The instruction set used by the kernels
+InstructionSet getInstructionSet();
+
+// The widest instruction set supported by the CPU
+InstructionSet getSupportedInstructionSet();
+
+// Uses the given instruction set, or the widest supported one if the CPU does not support it.
+// Meant for benchmarks and tests, the instruction set is shared by all threads.
+InstructionSet setInstructionSet(const InstructionSet instruction_set);
+
+const char *toString(const InstructionSet instruction_set);
+
+// Computes the squared distances of the coordinate to the segments u -> v and the closest points
+// on the segments.
+void segmentDistances(const std::int32_t *u_lon,
+                      const std::int32_t *u_lat,
+                      const std::int32_t *v_lon,
+                      const std::int32_t *v_lat,
+                      const std::size_t count,
+                      const Coordinate coordinate,
+                      std::uint64_t *squared_distances,
+                      std::int32_t *nearest_lon,
+                      std::int32_t *nearest_lat);
+
+// Computes the squared distances of the coordinate to the rectangles, which is zero if a
+// rectangle contains the coordinate.
+void rectangleDistances(const std::int32_t *min_lon,
+                        const std::int32_t *max_lon,
+                        const std::int32_t *min_lat,
+                        const std::int32_t *max_lat,
+                        const std::size_t count,
+                        const Coordinate coordinate,
+                        std::uint64_t *squared_distances);
+}
+}
+}
+
+#endif
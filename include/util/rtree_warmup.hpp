@@ -0,0 +1,52 @@
+#ifndef OSRM_UTIL_RTREE_WARMUP_HPP
+#define OSRM_UTIL_RTREE_WARMUP_HPP
+
+#include <boost/filesystem/path.hpp>
+
+#include <cstddef>
+#include <string>
+
+namespace osrm
+{
+namespace util
+{
+
+// How the memory mapped leaves of the StaticRTree are loaded before the first query
+enum class RTreeWarmup
+{
+    // pages are read on the first access of a query
+    None,
+    // the kernel is asked to read the whole file ahead in the background
+    Advise,
+    // every page is read before the data is used
+    Populate,
+    // the pages that were resident when the last dataset was unloaded are read before the data
+    // is used, the list of pages is saved to a file on unloading
+    HotPages
+};
+
+// Parses none, advise, populate and hot-pages
+bool parseRTreeWarmup(const std::string &name, RTreeWarmup &warmup);
+
+const char *toString(const RTreeWarmup warmup);
+
+namespace rtree_warmup
+{
+
+// Loads the pages of the mapped region [data, data + size) as configured by the mode and returns
+// the number of pages that were read. Only the HotPages mode reads hot_pages_path.
+std::size_t warmUp(const char *data,
+                   const std::size_t size,
+                   const RTreeWarmup warmup,
+                   const boost::filesystem::path &hot_pages_path);
+
+// Saves the pages of the mapped region that are resident in memory for the HotPages mode.
+// Returns the number of saved pages. Only supported on Linux, elsewhere nothing is saved.
+std::size_t saveHotPages(const char *data,
+                         const std::size_t size,
+                         const boost::filesystem::path &hot_pages_path);
+}
+}
+}
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef SEARCH_HEAP_HPP
+#define SEARCH_HEAP_HPP
+
+#include "util/binary_heap.hpp"
+#include "util/d_ary_heap.hpp"
+
+namespace osrm
+{
+namespace util
+{
+
+// Priority queue used by the query searches and the witness searches of the contractor.
+// Building with -DENABLE_DARY_HEAP=ON switches from the binary heap to a 4-ary heap.
+template <typename NodeID, typename Key, typename Weight, typename Data, typename IndexStorage>
+#ifdef OSRM_ENABLE_DARY_HEAP
+using SearchHeap = DAryHeap<NodeID, Key, Weight, Data, IndexStorage, 4>;
+#else
+using SearchHeap = BinaryHeap<NodeID, Key, Weight, Data, IndexStorage>;
+#endif
+}
+}
+
+#endif // SEARCH_HEAP_HPP
@@ -107,6 +107,8 @@ template <typename DataT> class SharedMemoryWrapper
 
     ShMemReverseIterator<DataT> rend() const { return ShMemReverseIterator<DataT>(m_ptr - 1); }
 
+    const DataT *data() const { return m_ptr; }
+
     std::size_t size() const { return m_size; }
 
     bool empty() const { return 0 == size(); }
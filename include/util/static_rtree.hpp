@@ -8,8 +8,13 @@
 #include "util/exception.hpp"
 #include "util/hilbert_value.hpp"
 #include "util/integer_range.hpp"
+#include "util/page_faults.hpp"
 #include "util/rectangle.hpp"
+#include "util/rtree_kernels.hpp"
+#include "util/rtree_warmup.hpp"
 #include "util/shared_memory_vector_wrapper.hpp"
+#include "util/simple_logger.hpp"
+#include "util/timing_util.hpp"
 #include "util/typedefs.hpp"
 #include "util/web_mercator.hpp"
 
@@ -30,6 +35,9 @@
 #include <memory>
 #include <queue>
 #include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 // An extended alignment is implementation-defined, so use compiler attributes
@@ -50,11 +58,15 @@ namespace util
 // Static RTree for serving nearest neighbour queries
 // All coordinates are pojected first to Web Mercator before the bounding boxes
 // are computed, this means the internal distance metric doesn not represent meters!
+// With PROJECTED_LEAVES the leaves store the projected coordinates of every segment, so a leaf
+// is searched without reading from the coordinate list. Otherwise the leaves only store the
+// EdgeDataT and the coordinates are looked up and projected on every search.
 template <class EdgeDataT,
           class CoordinateListT = std::vector<Coordinate>,
           bool UseSharedMemory = false,
           std::uint32_t BRANCHING_FACTOR = 128,
-          std::uint32_t LEAF_PAGE_SIZE = 4096>
+          std::uint32_t LEAF_PAGE_SIZE = 4096,
+          bool PROJECTED_LEAVES = true>
 class StaticRTree
 {
   public:
@@ -62,10 +74,20 @@ class StaticRTree
     using EdgeData = EdgeDataT;
     using CoordinateList = CoordinateListT;
 
-    static_assert(LEAF_PAGE_SIZE >= sizeof(uint32_t) + sizeof(EdgeDataT), "page size is too small");
+    struct ProjectedLeafObject
+    {
+        EdgeDataT data;
+        Coordinate projected_u;
+        Coordinate projected_v;
+    };
+    using LeafObject =
+        typename std::conditional<PROJECTED_LEAVES, ProjectedLeafObject, EdgeDataT>::type;
+
+    static_assert(LEAF_PAGE_SIZE >= sizeof(uint32_t) + sizeof(Rectangle) + sizeof(LeafObject),
+                  "page size is too small");
     static_assert(((LEAF_PAGE_SIZE - 1) & LEAF_PAGE_SIZE) == 0, "page size is not a power of 2");
     static constexpr std::uint32_t LEAF_NODE_SIZE =
-        (LEAF_PAGE_SIZE - sizeof(uint32_t) - sizeof(Rectangle)) / sizeof(EdgeDataT);
+        (LEAF_PAGE_SIZE - sizeof(uint32_t) - sizeof(Rectangle)) / sizeof(LeafObject);
 
     struct CandidateSegment
     {
@@ -81,12 +103,44 @@ class StaticRTree
         std::uint32_t is_leaf : 1;
     };
 
+    // The rectangles of the children are stored in the node, so searches compute the distances
+    // to all children at once without reading the children. This takes 16 bytes per child, with
+    // the default branching factor a node grows from 532 to 2580 bytes. All nodes but the last
+    // of each level are full, so storing only the rectangles of existing children saves nothing.
     struct TreeNode
     {
-        TreeNode() : child_count(0) {}
+        TreeNode()
+            : child_count(0), child_min_lon(), child_max_lon(), child_min_lat(), child_max_lat()
+        {
+        }
+
+        void AddChild(const TreeIndex child, const Rectangle &child_rectangle)
+        {
+            BOOST_ASSERT(child_count < BRANCHING_FACTOR);
+            children[child_count] = child;
+            child_min_lon[child_count] = static_cast<std::int32_t>(child_rectangle.min_lon);
+            child_max_lon[child_count] = static_cast<std::int32_t>(child_rectangle.max_lon);
+            child_min_lat[child_count] = static_cast<std::int32_t>(child_rectangle.min_lat);
+            child_max_lat[child_count] = static_cast<std::int32_t>(child_rectangle.max_lat);
+            minimum_bounding_rectangle.MergeBoundingBoxes(child_rectangle);
+            ++child_count;
+        }
+
+        Rectangle GetChildRectangle(const std::uint32_t child) const
+        {
+            return Rectangle{FixedLongitude{child_min_lon[child]},
+                             FixedLongitude{child_max_lon[child]},
+                             FixedLatitude{child_min_lat[child]},
+                             FixedLatitude{child_max_lat[child]}};
+        }
+
         std::uint32_t child_count;
         Rectangle minimum_bounding_rectangle;
         TreeIndex children[BRANCHING_FACTOR];
+        std::array<std::int32_t, BRANCHING_FACTOR> child_min_lon;
+        std::array<std::int32_t, BRANCHING_FACTOR> child_max_lon;
+        std::array<std::int32_t, BRANCHING_FACTOR> child_min_lat;
+        std::array<std::int32_t, BRANCHING_FACTOR> child_max_lat;
     };
 
     struct ALIGNED(LEAF_PAGE_SIZE) LeafNode
@@ -94,10 +148,16 @@ class StaticRTree
         LeafNode() : object_count(0), objects() {}
         std::uint32_t object_count;
         Rectangle minimum_bounding_rectangle;
-        std::array<EdgeDataT, LEAF_NODE_SIZE> objects;
+        std::array<LeafObject, LEAF_NODE_SIZE> objects;
     };
     static_assert(sizeof(LeafNode) == LEAF_PAGE_SIZE, "LeafNode size does not fit the page size");
 
+    // The EdgeDataT of an object of a leaf, independent of the leaf format
+    static const EdgeDataT &GetEdgeData(const ProjectedLeafObject &object) { return object.data; }
+    static EdgeDataT &GetEdgeData(ProjectedLeafObject &object) { return object.data; }
+    static const EdgeDataT &GetEdgeData(const EdgeDataT &object) { return object; }
+    static EdgeDataT &GetEdgeData(EdgeDataT &object) { return object; }
+
   private:
     struct WrappedInputElement
     {
@@ -160,6 +220,64 @@ class StaticRTree
     typename ShM<const LeafNode, true>::vector m_leaves;
 
   public:
+    // Traversal queue of the nearest queries. It is meant to be kept between queries,
+    // so the queries reuse its memory instead of allocating a new queue.
+    class NearestQueue
+    {
+        friend class StaticRTree;
+
+        void Clear(const std::size_t max_results_)
+        {
+            candidates.clear();
+            bounds.clear();
+            max_results = max_results_;
+        }
+
+        bool Empty() const { return candidates.empty(); }
+
+        void Push(const QueryCandidate &candidate)
+        {
+            candidates.push_back(candidate);
+            std::push_heap(candidates.begin(), candidates.end());
+        }
+
+        QueryCandidate Pop()
+        {
+            std::pop_heap(candidates.begin(), candidates.end());
+            const QueryCandidate candidate = candidates.back();
+            candidates.pop_back();
+            return candidate;
+        }
+
+        // Nothing farther than the max_results-th nearest accepted segment can be a result
+        std::uint64_t Bound() const
+        {
+            return bounds.size() < max_results ? std::numeric_limits<std::uint64_t>::max()
+                                               : bounds.front();
+        }
+
+        void Accept(const std::uint64_t squared_distance)
+        {
+            if (bounds.size() < max_results)
+            {
+                bounds.push_back(squared_distance);
+                std::push_heap(bounds.begin(), bounds.end());
+            }
+            else if (squared_distance < bounds.front())
+            {
+                std::pop_heap(bounds.begin(), bounds.end());
+                bounds.back() = squared_distance;
+                std::push_heap(bounds.begin(), bounds.end());
+            }
+        }
+
+        // heap ordered like std::priority_queue<QueryCandidate>
+        std::vector<QueryCandidate> candidates;
+        // max heap of the distances of the max_results nearest accepted segments
+        std::vector<std::uint64_t> bounds;
+        std::size_t max_results = 0;
+    };
+
     StaticRTree(const StaticRTree &) = delete;
     StaticRTree &operator=(const StaticRTree &) = delete;
 
@@ -228,14 +346,15 @@ class StaticRTree
                         input_wrapper_vector[wrapped_element_index].m_array_index;
                     const EdgeDataT &object = input_data_vector[input_object_index];
 
-                    current_leaf.object_count += 1;
-                    current_leaf.objects[object_index] = object;
-
                     Coordinate projected_u{
                         web_mercator::fromWGS84(Coordinate{m_coordinate_list[object.u]})};
                     Coordinate projected_v{
                         web_mercator::fromWGS84(Coordinate{m_coordinate_list[object.v]})};
 
+                    current_leaf.object_count += 1;
+                    SetLeafObject(
+                        current_leaf.objects[object_index], object, projected_u, projected_v);
+
                     BOOST_ASSERT(std::abs(toFloating(projected_u.lon).operator double()) <= 180.);
                     BOOST_ASSERT(std::abs(toFloating(projected_u.lat).operator double()) <= 180.);
                     BOOST_ASSERT(std::abs(toFloating(projected_v.lon).operator double()) <= 180.);
@@ -255,11 +374,8 @@ class StaticRTree
                 }
 
                 // append the leaf node to the current tree node
-                current_node.child_count += 1;
-                current_node.children[leaf_index] =
-                    TreeIndex{node_index * BRANCHING_FACTOR + leaf_index, true};
-                current_node.minimum_bounding_rectangle.MergeBoundingBoxes(
-                    current_leaf.minimum_bounding_rectangle);
+                current_node.AddChild(TreeIndex{node_index * BRANCHING_FACTOR + leaf_index, true},
+                                      current_leaf.minimum_bounding_rectangle);
 
                 // write leaf_node to leaf node file
                 leaf_node_file.write((char *)&current_leaf, sizeof(current_leaf));
@@ -288,14 +404,9 @@ class StaticRTree
                         TreeNode &current_child_node =
                             tree_nodes_in_level[processed_tree_nodes_in_level];
                         // add tree node to parent entry
-                        parent_node.children[current_child_node_index] =
-                            TreeIndex{m_search_tree.size(), false};
+                        parent_node.AddChild(TreeIndex{m_search_tree.size(), false},
+                                             current_child_node.minimum_bounding_rectangle);
                         m_search_tree.emplace_back(current_child_node);
-                        // merge MBRs
-                        parent_node.minimum_bounding_rectangle.MergeBoundingBoxes(
-                            current_child_node.minimum_bounding_rectangle);
-                        // increase counters
-                        ++parent_node.child_count;
                         ++processed_tree_nodes_in_level;
                     }
                 }
@@ -374,6 +485,53 @@ class StaticRTree
         MapLeafNodesFile(leaf_file);
     }
 
+    // Uses leaves that were already loaded into memory instead of mapping the leaf file
+    explicit StaticRTree(TreeNode *tree_node_ptr,
+                         const uint64_t number_of_nodes,
+                         const LeafNode *leaf_node_ptr,
+                         const uint64_t number_of_leaves,
+                         const CoordinateListT &coordinate_list)
+        : m_search_tree(tree_node_ptr, number_of_nodes), m_coordinate_list(coordinate_list),
+          m_leaves(leaf_node_ptr, number_of_leaves)
+    {
+    }
+
+    // Loads the pages of the mapped leaf file before queries fault them in one by one.
+    // Leaves that are not mapped from a file are already in memory.
+    void WarmUpLeaves(const RTreeWarmup warmup, const boost::filesystem::path &hot_pages_path) const
+    {
+        if (warmup == RTreeWarmup::None || !m_leaves_region.is_open())
+        {
+            return;
+        }
+
+        const auto faults_before = getPageFaults();
+        TIMER_START(warmup);
+        const auto number_of_pages = rtree_warmup::warmUp(
+            m_leaves_region.data(), m_leaves_region.size(), warmup, hot_pages_path);
+        TIMER_STOP(warmup);
+        const auto faults = getPageFaults() - faults_before;
+
+        SimpleLogger().Write() << "R-tree leaf warm-up (" << toString(warmup) << ") read "
+                               << number_of_pages << " pages in " << TIMER_MSEC(warmup)
+                               << "ms with " << faults.major << " major and " << faults.minor
+                               << " minor page faults";
+    }
+
+    // Saves the resident pages of the mapped leaf file for RTreeWarmup::HotPages
+    void SaveHotLeafPages(const boost::filesystem::path &hot_pages_path) const
+    {
+        if (!m_leaves_region.is_open())
+        {
+            return;
+        }
+
+        const auto number_of_pages = rtree_warmup::saveHotPages(
+            m_leaves_region.data(), m_leaves_region.size(), hot_pages_path);
+        SimpleLogger().Write(logDEBUG) << "Saved " << number_of_pages << " hot R-tree pages to "
+                                       << hot_pages_path.string();
+    }
+
     void MapLeafNodesFile(const boost::filesystem::path &leaf_file)
     {
         // open leaf node file and return a pointer to the mapped leaves data
@@ -417,23 +575,10 @@ class StaticRTree
 
                 for (const auto i : irange(0u, current_leaf_node.object_count))
                 {
-                    const auto &current_edge = current_leaf_node.objects[i];
-
-                    // we don't need to project the coordinates here,
-                    // because we use the unprojected rectangle to test against
-                    const Rectangle bbox{std::min(m_coordinate_list[current_edge.u].lon,
-                                                  m_coordinate_list[current_edge.v].lon),
-                                         std::max(m_coordinate_list[current_edge.u].lon,
-                                                  m_coordinate_list[current_edge.v].lon),
-                                         std::min(m_coordinate_list[current_edge.u].lat,
-                                                  m_coordinate_list[current_edge.v].lat),
-                                         std::max(m_coordinate_list[current_edge.u].lat,
-                                                  m_coordinate_list[current_edge.v].lat)};
-
-                    // use the _unprojected_ input rectangle here
-                    if (bbox.Intersects(search_rectangle))
+                    const auto &current_object = current_leaf_node.objects[i];
+                    if (Intersects(current_object, search_rectangle, projected_rectangle))
                     {
-                        results.push_back(current_edge);
+                        results.push_back(GetEdgeData(current_object));
                     }
                 }
             }
@@ -445,14 +590,9 @@ class StaticRTree
                 // to the search queue if their bounding boxes intersect
                 for (std::uint32_t i = 0; i < current_tree_node.child_count; ++i)
                 {
-                    const TreeIndex child_id = current_tree_node.children[i];
-                    const auto &child_rectangle =
-                        child_id.is_leaf ? m_leaves[child_id.index].minimum_bounding_rectangle
-                                         : m_search_tree[child_id.index].minimum_bounding_rectangle;
-
-                    if (child_rectangle.Intersects(projected_rectangle))
+                    if (current_tree_node.GetChildRectangle(i).Intersects(projected_rectangle))
                     {
-                        traversal_queue.push(child_id);
+                        traversal_queue.push(current_tree_node.children[i]);
                     }
                 }
             }
@@ -464,11 +604,82 @@ class StaticRTree
     std::vector<EdgeDataT> Nearest(const Coordinate input_coordinate,
                                    const std::size_t max_results) const
     {
-        return Nearest(input_coordinate,
-                       [](const CandidateSegment &) { return std::make_pair(true, true); },
-                       [max_results](const std::size_t num_results, const CandidateSegment &) {
-                           return num_results >= max_results;
-                       });
+        NearestQueue queue;
+        std::vector<EdgeDataT> results;
+        Nearest(input_coordinate,
+                [](const CandidateSegment &) { return std::make_pair(true, true); },
+                [](const std::size_t, const CandidateSegment &) { return false; },
+                max_results,
+                queue,
+                results);
+        return results;
+    }
+
+    // Returns at most max_results segments like Nearest(input_coordinate, filter, terminate) with
+    // a terminator that also stops at max_results results. The filter is already applied when a
+    // leaf is explored, so segments and tree nodes that are farther away than the max_results
+    // nearest accepted segments are never queued. This requires a filter without side effects and
+    // the terminator is only called for accepted segments. The queue and the results are cleared
+    // first and keep their memory, so repeated queries do not allocate.
+    template <typename FilterT, typename TerminationT>
+    void Nearest(const Coordinate input_coordinate,
+                 const FilterT filter,
+                 const TerminationT terminate,
+                 const std::size_t max_results,
+                 NearestQueue &queue,
+                 std::vector<EdgeDataT> &results) const
+    {
+        results.clear();
+        if (max_results == 0)
+        {
+            return;
+        }
+        const Coordinate fixed_projected_coordinate{web_mercator::fromWGS84(input_coordinate)};
+
+        queue.Clear(max_results);
+        queue.Push(QueryCandidate{0, TreeIndex{}});
+
+        while (!queue.Empty())
+        {
+            const QueryCandidate current_query_node = queue.Pop();
+
+            const TreeIndex &current_tree_index = current_query_node.tree_index;
+            if (!current_query_node.is_segment())
+            { // current object is a tree node
+                if (current_tree_index.is_leaf)
+                {
+                    ExploreLeafNode(current_tree_index, fixed_projected_coordinate, filter, queue);
+                }
+                else
+                {
+                    ExploreTreeNode(current_tree_index, fixed_projected_coordinate, queue);
+                }
+            }
+            else
+            { // current candidate is an accepted road segment
+                auto edge_data = GetEdgeData(
+                    m_leaves[current_tree_index.index].objects[current_query_node.segment_index]);
+                const auto &current_candidate =
+                    CandidateSegment{current_query_node.fixed_projected_coordinate, edge_data};
+
+                if (terminate(results.size(), current_candidate))
+                {
+                    break;
+                }
+
+                const auto use_segment = filter(current_candidate);
+                edge_data.forward_segment_id.enabled &= use_segment.first;
+                edge_data.reverse_segment_id.enabled &= use_segment.second;
+                results.push_back(std::move(edge_data));
+
+                // all queued segments are farther away, so e.g. a query for the nearest segment
+                // returns as soon as it is dequeued
+                if (results.size() >= max_results)
+                {
+                    break;
+                }
+            }
+        }
     }
 
     // Override filter and terminator for the desired behaviour.
@@ -477,39 +688,49 @@ class StaticRTree
                                    const FilterT filter,
                                    const TerminationT terminate) const
     {
+        NearestQueue queue;
         std::vector<EdgeDataT> results;
-        auto projected_coordinate = web_mercator::fromWGS84(input_coordinate);
-        Coordinate fixed_projected_coordinate{projected_coordinate};
+        Nearest(input_coordinate, filter, terminate, queue, results);
+        return results;
+    }
+
+    // Like Nearest(input_coordinate, filter, terminate), so the filter may have side effects.
+    // The queue and the results are cleared first and keep their memory, so repeated queries do
+    // not allocate.
+    template <typename FilterT, typename TerminationT>
+    void Nearest(const Coordinate input_coordinate,
+                 const FilterT filter,
+                 const TerminationT terminate,
+                 NearestQueue &queue,
+                 std::vector<EdgeDataT> &results) const
+    {
+        results.clear();
+        const Coordinate fixed_projected_coordinate{web_mercator::fromWGS84(input_coordinate)};
 
         // initialize queue with root element
-        std::priority_queue<QueryCandidate> traversal_queue;
-        traversal_queue.push(QueryCandidate{0, TreeIndex{}});
+        queue.Clear(std::numeric_limits<std::size_t>::max());
+        queue.Push(QueryCandidate{0, TreeIndex{}});
 
-        while (!traversal_queue.empty())
+        while (!queue.Empty())
         {
-            QueryCandidate current_query_node = traversal_queue.top();
-            traversal_queue.pop();
+            const QueryCandidate current_query_node = queue.Pop();
 
             const TreeIndex &current_tree_index = current_query_node.tree_index;
             if (!current_query_node.is_segment())
             { // current object is a tree node
                 if (current_tree_index.is_leaf)
                 {
-                    ExploreLeafNode(current_tree_index,
-                                    fixed_projected_coordinate,
-                                    projected_coordinate,
-                                    traversal_queue);
+                    ExploreLeafNode(current_tree_index, fixed_projected_coordinate, queue);
                 }
                 else
                 {
-                    ExploreTreeNode(
-                        current_tree_index, fixed_projected_coordinate, traversal_queue);
+                    ExploreTreeNode(current_tree_index, fixed_projected_coordinate, queue);
                 }
             }
             else
             { // current candidate is an actual road segment
-                auto edge_data =
-                    m_leaves[current_tree_index.index].objects[current_query_node.segment_index];
+                auto edge_data = GetEdgeData(
+                    m_leaves[current_tree_index.index].objects[current_query_node.segment_index]);
                 const auto &current_candidate =
                     CandidateSegment{current_query_node.fixed_projected_coordinate, edge_data};
 
@@ -533,55 +754,188 @@ class StaticRTree
                 results.push_back(std::move(edge_data));
             }
         }
-
-        return results;
     }
 
   private:
-    template <typename QueueT>
+    static void SetLeafObject(ProjectedLeafObject &leaf_object,
+                              const EdgeDataT &object,
+                              const Coordinate projected_u,
+                              const Coordinate projected_v)
+    {
+        leaf_object.data = object;
+        leaf_object.projected_u = projected_u;
+        leaf_object.projected_v = projected_v;
+    }
+
+    static void SetLeafObject(EdgeDataT &leaf_object,
+                              const EdgeDataT &object,
+                              const Coordinate,
+                              const Coordinate)
+    {
+        leaf_object = object;
+    }
+
+    std::pair<Coordinate, Coordinate>
+    GetProjectedSegment(const ProjectedLeafObject &leaf_object) const
+    {
+        return std::make_pair(leaf_object.projected_u, leaf_object.projected_v);
+    }
+
+    std::pair<Coordinate, Coordinate> GetProjectedSegment(const EdgeDataT &leaf_object) const
+    {
+        return std::make_pair(
+            Coordinate{web_mercator::fromWGS84(Coordinate{m_coordinate_list[leaf_object.u]})},
+            Coordinate{web_mercator::fromWGS84(Coordinate{m_coordinate_list[leaf_object.v]})});
+    }
+
+    // the projected segment is tested against the projected rectangle
+    bool Intersects(const ProjectedLeafObject &leaf_object,
+                    const Rectangle &,
+                    const Rectangle &projected_rectangle) const
+    {
+        const Rectangle bbox{std::min(leaf_object.projected_u.lon, leaf_object.projected_v.lon),
+                             std::max(leaf_object.projected_u.lon, leaf_object.projected_v.lon),
+                             std::min(leaf_object.projected_u.lat, leaf_object.projected_v.lat),
+                             std::max(leaf_object.projected_u.lat, leaf_object.projected_v.lat)};
+        return bbox.Intersects(projected_rectangle);
+    }
+
+    bool Intersects(const EdgeDataT &leaf_object,
+                    const Rectangle &search_rectangle,
+                    const Rectangle &) const
+    {
+        // we don't need to project the coordinates here,
+        // because we use the unprojected rectangle to test against
+        const Rectangle bbox{std::min(m_coordinate_list[leaf_object.u].lon,
+                                      m_coordinate_list[leaf_object.v].lon),
+                             std::max(m_coordinate_list[leaf_object.u].lon,
+                                      m_coordinate_list[leaf_object.v].lon),
+                             std::min(m_coordinate_list[leaf_object.u].lat,
+                                      m_coordinate_list[leaf_object.v].lat),
+                             std::max(m_coordinate_list[leaf_object.u].lat,
+                                      m_coordinate_list[leaf_object.v].lat)};
+        return bbox.Intersects(search_rectangle);
+    }
+
+    // The kernels read the coordinates as arrays, so the projected segments of the leaf are
+    // gathered first. They are on the page of the leaf already, so this reads no other memory.
+    void SegmentDistances(const LeafNode &leaf_node,
+                          const Coordinate projected_coordinate,
+                          std::uint64_t *squared_distances,
+                          std::int32_t *nearest_lon,
+                          std::int32_t *nearest_lat) const
+    {
+        std::array<std::int32_t, LEAF_NODE_SIZE> u_lon;
+        std::array<std::int32_t, LEAF_NODE_SIZE> u_lat;
+        std::array<std::int32_t, LEAF_NODE_SIZE> v_lon;
+        std::array<std::int32_t, LEAF_NODE_SIZE> v_lat;
+        for (const auto i : irange(0u, leaf_node.object_count))
+        {
+            Coordinate projected_u, projected_v;
+            std::tie(projected_u, projected_v) = GetProjectedSegment(leaf_node.objects[i]);
+            u_lon[i] = static_cast<std::int32_t>(projected_u.lon);
+            u_lat[i] = static_cast<std::int32_t>(projected_u.lat);
+            v_lon[i] = static_cast<std::int32_t>(projected_v.lon);
+            v_lat[i] = static_cast<std::int32_t>(projected_v.lat);
+        }
+        rtree_kernels::segmentDistances(u_lon.data(),
+                                        u_lat.data(),
+                                        v_lon.data(),
+                                        v_lat.data(),
+                                        leaf_node.object_count,
+                                        projected_coordinate,
+                                        squared_distances,
+                                        nearest_lon,
+                                        nearest_lat);
+    }
+
     void ExploreLeafNode(const TreeIndex &leaf_id,
                          const Coordinate &projected_input_coordinate_fixed,
-                         const FloatCoordinate &projected_input_coordinate,
-                         QueueT &traversal_queue) const
+                         NearestQueue &queue) const
     {
         const LeafNode &current_leaf_node = m_leaves[leaf_id.index];
 
         // current object represents a block on disk
+        std::array<std::uint64_t, LEAF_NODE_SIZE> squared_distances;
+        std::array<std::int32_t, LEAF_NODE_SIZE> nearest_lon;
+        std::array<std::int32_t, LEAF_NODE_SIZE> nearest_lat;
+        SegmentDistances(current_leaf_node,
+                         projected_input_coordinate_fixed,
+                         squared_distances.data(),
+                         nearest_lon.data(),
+                         nearest_lat.data());
+
+        for (const auto i : irange(0u, current_leaf_node.object_count))
+        {
+            queue.Push(QueryCandidate{
+                squared_distances[i],
+                leaf_id,
+                i,
+                Coordinate{FixedLongitude{nearest_lon[i]}, FixedLatitude{nearest_lat[i]}}});
+        }
+    }
+
+    // only queues the segments that are accepted by the filter and within the bound of the queue
+    template <typename FilterT>
+    void ExploreLeafNode(const TreeIndex &leaf_id,
+                         const Coordinate &projected_input_coordinate_fixed,
+                         const FilterT &filter,
+                         NearestQueue &queue) const
+    {
+        const LeafNode &current_leaf_node = m_leaves[leaf_id.index];
+
+        std::array<std::uint64_t, LEAF_NODE_SIZE> squared_distances;
+        std::array<std::int32_t, LEAF_NODE_SIZE> nearest_lon;
+        std::array<std::int32_t, LEAF_NODE_SIZE> nearest_lat;
+        SegmentDistances(current_leaf_node,
+                         projected_input_coordinate_fixed,
+                         squared_distances.data(),
+                         nearest_lon.data(),
+                         nearest_lat.data());
+
         for (const auto i : irange(0u, current_leaf_node.object_count))
         {
-            const auto &current_edge = current_leaf_node.objects[i];
-            const auto projected_u = web_mercator::fromWGS84(m_coordinate_list[current_edge.u]);
-            const auto projected_v = web_mercator::fromWGS84(m_coordinate_list[current_edge.v]);
-
-            FloatCoordinate projected_nearest;
-            std::tie(std::ignore, projected_nearest) =
-                coordinate_calculation::projectPointOnSegment(
-                    projected_u, projected_v, projected_input_coordinate);
-
-            const auto squared_distance = coordinate_calculation::squaredEuclideanDistance(
-                projected_input_coordinate_fixed, projected_nearest);
-            // distance must be non-negative
-            BOOST_ASSERT(0. <= squared_distance);
-            traversal_queue.push(
-                QueryCandidate{squared_distance, leaf_id, i, Coordinate{projected_nearest}});
+            if (squared_distances[i] > queue.Bound())
+            {
+                continue;
+            }
+
+            const Coordinate nearest{FixedLongitude{nearest_lon[i]}, FixedLatitude{nearest_lat[i]}};
+            const auto use_segment =
+                filter(CandidateSegment{nearest, GetEdgeData(current_leaf_node.objects[i])});
+            if (!use_segment.first && !use_segment.second)
+            {
+                continue;
+            }
+
+            queue.Accept(squared_distances[i]);
+            queue.Push(QueryCandidate{squared_distances[i], leaf_id, i, nearest});
         }
     }
 
-    template <class QueueT>
+    // only queues the children that may contain a segment within the bound of the queue
     void ExploreTreeNode(const TreeIndex &parent_id,
                          const Coordinate &fixed_projected_input_coordinate,
-                         QueueT &traversal_queue) const
+                         NearestQueue &queue) const
     {
         const TreeNode &parent = m_search_tree[parent_id.index];
+
+        std::array<std::uint64_t, BRANCHING_FACTOR> squared_lower_bounds;
+        rtree_kernels::rectangleDistances(parent.child_min_lon.data(),
+                                          parent.child_max_lon.data(),
+                                          parent.child_min_lat.data(),
+                                          parent.child_max_lat.data(),
+                                          parent.child_count,
+                                          fixed_projected_input_coordinate,
+                                          squared_lower_bounds.data());
+
+        const auto bound = queue.Bound();
         for (std::uint32_t i = 0; i < parent.child_count; ++i)
         {
-            const TreeIndex child_id = parent.children[i];
-            const auto &child_rectangle =
-                child_id.is_leaf ? m_leaves[child_id.index].minimum_bounding_rectangle
-                                 : m_search_tree[child_id.index].minimum_bounding_rectangle;
-            const auto squared_lower_bound_to_element =
-                child_rectangle.GetMinSquaredDist(fixed_projected_input_coordinate);
-            traversal_queue.push(QueryCandidate{squared_lower_bound_to_element, child_id});
+            if (squared_lower_bounds[i] <= bound)
+            {
+                queue.Push(QueryCandidate{squared_lower_bounds[i], parent.children[i]});
+            }
         }
     }
 };
@@ -58,44 +58,54 @@ template <int length, int precision> char *printInt(char *buffer, int value)
     return buffer;
 }
 
-inline std::string escape_JSON(const std::string &input)
+// Appends the escaped input to output, a std::string or std::vector<char>
+template <typename OutputT> void escape_JSON(const std::string &input, OutputT &output)
 {
-    // escape and skip reallocations if possible
-    std::string output;
-    output.reserve(input.size() + 4); // +4 assumes two backslashes on avg
+    const auto append_escaped = [&output](const char letter) {
+        output.push_back('\\');
+        output.push_back(letter);
+    };
     for (const char letter : input)
     {
         switch (letter)
         {
         case '\\':
-            output += "\\\\";
+            append_escaped('\\');
             break;
         case '"':
-            output += "\\\"";
+            append_escaped('"');
             break;
         case '/':
-            output += "\\/";
+            append_escaped('/');
             break;
         case '\b':
-            output += "\\b";
+            append_escaped('b');
             break;
         case '\f':
-            output += "\\f";
+            append_escaped('f');
             break;
         case '\n':
-            output += "\\n";
+            append_escaped('n');
             break;
         case '\r':
-            output += "\\r";
+            append_escaped('r');
             break;
         case '\t':
-            output += "\\t";
+            append_escaped('t');
             break;
         default:
-            output.append(1, letter);
+            output.push_back(letter);
             break;
         }
     }
+}
+
+inline std::string escape_JSON(const std::string &input)
+{
+    // escape and skip reallocations if possible
+    std::string output;
+    output.reserve(input.size() + 4); // +4 assumes two backslashes on avg
+    escape_JSON(input, output);
     return output;
 }
 
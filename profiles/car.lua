@@ -621,3 +621,12 @@ function turn_function (angle)
     return 10 * turn_penalty / (1 + 2.718 ^  - ((13 * turn_bias) * - angle/180 - 6.5/turn_bias))
   end
 end
+
+-- called once per intersection with the angles of all turns, saves a call into lua per turn
+function turn_penalties_function (angles)
+  local penalties = {}
+  for i, angle in ipairs(angles) do
+    penalties[i] = turn_function(angle)
+  end
+  return penalties
+end
@@ -0,0 +1,840 @@
+// Car profile, a port of car.lua (and the lib/ helpers it uses) to a compiled profile.
+//
+// Build it with -DBUILD_COMPILED_PROFILES=ON and pass the resulting library to osrm-extract:
+//   osrm-extract -p car.so map.osm.pbf
+
+#include "extractor/compiled_profile.hpp"
+#include "extractor/extraction_helper_functions.hpp"
+#include "extractor/extraction_node.hpp"
+#include "extractor/extraction_way.hpp"
+
+#include <osmium/osm.hpp>
+
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/algorithm/string/replace.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+
+using namespace osrm::extractor;
+
+using StringSet = std::unordered_set<std::string>;
+using SpeedTable = std::unordered_map<std::string, double>;
+
+const StringSet barrier_whitelist = {"cattle_grid",
+                                     "border_control",
+                                     "checkpoint",
+                                     "toll_booth",
+                                     "sally_port",
+                                     "gate",
+                                     "lift_gate",
+                                     "no",
+                                     "entrance"};
+const StringSet access_tag_whitelist = {
+    "yes", "motorcar", "motor_vehicle", "vehicle", "permissive", "designated", "destination"};
+const StringSet access_tag_blacklist = {
+    "no", "private", "agricultural", "forestry", "emergency", "psv", "delivery"};
+const StringSet access_tag_restricted = {"destination", "delivery"};
+const std::vector<const char *> access_tags_hierarchy = {
+    "motorcar", "motor_vehicle", "vehicle", "access"};
+const StringSet service_tag_restricted = {"parking_aisle", "parking"};
+const StringSet service_tag_forbidden = {"emergency_access"};
+const std::vector<std::string> restrictions = {"motorcar", "motor_vehicle", "vehicle"};
+
+// A list of suffixes to suppress in name change instructions
+const std::vector<std::string> suffix_list = {
+    "N", "NE", "E", "SE", "S", "SW", "W", "NW", "North", "South", "West", "East"};
+
+const SpeedTable speed_profile = {{"motorway", 90},
+                                  {"motorway_link", 45},
+                                  {"trunk", 85},
+                                  {"trunk_link", 40},
+                                  {"primary", 65},
+                                  {"primary_link", 30},
+                                  {"secondary", 55},
+                                  {"secondary_link", 25},
+                                  {"tertiary", 40},
+                                  {"tertiary_link", 20},
+                                  {"unclassified", 25},
+                                  {"residential", 25},
+                                  {"living_street", 10},
+                                  {"service", 15},
+                                  {"ferry", 5},
+                                  {"movable", 5},
+                                  {"shuttle_train", 10},
+                                  {"default", 10}};
+
+const SpeedTable service_speeds = {
+    {"alley", 5}, {"parking", 5}, {"parking_aisle", 5}, {"driveway", 5}, {"drive-through", 5}};
+
+// max speed for surfaces, surfaces without a limit are not listed
+const SpeedTable surface_speeds = {{"cement", 80},
+                                   {"compacted", 80},
+                                   {"fine_gravel", 80},
+                                   {"paving_stones", 60},
+                                   {"metal", 60},
+                                   {"bricks", 60},
+                                   {"grass", 40},
+                                   {"wood", 40},
+                                   {"sett", 40},
+                                   {"grass_paver", 40},
+                                   {"gravel", 40},
+                                   {"unpaved", 40},
+                                   {"ground", 40},
+                                   {"dirt", 40},
+                                   {"pebblestone", 40},
+                                   {"tartan", 40},
+                                   {"cobblestone", 30},
+                                   {"clay", 30},
+                                   {"earth", 20},
+                                   {"stone", 20},
+                                   {"rocky", 20},
+                                   {"sand", 20},
+                                   {"mud", 10}};
+
+const SpeedTable tracktype_speeds = {
+    {"grade1", 60}, {"grade2", 40}, {"grade3", 30}, {"grade4", 25}, {"grade5", 20}};
+
+const SpeedTable smoothness_speeds = {{"intermediate", 80},
+                                      {"bad", 40},
+                                      {"very_bad", 20},
+                                      {"horrible", 10},
+                                      {"very_horrible", 5},
+                                      {"impassable", 0}};
+
+// http://wiki.openstreetmap.org/wiki/Speed_limits
+const SpeedTable maxspeed_table_default = {
+    {"urban", 50}, {"rural", 90}, {"trunk", 110}, {"motorway", 130}};
+
+// List only exceptions
+const SpeedTable maxspeed_table = {{"ch:rural", 80},
+                                   {"ch:trunk", 100},
+                                   {"ch:motorway", 120},
+                                   {"de:living_street", 7},
+                                   {"ru:living_street", 20},
+                                   {"ru:urban", 60},
+                                   {"ua:urban", 60},
+                                   {"at:rural", 100},
+                                   {"de:rural", 100},
+                                   {"at:trunk", 100},
+                                   {"cz:trunk", 0},
+                                   {"ro:trunk", 100},
+                                   {"cz:motorway", 0},
+                                   {"de:motorway", 0},
+                                   {"ru:motorway", 110},
+                                   {"gb:nsl_single", (60 * 1609) / 1000.},
+                                   {"gb:nsl_dual", (70 * 1609) / 1000.},
+                                   {"gb:motorway", (70 * 1609) / 1000.},
+                                   {"uk:nsl_single", (60 * 1609) / 1000.},
+                                   {"uk:nsl_dual", (70 * 1609) / 1000.},
+                                   {"uk:motorway", (70 * 1609) / 1000.},
+                                   {"nl:rural", 80},
+                                   {"nl:trunk", 100},
+                                   {"none", 140}};
+
+// Guidance: Default Mapping from roads to types/priorities
+const std::unordered_map<std::string, guidance::RoadPriorityClass::Enum> highway_classes = {
+    {"motorway", guidance::RoadPriorityClass::MOTORWAY},
+    {"motorway_link", guidance::RoadPriorityClass::LINK_ROAD},
+    {"trunk", guidance::RoadPriorityClass::TRUNK},
+    {"trunk_link", guidance::RoadPriorityClass::LINK_ROAD},
+    {"primary", guidance::RoadPriorityClass::PRIMARY},
+    {"primary_link", guidance::RoadPriorityClass::LINK_ROAD},
+    {"secondary", guidance::RoadPriorityClass::SECONDARY},
+    {"secondary_link", guidance::RoadPriorityClass::LINK_ROAD},
+    {"tertiary", guidance::RoadPriorityClass::TERTIARY},
+    {"tertiary_link", guidance::RoadPriorityClass::LINK_ROAD},
+    {"unclassified", guidance::RoadPriorityClass::SIDE_RESIDENTIAL},
+    {"residential", guidance::RoadPriorityClass::SIDE_RESIDENTIAL},
+    {"service", guidance::RoadPriorityClass::CONNECTIVITY},
+    {"living_street", guidance::RoadPriorityClass::MAIN_RESIDENTIAL},
+    {"track", guidance::RoadPriorityClass::BIKE_PATH},
+    {"path", guidance::RoadPriorityClass::BIKE_PATH},
+    {"footway", guidance::RoadPriorityClass::FOOT_PATH},
+    {"pedestrian", guidance::RoadPriorityClass::FOOT_PATH},
+    {"steps", guidance::RoadPriorityClass::FOOT_PATH}};
+
+const guidance::RoadPriorityClass::Enum default_highway_class =
+    guidance::RoadPriorityClass::CONNECTIVITY;
+
+const StringSet motorway_types = {"motorway", "motorway_link", "trunk", "trunk_link"};
+
+// these road types are set with a car in mind
+const StringSet road_types = {"motorway",
+                              "motorway_link",
+                              "trunk",
+                              "trunk_link",
+                              "primary",
+                              "primary_link",
+                              "secondary",
+                              "secondary_link",
+                              "tertiary",
+                              "tertiary_link",
+                              "unclassified",
+                              "residential",
+                              "living_street"};
+
+const StringSet link_types = {
+    "motorway_link", "trunk_link", "primary_link", "secondary_link", "tertiary_link"};
+
+const constexpr bool left_hand_driving = false;
+const constexpr double side_road_speed_multiplier = 0.8;
+const constexpr double turn_penalty = 7.5;
+// Note: this biases right-side driving. Should be inverted for left-driving countries.
+const constexpr double turn_bias = left_hand_driving ? 1 / 1.075 : 1.075;
+const constexpr bool obey_oneway = true;
+const constexpr bool ignore_areas = true;
+const constexpr bool ignore_hov_ways = true;
+const constexpr bool ignore_toll_ways = false;
+const constexpr double speed_reduction = 0.8;
+
+const constexpr double infinity = std::numeric_limits<double>::infinity();
+
+// Tag values are null if the tag is missing, this mirrors the nil checks of the lua profile
+bool isSet(const char *value) { return value != nullptr && *value != '\0'; }
+
+bool equals(const char *value, const char *expected)
+{
+    return value != nullptr && std::strcmp(value, expected) == 0;
+}
+
+bool contains(const StringSet &set, const char *value)
+{
+    return value != nullptr && set.count(value) > 0;
+}
+
+const double *lookup(const SpeedTable &table, const char *key)
+{
+    if (key == nullptr)
+        return nullptr;
+    const auto iter = table.find(key);
+    return iter == table.end() ? nullptr : &iter->second;
+}
+
+// tonumber(value:match("%d*")), the digits at the start of the value
+bool parseLeadingNumber(const char *value, double &number)
+{
+    if (value == nullptr)
+        return false;
+    const char *end = value;
+    while (std::isdigit(static_cast<unsigned char>(*end)))
+        ++end;
+    if (end == value)
+        return false;
+    number = std::strtod(std::string(value, end).c_str(), nullptr);
+    return true;
+}
+
+// tonumber(value), fails unless the whole value is a number
+bool parseNumber(const char *value, double &number)
+{
+    if (!isSet(value))
+        return false;
+    char *end = nullptr;
+    number = std::strtod(value, &end);
+    while (std::isspace(static_cast<unsigned char>(*end)))
+        ++end;
+    return end != value && *end == '\0';
+}
+
+template <typename OSMObject> std::string findAccessTag(const OSMObject &object)
+{
+    for (const auto key : access_tags_hierarchy)
+    {
+        const char *tag = object.get_value_by_key(key);
+        if (isSet(tag))
+            return tag;
+    }
+    return "";
+}
+
+double parseMaxspeed(const char *source)
+{
+    if (source == nullptr)
+        return 0;
+
+    double speed = 0;
+    if (parseLeadingNumber(source, speed))
+    {
+        if (std::strstr(source, "mph") != nullptr || std::strstr(source, "mp/h") != nullptr)
+        {
+            speed = (speed * 1609) / 1000;
+        }
+        return speed;
+    }
+
+    // parse maxspeed like FR:urban
+    const auto lower_source = boost::algorithm::to_lower_copy(std::string(source));
+    if (const auto *table_speed = lookup(maxspeed_table, lower_source.c_str()))
+    {
+        return *table_speed;
+    }
+
+    // the letters after the first "%a%a:"
+    const auto is_alpha = [](const char character) {
+        return std::isalpha(static_cast<unsigned char>(character)) != 0;
+    };
+    for (std::size_t index = 0; index + 3 < lower_source.size(); ++index)
+    {
+        if (is_alpha(lower_source[index]) && is_alpha(lower_source[index + 1]) &&
+            lower_source[index + 2] == ':' && is_alpha(lower_source[index + 3]))
+        {
+            const auto begin = lower_source.begin() + index + 3;
+            const auto highway_type =
+                std::string(begin, std::find_if_not(begin, lower_source.end(), is_alpha));
+            if (const auto *default_speed = lookup(maxspeed_table_default, highway_type.c_str()))
+            {
+                return *default_speed;
+            }
+            break;
+        }
+    }
+    return 0;
+}
+
+bool hasAllDesignatedHOVLanes(const std::string &lanes)
+{
+    std::size_t begin = 0;
+    while (true)
+    {
+        const auto end = lanes.find('|', begin);
+        if (lanes.compare(begin, end - begin, "designated") != 0)
+            return false;
+        if (end == std::string::npos)
+            return true;
+        begin = end + 1;
+    }
+}
+
+std::string getDestination(const osmium::Way &way, const bool is_forward)
+{
+    const char *destination = way.get_value_by_key("destination");
+    const char *destination_forward = way.get_value_by_key("destination:forward");
+    const char *destination_backward = way.get_value_by_key("destination:backward");
+    const char *destination_ref = way.get_value_by_key("destination:ref");
+    const char *destination_ref_forward = way.get_value_by_key("destination:ref:forward");
+    const char *destination_ref_backward = way.get_value_by_key("destination:ref:backward");
+
+    // Assemble destination as: "A59: Düsseldorf, Köln"
+    //          destination:ref  ^    ^  destination
+    std::string destinations;
+
+    if (destination_ref != nullptr)
+    {
+        if (is_forward && *destination_ref == '\0')
+        {
+            if (destination_ref_forward != nullptr)
+                destination_ref = destination_ref_forward;
+        }
+        else if (!is_forward)
+        {
+            if (destination_ref_backward != nullptr)
+                destination_ref = destination_ref_backward;
+        }
+
+        destinations += boost::algorithm::replace_all_copy(std::string(destination_ref), ";", ", ");
+    }
+
+    if (destination != nullptr)
+    {
+        if (is_forward && *destination == '\0')
+        {
+            if (destination_forward != nullptr)
+                destination = destination_forward;
+        }
+        else if (!is_forward)
+        {
+            if (destination_backward != nullptr)
+                destination = destination_backward;
+        }
+
+        if (*destination != '\0')
+        {
+            if (!destinations.empty())
+                destinations += ": ";
+
+            destinations += boost::algorithm::replace_all_copy(std::string(destination), ";", ", ");
+        }
+    }
+
+    return destinations;
+}
+
+void setClassification(const char *highway, ExtractionWay &result, const osmium::Way &way)
+{
+    auto &classification = result.road_classification;
+    if (contains(motorway_types, highway))
+        classification.SetMotorwayFlag(true);
+    if (contains(link_types, highway))
+        classification.SetLinkClass(true);
+
+    const auto highway_class =
+        highway == nullptr ? highway_classes.end() : highway_classes.find(highway);
+    classification.SetClass(highway_class != highway_classes.end() ? highway_class->second
+                                                                   : default_highway_class);
+    classification.SetLowPriorityFlag(!contains(road_types, highway));
+
+    double lane_count = 0;
+    const char *lanes = way.get_value_by_key("lanes");
+    if (isSet(lanes))
+    {
+        if (parseNumber(lanes, lane_count))
+            classification.SetNumberOfLanes(static_cast<std::uint8_t>(lane_count));
+    }
+    else
+    {
+        double total_count = 0;
+        if (parseNumber(way.get_value_by_key("lanes:forward"), lane_count))
+            total_count = lane_count;
+        if (parseNumber(way.get_value_by_key("lanes:backward"), lane_count))
+            total_count += lane_count;
+        if (total_count != 0)
+            classification.SetNumberOfLanes(static_cast<std::uint8_t>(total_count));
+    }
+}
+
+// trims lane string with regard to supported lanes
+std::string processLanes(const char *turn_lane,
+                         const char *vehicle_lane,
+                         const double first_count,
+                         const double second_count)
+{
+    if (!isSet(turn_lane))
+        return "";
+    if (isSet(vehicle_lane))
+        return applyAccessTokens(turn_lane, vehicle_lane);
+    if (first_count != 0 || second_count != 0)
+        return trimLaneString(turn_lane,
+                              static_cast<std::int32_t>(first_count),
+                              static_cast<std::int32_t>(second_count));
+    return turn_lane;
+}
+
+// this is broken for left-sided driving, like get_turn_lanes in lib/guidance.lua
+void setTurnLanes(const osmium::Way &way, ExtractionWay &result)
+{
+    // forward and backward psv lane count
+    double fw_psv = 0;
+    double bw_psv = 0;
+    if (isSet(way.get_value_by_key("lanes:psv")) &&
+        !parseNumber(way.get_value_by_key("lanes:psv"), fw_psv))
+        fw_psv = 0;
+    if (isSet(way.get_value_by_key("lanes:psv:forward")) &&
+        !parseNumber(way.get_value_by_key("lanes:psv:forward"), fw_psv))
+        fw_psv = 0;
+    if (isSet(way.get_value_by_key("lanes:psv:backward")) &&
+        !parseNumber(way.get_value_by_key("lanes:psv:backward"), bw_psv))
+        bw_psv = 0;
+
+    const auto turn_lanes = processLanes(way.get_value_by_key("turn:lanes"),
+                                         way.get_value_by_key("vehicle:lanes"),
+                                         bw_psv,
+                                         fw_psv);
+    const auto turn_lanes_forward = processLanes(way.get_value_by_key("turn:lanes:forward"),
+                                                 way.get_value_by_key("vehicle:lanes:forward"),
+                                                 bw_psv,
+                                                 fw_psv);
+    // backwards turn lanes need to treat bw_psv as fw_psv and vice versa
+    const auto turn_lanes_backward = processLanes(way.get_value_by_key("turn:lanes:backward"),
+                                                  way.get_value_by_key("vehicle:lanes:backward"),
+                                                  fw_psv,
+                                                  bw_psv);
+
+    if (!turn_lanes.empty())
+    {
+        result.turn_lanes_forward = turn_lanes;
+        result.turn_lanes_backward = turn_lanes;
+    }
+    else
+    {
+        if (!turn_lanes_forward.empty())
+            result.turn_lanes_forward = turn_lanes_forward;
+        if (!turn_lanes_backward.empty())
+            result.turn_lanes_backward = turn_lanes_backward;
+    }
+}
+
+class CarProfile final : public CompiledProfile
+{
+  public:
+    ProfileProperties GetProfileProperties() const override
+    {
+        ProfileProperties properties;
+        properties.SetUturnPenalty(20);
+        properties.SetTrafficSignalPenalty(2);
+        properties.use_turn_restrictions = true;
+        properties.continue_straight_at_waypoint = true;
+        properties.left_hand_driving = left_hand_driving;
+        return properties;
+    }
+
+    std::vector<std::string> GetNameSuffixList() const override { return suffix_list; }
+
+    std::vector<std::string> GetRestrictions() const override { return restrictions; }
+
+    void ProcessNode(const osmium::Node &node, ExtractionNode &result) const override
+    {
+        // parse access and barrier tags
+        const auto access = findAccessTag(node);
+        if (!access.empty())
+        {
+            if (access_tag_blacklist.count(access) > 0)
+                result.barrier = true;
+        }
+        else
+        {
+            const char *barrier = node.get_value_by_key("barrier");
+            if (isSet(barrier))
+            {
+                // make an exception for rising bollard barriers
+                const bool rising_bollard = equals(node.get_value_by_key("bollard"), "rising");
+
+                if (!contains(barrier_whitelist, barrier) && !rising_bollard)
+                    result.barrier = true;
+            }
+        }
+
+        // check if node is a traffic light
+        if (equals(node.get_value_by_key("highway"), "traffic_signals"))
+            result.traffic_lights = true;
+    }
+
+    void ProcessWay(const osmium::Way &way, ExtractionWay &result) const override
+    {
+        const char *highway = way.get_value_by_key("highway");
+        const char *route = way.get_value_by_key("route");
+        const char *bridge = way.get_value_by_key("bridge");
+
+        if (!(isSet(highway) || isSet(route) || isSet(bridge)))
+            return;
+
+        // default to driving mode, may get overwritten below
+        result.forward_travel_mode = TRAVEL_MODE_DRIVING;
+        result.backward_travel_mode = TRAVEL_MODE_DRIVING;
+
+        // we dont route over areas
+        if (ignore_areas && equals(way.get_value_by_key("area"), "yes"))
+            return;
+
+        const char *oneway = way.get_value_by_key("oneway");
+
+        // respect user-preference for HOV-only ways
+        if (ignore_hov_ways)
+        {
+            if (equals(way.get_value_by_key("hov"), "designated"))
+                return;
+
+            // also respect user-preference for HOV-only ways when all lanes are HOV-designated
+            const auto all_designated = [&way](const char *key) {
+                const char *lanes = way.get_value_by_key(key);
+                return isSet(lanes) && hasAllDesignatedHOVLanes(lanes);
+            };
+            const bool hov_all_designated = all_designated("hov:lanes");
+            const bool hov_all_designated_forward = all_designated("hov:lanes:forward");
+            const bool hov_all_designated_backward = all_designated("hov:lanes:backward");
+
+            // forward/backward lane depend on a way's direction
+            const bool reverse = equals(oneway, "-1");
+
+            if (hov_all_designated || hov_all_designated_forward)
+            {
+                if (reverse)
+                    result.backward_travel_mode = TRAVEL_MODE_INACCESSIBLE;
+                else
+                    result.forward_travel_mode = TRAVEL_MODE_INACCESSIBLE;
+            }
+
+            if (hov_all_designated_backward)
+            {
+                if (reverse)
+                    result.forward_travel_mode = TRAVEL_MODE_INACCESSIBLE;
+                else
+                    result.backward_travel_mode = TRAVEL_MODE_INACCESSIBLE;
+            }
+        }
+
+        // respect user-preference for toll=yes ways
+        if (ignore_toll_ways && equals(way.get_value_by_key("toll"), "yes"))
+            return;
+
+        // Reversible oneways change direction with low frequency (think twice a day):
+        // do not route over these at all at the moment because of time dependence.
+        // Note: alternating (high frequency) oneways are handled below with penalty.
+        if (equals(oneway, "reversible"))
+            return;
+
+        if (equals(way.get_value_by_key("impassable"), "yes"))
+            return;
+
+        if (equals(way.get_value_by_key("status"), "impassable"))
+            return;
+
+        // Check if we are allowed to access the way
+        const auto access = findAccessTag(way);
+        if (access_tag_blacklist.count(access) > 0)
+            return;
+
+        const auto set_duration = [&way, &result] {
+            const char *duration = way.get_value_by_key("duration");
+            if (duration != nullptr && durationIsValid(duration))
+                result.duration = std::max(parseDuration(duration), 1u);
+        };
+
+        // handling ferries and piers
+        const auto *route_speed = lookup(speed_profile, route);
+        if (route_speed != nullptr && *route_speed > 0)
+        {
+            highway = route;
+            set_duration();
+            result.forward_travel_mode = TRAVEL_MODE_FERRY;
+            result.backward_travel_mode = TRAVEL_MODE_FERRY;
+            result.forward_speed = *route_speed;
+            result.backward_speed = *route_speed;
+        }
+
+        // handling movable bridges
+        const auto *bridge_speed = lookup(speed_profile, bridge);
+        if (bridge_speed != nullptr && *bridge_speed > 0)
+        {
+            highway = bridge;
+            set_duration();
+            result.forward_speed = *bridge_speed;
+            result.backward_speed = *bridge_speed;
+        }
+
+        // leave early if this way is not accessible
+        if (highway != nullptr && *highway == '\0')
+            return;
+
+        if (result.forward_speed == -1)
+        {
+            const auto *highway_speed = lookup(speed_profile, highway);
+            double max_speed = parseMaxspeed(way.get_value_by_key("maxspeed"));
+            // Set the avg speed on the way if it is accessible by road class
+            if (highway_speed != nullptr)
+            {
+                if (max_speed > *highway_speed)
+                {
+                    result.forward_speed = max_speed;
+                    result.backward_speed = max_speed;
+                }
+                else
+                {
+                    result.forward_speed = *highway_speed;
+                    result.backward_speed = *highway_speed;
+                }
+            }
+            else
+            {
+                // Set the avg speed on ways that are marked accessible
+                if (access_tag_whitelist.count(access) > 0)
+                {
+                    result.forward_speed = speed_profile.at("default");
+                    result.backward_speed = speed_profile.at("default");
+                }
+            }
+            if (max_speed == 0)
+                max_speed = infinity;
+            result.forward_speed = std::min(result.forward_speed, max_speed);
+            result.backward_speed = std::min(result.backward_speed, max_speed);
+        }
+
+        if (result.forward_speed == -1 && result.backward_speed == -1)
+            return;
+
+        // reduce speed on special side roads
+        const char *sideway = way.get_value_by_key("side_road");
+        if (equals(sideway, "yes") || equals(sideway, "rotary"))
+        {
+            result.forward_speed *= side_road_speed_multiplier;
+            result.backward_speed *= side_road_speed_multiplier;
+        }
+
+        // reduce speed on bad surfaces
+        for (const auto &surface_limit :
+             {std::make_pair("surface", &surface_speeds),
+              std::make_pair("tracktype", &tracktype_speeds),
+              std::make_pair("smoothness", &smoothness_speeds)})
+        {
+            const auto *limit =
+                lookup(*surface_limit.second, way.get_value_by_key(surface_limit.first));
+            if (limit != nullptr)
+            {
+                result.forward_speed = std::min(*limit, result.forward_speed);
+                result.backward_speed = std::min(*limit, result.backward_speed);
+            }
+        }
+
+        // set the road classification based on guidance globals configuration
+        setClassification(highway, result, way);
+
+        // parse the remaining tags
+        const char *name = way.get_value_by_key("name");
+        const char *pronunciation = way.get_value_by_key("name:pronunciation");
+        const char *ref = way.get_value_by_key("ref");
+        const char *junction = way.get_value_by_key("junction");
+        const char *service = way.get_value_by_key("service");
+
+        // Set the name that will be used for instructions
+        if (isSet(name))
+            result.name = name;
+
+        if (isSet(ref))
+            result.ref = canonicalizeStringList(ref, ";");
+
+        if (isSet(pronunciation))
+            result.pronunciation = pronunciation;
+
+        setTurnLanes(way, result);
+
+        if (equals(junction, "roundabout"))
+            result.roundabout = true;
+
+        // Set access restriction flag if access is allowed under certain restrictions only
+        if (access_tag_restricted.count(access) > 0)
+            result.is_access_restricted = true;
+
+        if (isSet(service))
+        {
+            // Set access restriction flag if service is allowed under certain restrictions only
+            if (contains(service_tag_restricted, service))
+                result.is_access_restricted = true;
+
+            // Set don't allow access to certain service roads
+            if (contains(service_tag_forbidden, service))
+            {
+                result.forward_travel_mode = TRAVEL_MODE_INACCESSIBLE;
+                result.backward_travel_mode = TRAVEL_MODE_INACCESSIBLE;
+                return;
+            }
+        }
+
+        // Set direction according to tags on way
+        if (obey_oneway)
+        {
+            if (equals(oneway, "-1"))
+            {
+                result.forward_travel_mode = TRAVEL_MODE_INACCESSIBLE;
+                result.destinations = canonicalizeStringList(getDestination(way, false), ",");
+            }
+            else if (equals(oneway, "yes") || equals(oneway, "1") || equals(oneway, "true") ||
+                     equals(junction, "roundabout") ||
+                     (equals(highway, "motorway") && !equals(oneway, "no")))
+            {
+                result.backward_travel_mode = TRAVEL_MODE_INACCESSIBLE;
+                result.destinations = canonicalizeStringList(getDestination(way, true), ",");
+            }
+        }
+
+        const auto is_bidirectional_mode = [&result] {
+            return result.forward_travel_mode != TRAVEL_MODE_INACCESSIBLE &&
+                   result.backward_travel_mode != TRAVEL_MODE_INACCESSIBLE;
+        };
+
+        // Override speed settings if explicit forward/backward maxspeeds are given
+        const double maxspeed_forward = parseMaxspeed(way.get_value_by_key("maxspeed:forward"));
+        const double maxspeed_backward = parseMaxspeed(way.get_value_by_key("maxspeed:backward"));
+        if (maxspeed_forward > 0)
+        {
+            if (is_bidirectional_mode())
+                result.backward_speed = result.forward_speed;
+            result.forward_speed = maxspeed_forward;
+        }
+        if (maxspeed_backward > 0)
+            result.backward_speed = maxspeed_backward;
+
+        // Override speed settings if advisory forward/backward maxspeeds are given
+        const double advisory_speed = parseMaxspeed(way.get_value_by_key("maxspeed:advisory"));
+        const double advisory_forward =
+            parseMaxspeed(way.get_value_by_key("maxspeed:advisory:forward"));
+        const double advisory_backward =
+            parseMaxspeed(way.get_value_by_key("maxspeed:advisory:backward"));
+        // apply bi-directional advisory speed first
+        if (advisory_speed > 0)
+        {
+            if (result.forward_travel_mode != TRAVEL_MODE_INACCESSIBLE)
+                result.forward_speed = advisory_speed;
+            if (result.backward_travel_mode != TRAVEL_MODE_INACCESSIBLE)
+                result.backward_speed = advisory_speed;
+        }
+        if (advisory_forward > 0)
+        {
+            if (is_bidirectional_mode())
+                result.backward_speed = result.forward_speed;
+            result.forward_speed = advisory_forward;
+        }
+        if (advisory_backward > 0)
+            result.backward_speed = advisory_backward;
+
+        double width = infinity;
+        double lanes = infinity;
+        if (result.forward_speed > 0 || result.backward_speed > 0)
+        {
+            parseLeadingNumber(way.get_value_by_key("width"), width);
+            parseLeadingNumber(way.get_value_by_key("lanes"), lanes);
+        }
+
+        const bool is_bidirectional = is_bidirectional_mode();
+        const auto *service_speed = isSet(service) ? lookup(service_speeds, service) : nullptr;
+
+        // scale speeds to get better avg driving times
+        const auto scale_speed = [&](const double speed) {
+            const double scaled_speed = speed * speed_reduction;
+            double penalized_speed = infinity;
+            if (service_speed != nullptr)
+                penalized_speed = *service_speed;
+            else if (width <= 3 || (lanes <= 1 && is_bidirectional))
+                penalized_speed = speed / 2;
+            return std::min(penalized_speed, scaled_speed);
+        };
+        if (result.forward_speed > 0)
+            result.forward_speed = scale_speed(result.forward_speed);
+        if (result.backward_speed > 0)
+            result.backward_speed = scale_speed(result.backward_speed);
+
+        // Handle high frequency reversible oneways (think traffic signal controlled, changing
+        // direction every 15 minutes). Scaling speed to take average waiting time into account
+        // plus some more for start / stop.
+        if (equals(oneway, "alternating"))
+        {
+            const double scaling_factor = 0.4;
+            if (result.forward_speed != infinity)
+                result.forward_speed *= scaling_factor;
+            if (result.backward_speed != infinity)
+                result.backward_speed *= scaling_factor;
+        }
+
+        // only allow this road as start point if it not a ferry
+        result.is_startpoint = result.forward_travel_mode == TRAVEL_MODE_DRIVING ||
+                               result.backward_travel_mode == TRAVEL_MODE_DRIVING;
+    }
+
+    double GetTurnPenalty(const double angle) const override
+    {
+        // Use a sigmoid function to return a penalty that maxes out at turn_penalty
+        // over the space of 0-180 degrees.  Values here were chosen by fitting
+        // the function to some turn penalty samples from real driving.
+        // multiplying by 10 converts to deci-seconds see issue #1318
+        if (angle >= 0)
+        {
+            return 10 * turn_penalty /
+                   (1 + std::pow(2.718, -((13 / turn_bias) * angle / 180 - 6.5 * turn_bias)));
+        }
+        return 10 * turn_penalty /
+               (1 + std::pow(2.718, -((13 * turn_bias) * -angle / 180 - 6.5 / turn_bias)));
+    }
+};
+}
+
+OSRM_COMPILED_PROFILE(CarProfile)
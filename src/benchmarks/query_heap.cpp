@@ -0,0 +1,130 @@
+#include "util/timing_util.hpp"
+
+#include "osrm/route_parameters.hpp"
+#include "osrm/table_parameters.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cstdlib>
+
+using namespace osrm;
+
+namespace
+{
+
+std::vector<util::Coordinate> makeCoordinates(const std::size_t number_of_coordinates)
+{
+    // Random coordinates in monaco, chosen by a fixed seed to be comparable between runs
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> lon_distribution(7.409, 7.439);
+    std::uniform_real_distribution<double> lat_distribution(43.725, 43.751);
+
+    std::vector<util::Coordinate> coordinates;
+    for (std::size_t i = 0; i < number_of_coordinates; ++i)
+    {
+        coordinates.push_back(util::Coordinate{util::FloatLongitude{lon_distribution(generator)},
+                                               util::FloatLatitude{lat_distribution(generator)}});
+    }
+    return coordinates;
+}
+
+// Runs a fixed Route and Table workload. Each run happens on a new thread so that the thread
+// local search heaps are created with the heap index storage configured for this engine.
+bool runWorkload(const std::string &name, EngineConfig config)
+{
+    bool success = true;
+    std::thread worker([&] {
+        OSRM osrm{config};
+
+        const auto coordinates = makeCoordinates(200);
+
+        TIMER_START(routes);
+        for (std::size_t i = 0; i + 1 < coordinates.size(); ++i)
+        {
+            RouteParameters params;
+            params.overview = RouteParameters::OverviewType::False;
+            params.steps = false;
+            params.coordinates.push_back(coordinates[i]);
+            params.coordinates.push_back(coordinates[i + 1]);
+
+            json::Object result;
+            if (osrm.Route(params, result) != Status::Ok)
+            {
+                success = false;
+                return;
+            }
+        }
+        TIMER_STOP(routes);
+
+        TableParameters params;
+        params.coordinates = coordinates;
+
+        const auto NUM = 10;
+        TIMER_START(tables);
+        for (int i = 0; i < NUM; ++i)
+        {
+            json::Object result;
+            if (osrm.Table(params, result) != Status::Ok)
+            {
+                success = false;
+                return;
+            }
+        }
+        TIMER_STOP(tables);
+
+        std::cout << name << ": " << (TIMER_MSEC(routes) / (coordinates.size() - 1))
+                  << "ms/route, " << (TIMER_MSEC(tables) / NUM) << "ms/table at "
+                  << coordinates.size() << "x" << coordinates.size() << std::endl;
+    });
+    worker.join();
+    return success;
+}
+}
+
+int main(int argc, const char *argv[]) try
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " data.osrm\n";
+        return EXIT_FAILURE;
+    }
+
+    // Configure based on a .osrm base path, and no datasets in shared mem from osrm-datastore
+    EngineConfig config;
+    config.storage_config = {argv[1]};
+    config.use_shared_memory = false;
+
+    // hash map based heap index
+    config.max_dense_heap_nodes = 0;
+    if (!runWorkload("unordered_map", config))
+    {
+        return EXIT_FAILURE;
+    }
+
+    // dense heap index with time stamps
+    config.max_dense_heap_nodes = -1;
+    if (!runWorkload("generation array", config))
+    {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
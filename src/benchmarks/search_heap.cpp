@@ -0,0 +1,212 @@
+#include "contractor/graph_contractor.hpp"
+#include "extractor/edge_based_edge.hpp"
+#include "util/binary_heap.hpp"
+#include "util/d_ary_heap.hpp"
+#include "util/deallocating_vector.hpp"
+#include "util/search_heap.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+
+#include <tbb/task_scheduler_init.h>
+
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstdlib>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Choosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 13;
+constexpr unsigned NUM_QUERIES = 1000;
+
+struct GridEdge
+{
+    NodeID source;
+    NodeID target;
+    EdgeWeight weight;
+};
+
+// Grid with random edge weights in both directions, a rough stand-in for a road network
+std::vector<GridEdge> makeGrid(const unsigned grid_size)
+{
+    std::mt19937 generator(RANDOM_SEED);
+    std::uniform_int_distribution<EdgeWeight> weight_distribution(10, 100);
+
+    std::vector<GridEdge> edges;
+    for (unsigned row = 0; row < grid_size; ++row)
+    {
+        for (unsigned column = 0; column < grid_size; ++column)
+        {
+            const NodeID node = row * grid_size + column;
+            if (column + 1 < grid_size)
+            {
+                const auto weight = weight_distribution(generator);
+                edges.push_back({node, node + 1, weight});
+                edges.push_back({node + 1, node, weight});
+            }
+            if (row + 1 < grid_size)
+            {
+                const auto weight = weight_distribution(generator);
+                edges.push_back({node, node + grid_size, weight});
+                edges.push_back({node + grid_size, node, weight});
+            }
+        }
+    }
+    return edges;
+}
+
+struct AdjacencyArray
+{
+    explicit AdjacencyArray(const unsigned number_of_nodes, const std::vector<GridEdge> &edges)
+        : first_edge(number_of_nodes + 1, 0)
+    {
+        for (const auto &edge : edges)
+        {
+            ++first_edge[edge.source + 1];
+        }
+        for (unsigned node = 0; node < number_of_nodes; ++node)
+        {
+            first_edge[node + 1] += first_edge[node];
+        }
+        targets.resize(edges.size());
+        weights.resize(edges.size());
+        auto next_edge = first_edge;
+        for (const auto &edge : edges)
+        {
+            const auto position = next_edge[edge.source]++;
+            targets[position] = edge.target;
+            weights[position] = edge.weight;
+        }
+    }
+
+    std::vector<unsigned> first_edge;
+    std::vector<NodeID> targets;
+    std::vector<EdgeWeight> weights;
+};
+
+struct HeapData
+{
+    NodeID parent;
+    /* explicit */ HeapData(NodeID p) : parent(p) {}
+};
+
+template <typename Heap>
+void benchmarkSearches(const std::string &name,
+                       const AdjacencyArray &graph,
+                       const std::vector<std::pair<NodeID, NodeID>> &queries)
+{
+    const auto number_of_nodes = graph.first_edge.size() - 1;
+    Heap heap(number_of_nodes);
+
+    EdgeWeight checksum = 0;
+    TIMER_START(search);
+    for (const auto &query : queries)
+    {
+        heap.Clear();
+        heap.Insert(query.first, 0, query.first);
+        while (!heap.Empty())
+        {
+            const NodeID node = heap.DeleteMin();
+            const EdgeWeight weight = heap.GetKey(node);
+            if (node == query.second)
+            {
+                checksum += weight;
+                break;
+            }
+            for (auto edge = graph.first_edge[node]; edge < graph.first_edge[node + 1]; ++edge)
+            {
+                const NodeID to = graph.targets[edge];
+                const EdgeWeight to_weight = weight + graph.weights[edge];
+                if (!heap.WasInserted(to))
+                {
+                    heap.Insert(to, to_weight, node);
+                }
+                else if (to_weight < heap.GetKey(to))
+                {
+                    heap.GetData(to).parent = node;
+                    heap.DecreaseKey(to, to_weight);
+                }
+            }
+        }
+    }
+    TIMER_STOP(search);
+
+    std::cout << name << ": " << (TIMER_MSEC(search) / queries.size()) << "ms/query"
+              << " (checksum " << checksum << ")" << std::endl;
+}
+
+void benchmarkContraction(const unsigned number_of_nodes, const std::vector<GridEdge> &edges)
+{
+    util::DeallocatingVector<extractor::EdgeBasedEdge> edge_based_edges;
+    for (const auto &edge : edges)
+    {
+        // every grid edge is listed in both directions, so only add it as forward edge
+        edge_based_edges.push_back(extractor::EdgeBasedEdge(
+            edge.source, edge.target, edge_based_edges.size(), edge.weight, true, false));
+    }
+
+    std::vector<float> node_levels;
+    std::vector<EdgeWeight> node_weights(number_of_nodes, 1);
+
+    TIMER_START(contraction);
+    contractor::GraphContractor graph_contractor(
+        number_of_nodes, edge_based_edges, std::move(node_levels), std::move(node_weights));
+    graph_contractor.Run();
+    TIMER_STOP(contraction);
+
+#ifdef OSRM_ENABLE_DARY_HEAP
+    std::cout << "contraction with 4-ary heap: ";
+#else
+    std::cout << "contraction with binary heap: ";
+#endif
+    std::cout << TIMER_SEC(contraction) << "s for " << number_of_nodes << " nodes" << std::endl;
+}
+}
+}
+
+int main(int argc, char **argv) try
+{
+    using namespace osrm;
+    using namespace osrm::benchmarks;
+
+    const unsigned grid_size = argc > 1 ? std::stoul(argv[1]) : 300;
+    const unsigned number_of_nodes = grid_size * grid_size;
+
+    tbb::task_scheduler_init init(tbb::task_scheduler_init::default_num_threads());
+
+    const auto edges = makeGrid(grid_size);
+    const AdjacencyArray graph(number_of_nodes, edges);
+
+    std::mt19937 generator(RANDOM_SEED);
+    std::uniform_int_distribution<NodeID> node_distribution(0, number_of_nodes - 1);
+    std::vector<std::pair<NodeID, NodeID>> queries;
+    for (unsigned i = 0; i < NUM_QUERIES; ++i)
+    {
+        queries.emplace_back(node_distribution(generator), node_distribution(generator));
+    }
+
+    using Storage = util::GenerationArrayStorage<NodeID, NodeID>;
+    benchmarkSearches<util::BinaryHeap<NodeID, NodeID, EdgeWeight, HeapData, Storage>>(
+        "binary heap", graph, queries);
+    benchmarkSearches<util::DAryHeap<NodeID, NodeID, EdgeWeight, HeapData, Storage, 4>>(
+        "4-ary heap", graph, queries);
+
+    // The contractor uses the heap selected at build time (ENABLE_DARY_HEAP), compare the
+    // output of two builds for the effect on contraction time
+    benchmarkContraction(number_of_nodes, edges);
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
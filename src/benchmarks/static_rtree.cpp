@@ -4,6 +4,9 @@
 #include "mocks/mock_datafacade.hpp"
 #include "engine/geospatial_query.hpp"
 #include "util/coordinate.hpp"
+#include "util/page_faults.hpp"
+#include "util/rtree_kernels.hpp"
+#include "util/rtree_warmup.hpp"
 #include "util/timing_util.hpp"
 
 #include <iostream>
@@ -28,6 +31,9 @@ constexpr int32_t WORLD_MAX_LON = 180 * COORDINATE_PRECISION;
 using RTreeLeaf = extractor::EdgeBasedNode;
 using BenchStaticRTree =
     util::StaticRTree<RTreeLeaf, util::ShM<util::Coordinate, false>::vector, false>;
+// leaves without the projected coordinates of the segments
+using LookupStaticRTree = util::
+    StaticRTree<RTreeLeaf, util::ShM<util::Coordinate, false>::vector, false, 128, 4096, false>;
 
 std::vector<util::Coordinate> loadCoordinates(const boost::filesystem::path &nodes_file)
 {
@@ -52,6 +58,7 @@ void benchmarkQuery(const std::vector<util::Coordinate> &queries,
 {
     std::cout << "Running " << name << " with " << queries.size() << " coordinates: " << std::flush;
 
+    const auto faults_before = util::getPageFaults();
     TIMER_START(query);
     for (const auto &q : queries)
     {
@@ -59,15 +66,34 @@ void benchmarkQuery(const std::vector<util::Coordinate> &queries,
         (void)result;
     }
     TIMER_STOP(query);
+    const auto faults = util::getPageFaults() - faults_before;
 
     std::cout << "Took " << TIMER_SEC(query) << " seconds "
               << "(" << TIMER_MSEC(query) << "ms"
               << ")  ->  " << TIMER_MSEC(query) / queries.size() << " ms/query "
               << "(" << TIMER_MSEC(query) << "ms"
-              << ")" << std::endl;
+              << ")  ->  " << queries.size() / TIMER_SEC(query) << " queries/s"
+              << "  (" << faults.major << " major, " << faults.minor << " minor page faults)"
+              << std::endl;
 }
 
-void benchmark(BenchStaticRTree &rtree, unsigned num_queries)
+std::vector<RTreeLeaf> loadLeafObjects(const boost::filesystem::path &leaf_file)
+{
+    boost::filesystem::ifstream leaf_input_stream(leaf_file, std::ios::binary);
+
+    std::vector<RTreeLeaf> objects;
+    BenchStaticRTree::LeafNode current_leaf;
+    while (leaf_input_stream.read((char *)&current_leaf, sizeof(current_leaf)))
+    {
+        for (std::uint32_t i = 0; i < current_leaf.object_count; ++i)
+        {
+            objects.push_back(BenchStaticRTree::GetEdgeData(current_leaf.objects[i]));
+        }
+    }
+    return objects;
+}
+
+std::vector<util::Coordinate> randomCoordinates(unsigned num_queries)
 {
     std::mt19937 mt_rand(RANDOM_SEED);
     std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
@@ -78,14 +104,129 @@ void benchmark(BenchStaticRTree &rtree, unsigned num_queries)
         queries.emplace_back(util::FixedLongitude{lon_udist(mt_rand)},
                              util::FixedLatitude{lat_udist(mt_rand)});
     }
+    return queries;
+}
+
+template <typename RTreeT>
+void benchmark(const std::string &name, RTreeT &rtree, unsigned num_queries)
+{
+    const auto queries = randomCoordinates(num_queries);
 
-    benchmarkQuery(queries, "raw RTree queries (1 result)", [&rtree](const util::Coordinate &q) {
+    benchmarkQuery(queries, name + " queries (1 result)", [&rtree](const util::Coordinate &q) {
         return rtree.Nearest(q, 1);
     });
-    benchmarkQuery(queries, "raw RTree queries (10 results)", [&rtree](const util::Coordinate &q) {
+    benchmarkQuery(queries, name + " queries (10 results)", [&rtree](const util::Coordinate &q) {
         return rtree.Nearest(q, 10);
     });
 }
+
+// Runs nearest and box queries with every instruction set of the distance kernels
+void benchmarkKernels(BenchStaticRTree &rtree, unsigned num_queries)
+{
+    using util::rtree_kernels::InstructionSet;
+
+    const auto queries = randomCoordinates(num_queries);
+    // boxes of about 1km around the coordinates
+    const std::int32_t BOX_RADIUS = 0.005 * COORDINATE_PRECISION;
+
+    const auto supported = util::rtree_kernels::getSupportedInstructionSet();
+    for (const auto instruction_set :
+         {InstructionSet::Scalar, InstructionSet::SSE41, InstructionSet::AVX2})
+    {
+        if (instruction_set > supported)
+            break;
+
+        util::rtree_kernels::setInstructionSet(instruction_set);
+        const std::string name = util::rtree_kernels::toString(instruction_set);
+
+        const auto nearest_query = [&rtree](const util::Coordinate &q) {
+            return rtree.Nearest(q, 1);
+        };
+        const auto k_nearest_query = [&rtree](const util::Coordinate &q) {
+            return rtree.Nearest(q, 10);
+        };
+        const auto box_query = [&rtree, BOX_RADIUS](const util::Coordinate &q) {
+            const auto lon = static_cast<std::int32_t>(q.lon);
+            const auto lat = static_cast<std::int32_t>(q.lat);
+            const BenchStaticRTree::Rectangle box{
+                util::FixedLongitude{std::max(lon - BOX_RADIUS, WORLD_MIN_LON)},
+                util::FixedLongitude{std::min(lon + BOX_RADIUS, WORLD_MAX_LON)},
+                util::FixedLatitude{std::max(lat - BOX_RADIUS, WORLD_MIN_LAT)},
+                util::FixedLatitude{std::min(lat + BOX_RADIUS, WORLD_MAX_LAT)}};
+            return rtree.SearchInBox(box);
+        };
+
+        benchmarkQuery(queries, name + " k-NN queries (1 result)", nearest_query);
+        benchmarkQuery(queries, name + " k-NN queries (10 results)", k_nearest_query);
+        benchmarkQuery(queries, name + " box queries", box_query);
+    }
+    util::rtree_kernels::setInstructionSet(supported);
+}
+
+// Compares snapping the coordinates of a request one by one with snapping them as one batch. The
+// coordinates of a request are spread over about 10km around a node, like the coordinates of a
+// table request in a city.
+void benchmarkSnapping(BenchStaticRTree &rtree, const std::vector<util::Coordinate> &coords)
+{
+    using PhantomNodePair = std::pair<engine::PhantomNode, engine::PhantomNode>;
+    constexpr std::size_t COORDINATES_PER_RUN = 100000;
+    const std::int32_t REQUEST_RADIUS = 0.05 * COORDINATE_PRECISION;
+
+    MockDataFacade mockfacade;
+    engine::GeospatialQuery<BenchStaticRTree, MockDataFacade> query(rtree, coords, mockfacade);
+
+    std::mt19937 mt_rand(RANDOM_SEED);
+    std::uniform_int_distribution<std::size_t> node_udist(0, coords.size() - 1);
+    std::uniform_int_distribution<std::int32_t> offset_udist(-REQUEST_RADIUS, REQUEST_RADIUS);
+
+    for (const std::size_t request_size : {2, 10, 31, 32, 100, 1000})
+    {
+        std::vector<std::vector<util::Coordinate>> requests(COORDINATES_PER_RUN / request_size);
+        for (auto &request : requests)
+        {
+            const auto center = coords[node_udist(mt_rand)];
+            for (std::size_t i = 0; i < request_size; ++i)
+            {
+                const auto lon = static_cast<std::int32_t>(center.lon) + offset_udist(mt_rand);
+                const auto lat = static_cast<std::int32_t>(center.lat) + offset_udist(mt_rand);
+                request.emplace_back(
+                    util::FixedLongitude{std::min(std::max(lon, WORLD_MIN_LON), WORLD_MAX_LON)},
+                    util::FixedLatitude{std::min(std::max(lat, WORLD_MIN_LAT), WORLD_MAX_LAT)});
+            }
+        }
+
+        const auto run = [&](const std::string &name, const auto &snap) {
+            TIMER_START(snapping);
+            for (const auto &request : requests)
+            {
+                auto result = snap(request);
+                (void)result;
+            }
+            TIMER_STOP(snapping);
+            std::cout << name << " with " << request_size << " coordinates per request: "
+                      << TIMER_MSEC(snapping) / requests.size() << " ms/request" << std::endl;
+        };
+
+        run("serial snapping", [&query](const std::vector<util::Coordinate> &request) {
+            std::vector<PhantomNodePair> phantom_node_pairs;
+            phantom_node_pairs.reserve(request.size());
+            for (const auto &coordinate : request)
+            {
+                phantom_node_pairs.push_back(
+                    query.NearestPhantomNodeWithAlternativeFromBigComponent(coordinate));
+            }
+            return phantom_node_pairs;
+        });
+        run("batch snapping on 1 thread", [&query](const std::vector<util::Coordinate> &request) {
+            return query.NearestPhantomNodesWithAlternativeFromBigComponent(request, {}, {}, 1);
+        });
+        run("batch snapping on all threads",
+            [&query](const std::vector<util::Coordinate> &request) {
+                return query.NearestPhantomNodesWithAlternativeFromBigComponent(
+                    request, {}, {}, -1);
+            });
+    }
+}
 }
 }
 
@@ -93,7 +234,8 @@ int main(int argc, char **argv)
 {
     if (argc < 4)
     {
-        std::cout << "./rtree-bench file.ramIndex file.fileIndx file.nodes"
+        std::cout << "./rtree-bench file.ramIndex file.fileIndx file.nodes "
+                  << "[kernels|snapping|none|advise|populate|hot-pages]"
                   << "\n";
         return 1;
     }
@@ -106,7 +248,51 @@ int main(int argc, char **argv)
 
     osrm::benchmarks::BenchStaticRTree rtree(ram_path, file_path, coords);
 
-    osrm::benchmarks::benchmark(rtree, 10000);
+    if (argc > 4 && std::string(argv[4]) == "kernels")
+    {
+        osrm::benchmarks::benchmarkKernels(rtree, 10000);
+        return 0;
+    }
+
+    if (argc > 4 && std::string(argv[4]) == "snapping")
+    {
+        osrm::benchmarks::benchmarkSnapping(rtree, coords);
+        return 0;
+    }
+
+    // hot-pages replays the pages that were resident after the last run
+    auto warmup = osrm::util::RTreeWarmup::None;
+    const auto hot_pages_path = std::string(file_path) + ".hotPages";
+    if (argc > 4 && !osrm::util::parseRTreeWarmup(argv[4], warmup))
+    {
+        std::cout << "Unknown R-tree warm-up " << argv[4] << "\n";
+        return 1;
+    }
+    rtree.WarmUpLeaves(warmup, hot_pages_path);
+
+    osrm::benchmarks::benchmark("raw RTree", rtree, 10000);
+
+    if (warmup == osrm::util::RTreeWarmup::HotPages)
+    {
+        rtree.SaveHotLeafPages(hot_pages_path);
+    }
+
+    // compare with leaves that look up the coordinates of their segments
+    const auto lookup_ram_path = boost::filesystem::temp_directory_path() /
+                                 boost::filesystem::unique_path("%%%%-%%%%.ramIndex");
+    const auto lookup_file_path = boost::filesystem::temp_directory_path() /
+                                  boost::filesystem::unique_path("%%%%-%%%%.fileIndex");
+    {
+        osrm::benchmarks::LookupStaticRTree lookup_rtree(
+            osrm::benchmarks::loadLeafObjects(file_path),
+            lookup_ram_path.string(),
+            lookup_file_path.string(),
+            coords);
+
+        osrm::benchmarks::benchmark("coordinate lookup RTree", lookup_rtree, 10000);
+    }
+    boost::filesystem::remove(lookup_ram_path);
+    boost::filesystem::remove(lookup_file_path);
 
     return 0;
 }
@@ -0,0 +1,236 @@
+#include "engine/routing_algorithms/node_bucket_index.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+
+#include "osrm/table_parameters.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <cstdlib>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Choosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 13;
+constexpr NodeID NUMBER_OF_NODES = 1000000;
+constexpr unsigned SEARCH_SPACE_SIZE = 1000;
+
+struct NodeBucket
+{
+    NodeID middle_node;
+    unsigned target_id;
+    EdgeWeight weight;
+
+    bool operator<(const NodeBucket &rhs) const
+    {
+        return std::tie(middle_node, target_id) < std::tie(rhs.middle_node, rhs.target_id);
+    }
+};
+
+// Search spaces of a contraction hierarchy overlap at the important nodes, here the nodes with
+// small ids are drawn far more often than the others
+std::vector<std::vector<NodeID>> makeSearchSpaces(const std::size_t number_of_searches,
+                                                  std::mt19937 &generator)
+{
+    std::uniform_real_distribution<double> distribution(0, 1);
+    std::vector<std::vector<NodeID>> search_spaces(number_of_searches);
+    for (auto &search_space : search_spaces)
+    {
+        for (unsigned i = 0; i < SEARCH_SPACE_SIZE; ++i)
+        {
+            search_space.push_back(
+                static_cast<NodeID>(NUMBER_OF_NODES * std::pow(distribution(generator), 4)));
+        }
+        std::sort(search_space.begin(), search_space.end());
+        search_space.erase(std::unique(search_space.begin(), search_space.end()),
+                           search_space.end());
+        std::shuffle(search_space.begin(), search_space.end(), generator);
+    }
+    return search_spaces;
+}
+
+// Compares the bucket store of the many-to-many searches with the unordered_map of vectors it
+// replaced. Runs the bucket accesses of a number_of_coordinates square table on synthetic search
+// spaces, without the searches themselves.
+void benchmarkBucketStores(const std::size_t number_of_coordinates)
+{
+    std::mt19937 generator(RANDOM_SEED);
+    const auto backward_search_spaces = makeSearchSpaces(number_of_coordinates, generator);
+    const auto forward_search_spaces = makeSearchSpaces(number_of_coordinates, generator);
+
+    std::vector<EdgeWeight> result_table(number_of_coordinates * number_of_coordinates);
+    const auto checksum = [&result_table] {
+        std::uint64_t sum = 0;
+        for (const auto weight : result_table)
+        {
+            sum += weight;
+        }
+        return sum;
+    };
+
+    std::fill(result_table.begin(), result_table.end(), INVALID_EDGE_WEIGHT);
+    TIMER_START(unordered_map);
+    {
+        std::unordered_map<NodeID, std::vector<NodeBucket>> buckets;
+        for (unsigned column = 0; column < number_of_coordinates; ++column)
+        {
+            EdgeWeight weight = 0;
+            for (const auto node : backward_search_spaces[column])
+            {
+                buckets[node].push_back(NodeBucket{node, column, weight++});
+            }
+        }
+        for (std::size_t row = 0; row < number_of_coordinates; ++row)
+        {
+            EdgeWeight weight = 0;
+            for (const auto node : forward_search_spaces[row])
+            {
+                const auto node_buckets = buckets.find(node);
+                if (node_buckets != buckets.end())
+                {
+                    for (const auto &bucket : node_buckets->second)
+                    {
+                        auto &result = result_table[row * number_of_coordinates + bucket.target_id];
+                        result = std::min(result, weight + bucket.weight);
+                    }
+                }
+                ++weight;
+            }
+        }
+    }
+    TIMER_STOP(unordered_map);
+    std::cout << "unordered_map buckets: " << TIMER_MSEC(unordered_map) << "ms (checksum "
+              << checksum() << ")" << std::endl;
+
+    std::fill(result_table.begin(), result_table.end(), INVALID_EDGE_WEIGHT);
+    TIMER_START(flat);
+    {
+        std::vector<NodeBucket> buckets;
+        for (unsigned column = 0; column < number_of_coordinates; ++column)
+        {
+            EdgeWeight weight = 0;
+            for (const auto node : backward_search_spaces[column])
+            {
+                buckets.push_back(NodeBucket{node, column, weight++});
+            }
+        }
+        std::sort(buckets.begin(), buckets.end());
+        engine::routing_algorithms::NodeBucketIndex bucket_index;
+        bucket_index.Build(buckets);
+
+        for (std::size_t row = 0; row < number_of_coordinates; ++row)
+        {
+            EdgeWeight weight = 0;
+            for (const auto node : forward_search_spaces[row])
+            {
+                const auto bucket_range = bucket_index.Find(node);
+                for (auto index = bucket_range.first; index < bucket_range.second; ++index)
+                {
+                    const auto &bucket = buckets[index];
+                    auto &result = result_table[row * number_of_coordinates + bucket.target_id];
+                    result = std::min(result, weight + bucket.weight);
+                }
+                ++weight;
+            }
+        }
+    }
+    TIMER_STOP(flat);
+    std::cout << "flat buckets: " << TIMER_MSEC(flat) << "ms (checksum " << checksum() << ")"
+              << std::endl;
+}
+}
+}
+
+int main(int argc, const char *argv[]) try
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " data.osrm|buckets [number of coordinates]\n";
+        return EXIT_FAILURE;
+    }
+
+    const std::size_t number_of_coordinates = argc > 2 ? std::stoul(argv[2]) : 250;
+
+    // only the bucket stores, runs without a dataset
+    if (std::string(argv[1]) == "buckets")
+    {
+        osrm::benchmarks::benchmarkBucketStores(number_of_coordinates);
+        return EXIT_SUCCESS;
+    }
+
+    using namespace osrm;
+
+    // Configure based on a .osrm base path, and no datasets in shared mem from osrm-datastore
+    EngineConfig config;
+    config.storage_config = {argv[1]};
+    config.use_shared_memory = false;
+
+    // Routing machine with several services (such as Route, Table, Nearest, Trip, Match)
+    OSRM osrm{config};
+
+    using osrm::util::FloatCoordinate;
+    using osrm::util::FloatLatitude;
+    using osrm::util::FloatLongitude;
+
+    // Square matrix over a regular grid covering monaco
+    TableParameters params;
+    const auto grid_size =
+        static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(number_of_coordinates))));
+    const double min_lon = 7.409, max_lon = 7.439;
+    const double min_lat = 43.725, max_lat = 43.751;
+    for (std::size_t i = 0; i < number_of_coordinates; ++i)
+    {
+        const auto column = i % grid_size;
+        const auto row = i / grid_size;
+        const double lon = min_lon + (max_lon - min_lon) * column / grid_size;
+        const double lat = min_lat + (max_lat - min_lat) * row / grid_size;
+        params.coordinates.push_back(FloatCoordinate{FloatLongitude{lon}, FloatLatitude{lat}});
+    }
+
+    TIMER_START(tables);
+    auto NUM = 10;
+    for (int i = 0; i < NUM; ++i)
+    {
+        json::Object result;
+        const auto rc = osrm.Table(params, result);
+        if (rc != Status::Ok ||
+            result.values.at("durations").get<json::Array>().values.size() !=
+                params.coordinates.size())
+        {
+            return EXIT_FAILURE;
+        }
+    }
+    TIMER_STOP(tables);
+    std::cout << (TIMER_MSEC(tables) / NUM) << "ms/req at " << params.coordinates.size() << "x"
+              << params.coordinates.size() << " matrix" << std::endl;
+    std::cout << (TIMER_MSEC(tables) / NUM / params.coordinates.size()) << "ms/row" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
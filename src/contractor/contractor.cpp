@@ -1,11 +1,14 @@
 #include "contractor/contractor.hpp"
 #include "contractor/crc32_processor.hpp"
 #include "contractor/graph_contractor.hpp"
+#include "contractor/graph_customizer.hpp"
 
 #include "extractor/compressed_edge_container.hpp"
 #include "extractor/edge_based_graph_factory.hpp"
 #include "extractor/node_based_edge.hpp"
 
+#include "storage/io.hpp"
+
 #include "util/exception.hpp"
 #include "util/graph_loader.hpp"
 #include "util/integer_range.hpp"
@@ -39,6 +42,7 @@
 #include <fstream>
 #include <iterator>
 #include <memory>
+#include <numeric>
 #include <thread>
 #include <tuple>
 #include <vector>
@@ -116,6 +120,82 @@ EdgeWeight getNewWeight(IterType speed_iter,
     return new_segment_weight;
 }
 
+// Numbers the nodes in the order of a depth-first traversal that starts at the top of the
+// hierarchy and follows the contracted edges downwards. A node is numbered shortly after one of
+// the nodes above it, so the upward search space of a node touches fewer cache lines and pages
+// of the graph than with the order of the edge-based graph.
+inline std::vector<NodeID> computeNodeOrder(const NodeID number_of_nodes,
+                                            const util::DeallocatingVector<QueryEdge> &edges,
+                                            const std::vector<bool> &is_core_node)
+{
+    // Edges are stored at the node that was contracted first, so the target of an edge is above
+    // its source. Build the reverse adjacency array from each target to its sources.
+    std::vector<EdgeID> offsets(number_of_nodes + 1, 0);
+    std::vector<bool> has_upward_edge(number_of_nodes, false);
+    for (const auto &edge : edges)
+    {
+        if (edge.source != edge.target)
+        {
+            ++offsets[edge.target + 1];
+            has_upward_edge[edge.source] = true;
+        }
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<NodeID> lower_nodes(offsets.back());
+    std::vector<EdgeID> insert_position(offsets.begin(), offsets.end() - 1);
+    for (const auto &edge : edges)
+    {
+        if (edge.source != edge.target)
+        {
+            lower_nodes[insert_position[edge.target]++] = edge.source;
+        }
+    }
+
+    std::vector<NodeID> new_node_ids(number_of_nodes, SPECIAL_NODEID);
+    NodeID next_id = 0;
+    std::vector<NodeID> stack;
+    const auto traverse = [&](const NodeID root) {
+        stack.push_back(root);
+        while (!stack.empty())
+        {
+            const auto node = stack.back();
+            stack.pop_back();
+            if (new_node_ids[node] != SPECIAL_NODEID)
+                continue;
+
+            new_node_ids[node] = next_id++;
+            // pushed in reverse to visit the lower nodes in their original order
+            for (auto index = offsets[node + 1]; index > offsets[node]; --index)
+            {
+                if (new_node_ids[lower_nodes[index - 1]] == SPECIAL_NODEID)
+                    stack.push_back(lower_nodes[index - 1]);
+            }
+        }
+    };
+
+    // The uncontracted core is the top of the hierarchy, followed by the contracted nodes
+    // without any edges to higher nodes. The last loop only picks up isolated nodes.
+    for (const auto node : util::irange<NodeID>(0, is_core_node.size()))
+    {
+        if (is_core_node[node] && new_node_ids[node] == SPECIAL_NODEID)
+            traverse(node);
+    }
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        if (!has_upward_edge[node] && new_node_ids[node] == SPECIAL_NODEID)
+            traverse(node);
+    }
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        if (new_node_ids[node] == SPECIAL_NODEID)
+            traverse(node);
+    }
+    BOOST_ASSERT(next_id == number_of_nodes);
+
+    return new_node_ids;
+}
+
 int Contractor::Run()
 {
 #ifdef WIN32
@@ -154,43 +234,70 @@ int Contractor::Run()
     // Contracting the edge-expanded graph
 
     TIMER_START(contraction);
-    std::vector<bool> is_core_node;
-    std::vector<float> node_levels;
-    if (config.use_cached_priority)
-    {
-        ReadNodeLevels(node_levels);
-    }
-
-    util::SimpleLogger().Write() << "Reading node weights.";
-    std::vector<EdgeWeight> node_weights;
-    std::string node_file_name = config.osrm_input_path.string() + ".enw";
-    if (util::deserializeVector(node_file_name, node_weights))
+    util::DeallocatingVector<QueryEdge> contracted_edge_list;
+    const bool customized =
+        config.customize_hierarchy &&
+        CustomizeGraph(max_edge_id, edge_based_edge_list, contracted_edge_list);
+    if (customized)
     {
-        util::SimpleLogger().Write() << "Done reading node weights.";
+        TIMER_STOP(contraction);
+        util::SimpleLogger().Write() << "Customization took " << TIMER_SEC(contraction) << " sec";
     }
     else
     {
-        throw util::exception("Failed reading node weights.");
-    }
+        if (config.customize_hierarchy)
+        {
+            util::SimpleLogger().Write() << "Hierarchy can not be customized, contracting graph";
+        }
 
-    util::DeallocatingVector<QueryEdge> contracted_edge_list;
-    ContractGraph(max_edge_id,
-                  edge_based_edge_list,
-                  contracted_edge_list,
-                  std::move(node_weights),
-                  is_core_node,
-                  node_levels);
-    TIMER_STOP(contraction);
+        std::vector<bool> is_core_node;
+        std::vector<float> node_levels;
+        if (config.use_cached_priority)
+        {
+            ReadNodeLevels(node_levels);
+        }
 
-    util::SimpleLogger().Write() << "Contraction took " << TIMER_SEC(contraction) << " sec";
+        util::SimpleLogger().Write() << "Reading node weights.";
+        std::vector<EdgeWeight> node_weights;
+        std::string node_file_name = config.osrm_input_path.string() + ".enw";
+        if (util::deserializeVector(node_file_name, node_weights))
+        {
+            util::SimpleLogger().Write() << "Done reading node weights.";
+        }
+        else
+        {
+            throw util::exception("Failed reading node weights.");
+        }
 
-    std::size_t number_of_used_edges = WriteContractedGraph(max_edge_id, contracted_edge_list);
-    WriteCoreNodeMarker(std::move(is_core_node));
-    if (!config.use_cached_priority)
-    {
-        WriteNodeLevels(std::move(node_levels));
+        ContractGraph(max_edge_id,
+                      edge_based_edge_list,
+                      contracted_edge_list,
+                      std::move(node_weights),
+                      is_core_node,
+                      node_levels);
+        TIMER_STOP(contraction);
+
+        util::SimpleLogger().Write() << "Contraction took " << TIMER_SEC(contraction) << " sec";
+
+        // empty if the nodes keep the order of the edge-based graph
+        std::vector<NodeID> new_node_ids;
+        if (config.renumber_nodes)
+        {
+            util::SimpleLogger().Write() << "Renumbering nodes of the contracted graph";
+            new_node_ids = computeNodeOrder(max_edge_id + 1, contracted_edge_list, is_core_node);
+            RenumberNodes(new_node_ids, contracted_edge_list, is_core_node);
+        }
+        RenumberRTreeLeaves(new_node_ids);
+
+        WriteCoreNodeMarker(std::move(is_core_node));
+        if (!config.use_cached_priority)
+        {
+            WriteNodeLevels(std::move(node_levels));
+        }
     }
 
+    std::size_t number_of_used_edges = WriteContractedGraph(max_edge_id, contracted_edge_list);
+
     TIMER_STOP(preparing);
 
     util::SimpleLogger().Write() << "Preprocessing : " << TIMER_SEC(preparing) << " seconds";
@@ -643,7 +750,8 @@ EdgeID Contractor::LoadEdgeExpandedGraph(
         // Now, we iterate over all the segments stored in the StaticRTree, updating
         // the packed geometry weights in the `.geometries` file (note: we do not
         // update the RTree itself, we just use the leaf nodes to iterate over all segments)
-        using LeafNode = util::StaticRTree<extractor::EdgeBasedNode>::LeafNode;
+        using RTree = util::StaticRTree<extractor::EdgeBasedNode>;
+        using LeafNode = RTree::LeafNode;
 
         using boost::interprocess::mapped_region;
 
@@ -666,7 +774,7 @@ EdgeID Contractor::LoadEdgeExpandedGraph(
             auto &counters = segment_speeds_counters.local();
             for (size_t i = 0; i < current_node.object_count; i++)
             {
-                const auto &leaf_object = current_node.objects[i];
+                const auto &leaf_object = RTree::GetEdgeData(current_node.objects[i]);
                 extractor::QueryNode *u;
                 extractor::QueryNode *v;
 
@@ -955,6 +1063,233 @@ void Contractor::WriteNodeLevels(std::vector<float> &&in_node_levels) const
     order_output_stream.write((char *)node_levels.data(), sizeof(float) * node_levels.size());
 }
 
+// Updates the weights of the hierarchy of the last run to the weights of the edge-based graph.
+// Returns false if there is no hierarchy to update or it does not fit the new weights.
+bool Contractor::CustomizeGraph(
+    const EdgeID max_edge_id,
+    const util::DeallocatingVector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+    util::DeallocatingVector<QueryEdge> &contracted_edge_list) const
+{
+    const NodeID number_of_nodes = max_edge_id + 1;
+    if (!boost::filesystem::exists(config.graph_output_path) ||
+        !boost::filesystem::exists(config.level_output_path) ||
+        !boost::filesystem::exists(config.core_output_path))
+    {
+        util::SimpleLogger().Write() << "No hierarchy from a previous run to customize";
+        return false;
+    }
+
+    // the hierarchy uses the node IDs of the last renumbering
+    std::vector<NodeID> new_node_ids;
+    if (boost::filesystem::exists(config.node_order_path) &&
+        !util::deserializeVector(config.node_order_path, new_node_ids))
+    {
+        throw util::exception("Failed to read " + config.node_order_path);
+    }
+    if (!new_node_ids.empty() && new_node_ids.size() != number_of_nodes)
+    {
+        util::SimpleLogger().Write() << "Node order does not match the edge-based graph";
+        return false;
+    }
+
+    // the levels are stored for the nodes of the edge-based graph
+    std::vector<float> node_levels;
+    ReadNodeLevels(node_levels);
+    if (node_levels.size() != number_of_nodes)
+    {
+        util::SimpleLogger().Write() << "Node levels do not match the edge-based graph";
+        return false;
+    }
+
+    // needed to check for missing self-loops
+    std::vector<EdgeWeight> node_weights;
+    const std::string node_file_name = config.osrm_input_path.string() + ".enw";
+    if (!util::deserializeVector(node_file_name, node_weights))
+    {
+        throw util::exception("Failed reading node weights.");
+    }
+    if (node_weights.size() != number_of_nodes)
+    {
+        util::SimpleLogger().Write() << "Node weights do not match the edge-based graph";
+        return false;
+    }
+
+    if (!new_node_ids.empty())
+    {
+        std::vector<float> renumbered_node_levels(number_of_nodes);
+        std::vector<EdgeWeight> renumbered_node_weights(number_of_nodes);
+        for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        {
+            renumbered_node_levels[new_node_ids[node]] = node_levels[node];
+            renumbered_node_weights[new_node_ids[node]] = node_weights[node];
+        }
+        node_levels.swap(renumbered_node_levels);
+        node_weights.swap(renumbered_node_weights);
+    }
+
+    // the core marker is empty if the graph was fully contracted
+    boost::filesystem::ifstream core_marker_input_stream(config.core_output_path,
+                                                         std::ios::binary);
+    unsigned core_marker_size = 0;
+    core_marker_input_stream.read((char *)&core_marker_size, sizeof(unsigned));
+    if (core_marker_size != 0 && core_marker_size != number_of_nodes)
+    {
+        util::SimpleLogger().Write() << "Core marker does not match the edge-based graph";
+        return false;
+    }
+    std::vector<char> unpacked_bool_flags(core_marker_size);
+    core_marker_input_stream.read(unpacked_bool_flags.data(), core_marker_size);
+    std::vector<bool> is_core_node(unpacked_bool_flags.begin(), unpacked_bool_flags.end());
+
+    boost::filesystem::ifstream hsgr_input_stream(config.graph_output_path, std::ios::binary);
+    const auto header = storage::io::readHSGRHeader(hsgr_input_stream);
+    // the node array has a sentinel
+    if (header.number_of_nodes != number_of_nodes + 1)
+    {
+        util::SimpleLogger().Write() << "Hierarchy does not match the edge-based graph";
+        return false;
+    }
+
+    std::vector<util::StaticGraph<EdgeData>::NodeArrayEntry> node_array(header.number_of_nodes);
+    hsgr_input_stream.read((char *)node_array.data(),
+                           sizeof(util::StaticGraph<EdgeData>::NodeArrayEntry) *
+                               node_array.size());
+
+    util::DeallocatingVector<QueryEdge> hierarchy_edges;
+    util::StaticGraph<EdgeData>::EdgeArrayEntry current_edge;
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        for (auto edge = node_array[node].first_edge; edge < node_array[node + 1].first_edge;
+             ++edge)
+        {
+            hsgr_input_stream.read((char *)&current_edge,
+                                   sizeof(util::StaticGraph<EdgeData>::EdgeArrayEntry));
+            hierarchy_edges.push_back(QueryEdge(node, current_edge.target, current_edge.data));
+        }
+    }
+    if (!hsgr_input_stream)
+    {
+        throw util::exception("Failed to read " + config.graph_output_path);
+    }
+
+    util::SimpleLogger().Write() << "Customizing hierarchy of " << hierarchy_edges.size()
+                                 << " edges";
+
+    GraphCustomizer customizer(number_of_nodes,
+                               hierarchy_edges,
+                               std::move(node_levels),
+                               std::move(is_core_node),
+                               std::move(node_weights));
+    if (!customizer.Run(edge_based_edge_list, new_node_ids))
+    {
+        return false;
+    }
+    customizer.GetEdges(contracted_edge_list);
+
+    return true;
+}
+
+void Contractor::RenumberNodes(const std::vector<NodeID> &new_node_ids,
+                               util::DeallocatingVector<QueryEdge> &contracted_edge_list,
+                               std::vector<bool> &is_core_node) const
+{
+    for (auto &edge : contracted_edge_list)
+    {
+        edge.source = new_node_ids[edge.source];
+        edge.target = new_node_ids[edge.target];
+        // the id of a shortcut is its middle node, original edges keep their edge id
+        if (edge.data.shortcut)
+        {
+            edge.data.id = new_node_ids[edge.data.id];
+        }
+    }
+
+    if (!is_core_node.empty())
+    {
+        std::vector<bool> renumbered_is_core_node(is_core_node.size(), false);
+        for (const auto node : util::irange<std::size_t>(0UL, is_core_node.size()))
+        {
+            renumbered_is_core_node[new_node_ids[node]] = is_core_node[node];
+        }
+        is_core_node.swap(renumbered_is_core_node);
+    }
+}
+
+// The R-tree leaves are written by the extractor with the node IDs of the edge-based graph.
+// The order that was applied to them by the last run is kept in the .node_order file, so the
+// leaves can be brought into the new order (or back into the original order if new_node_ids
+// is empty) no matter how often osrm-contract is run on the same extract.
+void Contractor::RenumberRTreeLeaves(const std::vector<NodeID> &new_node_ids) const
+{
+    std::vector<NodeID> applied_node_ids;
+    if (boost::filesystem::exists(config.node_order_path) &&
+        !util::deserializeVector(config.node_order_path, applied_node_ids))
+    {
+        throw util::exception("Failed to read " + config.node_order_path);
+    }
+
+    if (applied_node_ids.empty() && new_node_ids.empty())
+    {
+        return;
+    }
+
+    // maps the IDs currently stored in the leaves to the new IDs
+    std::vector<NodeID> current_to_new;
+    if (applied_node_ids.empty())
+    {
+        current_to_new = new_node_ids;
+    }
+    else
+    {
+        current_to_new.resize(applied_node_ids.size());
+        for (const auto node : util::irange<NodeID>(0, applied_node_ids.size()))
+        {
+            current_to_new[applied_node_ids[node]] =
+                new_node_ids.empty() ? node : new_node_ids[node];
+        }
+    }
+
+    using RTree = util::StaticRTree<extractor::EdgeBasedNode>;
+    using LeafNode = RTree::LeafNode;
+    using boost::interprocess::file_mapping;
+    using boost::interprocess::mapped_region;
+    using boost::interprocess::read_write;
+
+    const file_mapping mapping{config.rtree_leaf_path.c_str(), read_write};
+    mapped_region region{mapping, read_write};
+    region.advise(mapped_region::advice_sequential);
+
+    const auto first = static_cast<LeafNode *>(region.get_address());
+    const auto last = first + (region.get_size() / sizeof(LeafNode));
+
+    const auto renumber = [&current_to_new](SegmentID &segment) {
+        if (segment.id != SPECIAL_SEGMENTID)
+        {
+            BOOST_ASSERT(segment.id < current_to_new.size());
+            segment.id = current_to_new[segment.id];
+        }
+    };
+
+    tbb::parallel_for_each(first, last, [&](LeafNode &current_node) {
+        for (std::size_t i = 0; i < current_node.object_count; ++i)
+        {
+            auto &leaf_object = RTree::GetEdgeData(current_node.objects[i]);
+            renumber(leaf_object.forward_segment_id);
+            renumber(leaf_object.reverse_segment_id);
+        }
+    });
+    region.flush();
+
+    if (new_node_ids.empty())
+    {
+        boost::filesystem::remove(config.node_order_path);
+    }
+    else if (!util::serializeVector(config.node_order_path, new_node_ids))
+    {
+        throw util::exception("Failed to write " + config.node_order_path);
+    }
+}
+
 void Contractor::WriteCoreNodeMarker(std::vector<bool> &&in_is_core_node) const
 {
     std::vector<bool> is_core_node(std::move(in_is_core_node));
@@ -297,6 +297,24 @@ util::json::Object makeWaypoint(const util::Coordinate location, std::string nam
     return waypoint;
 }
 
+void writeWaypoint(util::json::Writer &writer,
+                   const util::Coordinate location,
+                   const std::string &name,
+                   const Hint &hint)
+{
+    writer.StartObject();
+    writer.Key("hint");
+    writer.String(hint.ToBase64());
+    writer.Key("name");
+    writer.String(name);
+    writer.Key("location");
+    writer.StartArray();
+    writer.Number(static_cast<double>(toFloating(location.lon)));
+    writer.Number(static_cast<double>(toFloating(location.lat)));
+    writer.EndArray();
+    writer.EndObject();
+}
+
 util::json::Object makeRouteLeg(guidance::RouteLeg leg, util::json::Array steps)
 {
     util::json::Object route_leg;
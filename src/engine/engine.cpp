@@ -1,6 +1,7 @@
 #include "engine/engine.hpp"
 #include "engine/api/route_parameters.hpp"
 #include "engine/engine_config.hpp"
+#include "engine/search_engine_data.hpp"
 #include "engine/status.hpp"
 
 #include "engine/datafacade/internal_datafacade.hpp"
@@ -14,8 +15,12 @@
 #include <boost/interprocess/sync/scoped_lock.hpp>
 #include <boost/interprocess/sync/sharable_lock.hpp>
 
+#include <tbb/parallel_for.h>
+
 #include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <limits>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -35,9 +40,9 @@ RunQuery(const std::unique_ptr<osrm::engine::DataWatchdog> &watchdog,
     if (watchdog)
     {
         BOOST_ASSERT(!facade);
-        auto lock_and_facade = watchdog->GetDataFacade();
+        const auto snapshot = watchdog->GetDataFacade();
 
-        return plugin.HandleRequest(lock_and_facade.second, parameters, result);
+        return plugin.HandleRequest(snapshot, parameters, result);
     }
 
     BOOST_ASSERT(facade);
@@ -45,6 +50,13 @@ RunQuery(const std::unique_ptr<osrm::engine::DataWatchdog> &watchdog,
     return plugin.HandleRequest(facade, parameters, result);
 }
 
+std::size_t getMaxDenseHeapNodes(const osrm::engine::EngineConfig &config)
+{
+    return config.max_dense_heap_nodes < 0
+               ? std::numeric_limits<std::size_t>::max()
+               : static_cast<std::size_t>(config.max_dense_heap_nodes);
+}
+
 } // anon. ns
 
 namespace osrm
@@ -55,12 +67,14 @@ namespace engine
 Engine::Engine(const EngineConfig &config)
     : lock(config.use_shared_memory ? std::make_unique<storage::SharedBarriers>()
                                     : std::unique_ptr<storage::SharedBarriers>()),
-      route_plugin(config.max_locations_viaroute),       //
-      table_plugin(config.max_locations_distance_table), //
-      nearest_plugin(config.max_results_nearest),        //
-      trip_plugin(config.max_locations_trip),            //
-      match_plugin(config.max_locations_map_matching),   //
-      tile_plugin()                                      //
+      route_plugin(config.max_locations_viaroute, getMaxDenseHeapNodes(config)),     //
+      table_plugin(config.max_locations_distance_table,
+                   config.max_parallelism_distance_table,
+                   getMaxDenseHeapNodes(config)),                                    //
+      nearest_plugin(config.max_results_nearest),                                    //
+      trip_plugin(config.max_locations_trip, getMaxDenseHeapNodes(config)),          //
+      match_plugin(config.max_locations_map_matching, getMaxDenseHeapNodes(config)), //
+      tile_plugin()                                                                  //
 
 {
     if (config.use_shared_memory)
@@ -71,7 +85,7 @@ Engine::Engine(const EngineConfig &config)
                 "No shared memory blocks found, have you forgotten to run osrm-datastore?");
         }
 
-        watchdog = std::make_unique<DataWatchdog>();
+        watchdog = std::make_unique<DataWatchdog>(config.rtree_warmup, config.rtree_hot_pages_path);
         BOOST_ASSERT(watchdog);
     }
     else
@@ -80,8 +94,8 @@ Engine::Engine(const EngineConfig &config)
         {
             throw util::exception("Invalid file paths given!");
         }
-        immutable_data_facade =
-            std::make_shared<datafacade::InternalDataFacade>(config.storage_config);
+        immutable_data_facade = std::make_shared<datafacade::InternalDataFacade>(
+            config.storage_config, config.rtree_warmup, config.rtree_hot_pages_path);
     }
 }
 
@@ -90,11 +104,26 @@ Status Engine::Route(const api::RouteParameters &params, util::json::Object &res
     return RunQuery(watchdog, immutable_data_facade, params, route_plugin, result);
 }
 
+Status Engine::Route(const api::RouteParameters &params, util::binary::Writer &result) const
+{
+    return RunQuery(watchdog, immutable_data_facade, params, route_plugin, result);
+}
+
 Status Engine::Table(const api::TableParameters &params, util::json::Object &result) const
 {
     return RunQuery(watchdog, immutable_data_facade, params, table_plugin, result);
 }
 
+Status Engine::Table(const api::TableParameters &params, util::json::Writer &result) const
+{
+    return RunQuery(watchdog, immutable_data_facade, params, table_plugin, result);
+}
+
+Status Engine::Table(const api::TableParameters &params, util::binary::Writer &result) const
+{
+    return RunQuery(watchdog, immutable_data_facade, params, table_plugin, result);
+}
+
 Status Engine::Nearest(const api::NearestParameters &params, util::json::Object &result) const
 {
     return RunQuery(watchdog, immutable_data_facade, params, nearest_plugin, result);
@@ -110,6 +139,32 @@ Status Engine::Match(const api::MatchParameters &params, util::json::Object &res
     return RunQuery(watchdog, immutable_data_facade, params, match_plugin, result);
 }
 
+Status Engine::Match(const std::vector<api::MatchParameters> &params,
+                     std::vector<util::json::Object> &results) const
+{
+    // all traces of a batch are matched on the same dataset
+    std::shared_ptr<datafacade::BaseDataFacade> facade = immutable_data_facade;
+    if (watchdog)
+    {
+        BOOST_ASSERT(!facade);
+        facade = watchdog->GetDataFacade();
+    }
+    BOOST_ASSERT(facade);
+
+    results.clear();
+    results.resize(params.size());
+
+    std::atomic<bool> all_matched{true};
+    tbb::parallel_for(std::size_t{0}, params.size(), [&](const std::size_t index) {
+        if (match_plugin.HandleRequest(facade, params[index], results[index]) != Status::Ok)
+        {
+            all_matched = false;
+        }
+    });
+
+    return all_matched ? Status::Ok : Status::Error;
+}
+
 Status Engine::Tile(const api::TileParameters &params, std::string &result) const
 {
     return RunQuery(watchdog, immutable_data_facade, params, tile_plugin, result);
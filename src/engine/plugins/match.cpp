@@ -3,12 +3,15 @@
 
 #include "engine/api/match_api.hpp"
 #include "engine/api/match_parameters.hpp"
+#include "engine/datafacade/concrete_datafacade.hpp"
 #include "engine/map_matching/bayes_classifier.hpp"
 #include "util/coordinate_calculation.hpp"
 #include "util/integer_range.hpp"
 #include "util/json_util.hpp"
 #include "util/string_util.hpp"
 
+#include <tbb/parallel_for.h>
+
 #include <cstdlib>
 
 #include <algorithm>
@@ -16,6 +19,7 @@
 #include <iterator>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace osrm
@@ -179,41 +183,52 @@ Status MatchPlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataFaca
     }
 
     // call the actual map matching
-    SubMatchingList sub_matchings = map_matching(*facade,
-                                                 candidates_lists,
-                                                 parameters.coordinates,
-                                                 parameters.timestamps,
-                                                 parameters.radiuses);
+    SubMatchingList sub_matchings;
+    std::vector<InternalRouteResult> sub_routes;
+    datafacade::CallWithConcreteFacade(*facade, [&](const auto &concrete_facade) {
+        using DataFacadeT = std::decay_t<decltype(concrete_facade)>;
+        routing_algorithms::MapMatching<DataFacadeT> map_matching(heaps, DEFAULT_GPS_PRECISION);
+        routing_algorithms::ShortestPathRouting<DataFacadeT> shortest_path(heaps);
+
+        sub_matchings = map_matching(concrete_facade,
+                                     candidates_lists,
+                                     parameters.coordinates,
+                                     parameters.timestamps,
+                                     parameters.radiuses);
+
+        // the sub matchings are independent of each other, SearchEngineData keeps separate
+        // heaps for every thread
+        sub_routes.resize(sub_matchings.size());
+        tbb::parallel_for(std::size_t{0}, sub_matchings.size(), [&](const std::size_t index) {
+            BOOST_ASSERT(sub_matchings[index].nodes.size() > 1);
+
+            // FIXME we only run this to obtain the geometry
+            // The clean way would be to get this directly from the map matching plugin
+            PhantomNodes current_phantom_node_pair;
+            for (unsigned i = 0; i < sub_matchings[index].nodes.size() - 1; ++i)
+            {
+                current_phantom_node_pair.source_phantom = sub_matchings[index].nodes[i];
+                current_phantom_node_pair.target_phantom = sub_matchings[index].nodes[i + 1];
+                BOOST_ASSERT(current_phantom_node_pair.source_phantom.IsValid());
+                BOOST_ASSERT(current_phantom_node_pair.target_phantom.IsValid());
+                sub_routes[index].segment_end_coordinates.emplace_back(current_phantom_node_pair);
+            }
+            // force uturns to be on, since we split the phantom nodes anyway and only have
+            // bi-directional
+            // phantom nodes for possible uturns
+            shortest_path(concrete_facade,
+                          sub_routes[index].segment_end_coordinates,
+                          {false},
+                          sub_routes[index]);
+            BOOST_ASSERT(sub_routes[index].shortest_path_length != INVALID_EDGE_WEIGHT);
+        });
+    });
 
     if (sub_matchings.size() == 0)
     {
         return Error("NoMatch", "Could not match the trace.", json_result);
     }
 
-    std::vector<InternalRouteResult> sub_routes(sub_matchings.size());
-    for (auto index : util::irange<std::size_t>(0UL, sub_matchings.size()))
-    {
-        BOOST_ASSERT(sub_matchings[index].nodes.size() > 1);
-
-        // FIXME we only run this to obtain the geometry
-        // The clean way would be to get this directly from the map matching plugin
-        PhantomNodes current_phantom_node_pair;
-        for (unsigned i = 0; i < sub_matchings[index].nodes.size() - 1; ++i)
-        {
-            current_phantom_node_pair.source_phantom = sub_matchings[index].nodes[i];
-            current_phantom_node_pair.target_phantom = sub_matchings[index].nodes[i + 1];
-            BOOST_ASSERT(current_phantom_node_pair.source_phantom.IsValid());
-            BOOST_ASSERT(current_phantom_node_pair.target_phantom.IsValid());
-            sub_routes[index].segment_end_coordinates.emplace_back(current_phantom_node_pair);
-        }
-        // force uturns to be on, since we split the phantom nodes anyway and only have
-        // bi-directional
-        // phantom nodes for possible uturns
-        shortest_path(
-            *facade, sub_routes[index].segment_end_coordinates, {false}, sub_routes[index]);
-        BOOST_ASSERT(sub_routes[index].shortest_path_length != INVALID_EDGE_WEIGHT);
-    }
-
     api::MatchAPI match_api{*facade, parameters};
     match_api.MakeResponse(sub_matchings, sub_routes, json_result);
 
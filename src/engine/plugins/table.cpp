@@ -2,9 +2,12 @@
 
 #include "engine/api/table_api.hpp"
 #include "engine/api/table_parameters.hpp"
+#include "engine/datafacade/concrete_datafacade.hpp"
 #include "engine/routing_algorithms/many_to_many.hpp"
 #include "engine/search_engine_data.hpp"
+#include "util/binary_writer.hpp"
 #include "util/json_container.hpp"
+#include "util/json_writer.hpp"
 #include "util/string_util.hpp"
 
 #include <cstdlib>
@@ -12,6 +15,7 @@
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include <boost/assert.hpp>
@@ -23,14 +27,18 @@ namespace engine
 namespace plugins
 {
 
-TablePlugin::TablePlugin(const int max_locations_distance_table)
-    : distance_table(heaps), max_locations_distance_table(max_locations_distance_table)
+TablePlugin::TablePlugin(const int max_locations_distance_table,
+                         const int max_parallelism_distance_table,
+                         const std::size_t max_dense_heap_nodes)
+    : heaps(max_dense_heap_nodes), max_locations_distance_table(max_locations_distance_table),
+      max_parallelism_distance_table(max_parallelism_distance_table)
 {
 }
 
+template <typename ResultT>
 Status TablePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataFacade> facade,
                                   const api::TableParameters &params,
-                                  util::json::Object &result) const
+                                  ResultT &result) const
 {
     BOOST_ASSERT(params.IsValid());
 
@@ -59,9 +67,16 @@ Status TablePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataFaca
         return Error("TooBig", "Too many table coordinates", result);
     }
 
-    auto snapped_phantoms = SnapPhantomNodes(GetPhantomNodes(*facade, params));
-    auto result_table =
-        distance_table(*facade, snapped_phantoms, params.sources, params.destinations);
+    auto snapped_phantoms = SnapPhantomNodes(
+        GetPhantomNodesWithParallelism(*facade, params, max_parallelism_distance_table));
+    auto result_table = datafacade::CallWithConcreteFacade(
+        *facade, [&](const auto &concrete_facade) {
+            using DataFacadeT = std::decay_t<decltype(concrete_facade)>;
+            routing_algorithms::ManyToManyRouting<DataFacadeT> distance_table(
+                heaps, max_parallelism_distance_table);
+            return distance_table(
+                concrete_facade, snapped_phantoms, params.sources, params.destinations);
+        });
 
     if (result_table.empty())
     {
@@ -73,6 +88,19 @@ Status TablePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataFaca
 
     return Status::Ok;
 }
+
+template Status
+TablePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataFacade> facade,
+                           const api::TableParameters &params,
+                           util::json::Object &result) const;
+template Status
+TablePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataFacade> facade,
+                           const api::TableParameters &params,
+                           util::json::Writer &result) const;
+template Status
+TablePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataFacade> facade,
+                           const api::TableParameters &params,
+                           util::binary::Writer &result) const;
 }
 }
 }
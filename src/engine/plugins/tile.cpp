@@ -2,6 +2,7 @@
 #include "engine/edge_unpacker.hpp"
 #include "engine/plugins/plugin_base.hpp"
 
+#include "util/array_view.hpp"
 #include "util/coordinate_calculation.hpp"
 #include "util/vector_tile.hpp"
 #include "util/web_mercator.hpp"
@@ -461,12 +462,12 @@ Status TilePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataFacad
 
         // Now, for every edge-based-node that we discovered (edge-based-nodes are sources
         // and targets of turns).  EBN is short for edge-based-node
-        std::vector<NodeID> first_geometry, second_geometry;
+        util::ArrayView<NodeID> first_geometry, second_geometry;
         std::vector<contractor::QueryEdge::EdgeData> unpacked_shortcut;
-        std::vector<EdgeWeight> forward_weight_vector;
+        util::ArrayView<EdgeWeight> forward_weight_vector;
         for (const auto &source_ebn : edge_based_node_info)
         {
-            // Grab a copy of the geometry leading up to the intersection.
+            // Grab the geometry leading up to the intersection.
             first_geometry =
                 facade->GetUncompressedForwardGeometry(source_ebn.second.packed_geometry_id);
 
@@ -4,6 +4,7 @@
 
 #include "engine/api/trip_api.hpp"
 #include "engine/api/trip_parameters.hpp"
+#include "engine/datafacade/concrete_datafacade.hpp"
 #include "engine/trip/trip_brute_force.hpp"
 #include "engine/trip/trip_farthest_insertion.hpp"
 #include "engine/trip/trip_nearest_neighbour.hpp"
@@ -18,6 +19,7 @@
 #include <iterator>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -114,7 +116,8 @@ SCC_Component SplitUnaccessibleLocations(const std::size_t number_of_locations,
     return SCC_Component(std::move(components), std::move(range));
 }
 
-InternalRouteResult TripPlugin::ComputeRoute(const datafacade::BaseDataFacade &facade,
+template <typename DataFacadeT>
+InternalRouteResult TripPlugin::ComputeRoute(const DataFacadeT &facade,
                                              const std::vector<PhantomNode> &snapped_phantoms,
                                              const std::vector<NodeID> &trip) const
 {
@@ -135,6 +138,7 @@ InternalRouteResult TripPlugin::ComputeRoute(const datafacade::BaseDataFacade &f
     }
     BOOST_ASSERT(min_route.segment_end_coordinates.size() == trip.size());
 
+    routing_algorithms::ShortestPathRouting<DataFacadeT> shortest_path(heaps);
     shortest_path(facade, min_route.segment_end_coordinates, {false}, min_route);
 
     BOOST_ASSERT_MSG(min_route.shortest_path_length < INVALID_EDGE_WEIGHT, "unroutable route");
@@ -174,8 +178,13 @@ Status TripPlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataFacad
     const auto number_of_locations = snapped_phantoms.size();
 
     // compute the duration table of all phantom nodes
-    const auto result_table = util::DistTableWrapper<EdgeWeight>(
-        duration_table(*facade, snapped_phantoms, {}, {}), number_of_locations);
+    auto durations = datafacade::CallWithConcreteFacade(*facade, [&](const auto &concrete_facade) {
+        using DataFacadeT = std::decay_t<decltype(concrete_facade)>;
+        routing_algorithms::ManyToManyRouting<DataFacadeT> duration_table(heaps);
+        return duration_table(concrete_facade, snapped_phantoms, {}, {});
+    });
+    const auto result_table =
+        util::DistTableWrapper<EdgeWeight>(std::move(durations), number_of_locations);
 
     if (result_table.size() == 0)
     {
@@ -231,10 +240,12 @@ Status TripPlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataFacad
     // compute all round trip routes
     std::vector<InternalRouteResult> routes;
     routes.reserve(trips.size());
-    for (const auto &trip : trips)
-    {
-        routes.push_back(ComputeRoute(*facade, snapped_phantoms, trip));
-    }
+    datafacade::CallWithConcreteFacade(*facade, [&](const auto &concrete_facade) {
+        for (const auto &trip : trips)
+        {
+            routes.push_back(ComputeRoute(concrete_facade, snapped_phantoms, trip));
+        }
+    });
 
     api::TripAPI trip_api{*facade, parameters};
     trip_api.MakeResponse(trips, routes, snapped_phantoms, json_result);
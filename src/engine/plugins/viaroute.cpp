@@ -1,8 +1,10 @@
 #include "engine/plugins/viaroute.hpp"
 #include "engine/api/route_api.hpp"
+#include "engine/datafacade/concrete_datafacade.hpp"
 #include "engine/datafacade/datafacade_base.hpp"
 #include "engine/status.hpp"
 
+#include "util/binary_writer.hpp"
 #include "util/for_each_pair.hpp"
 #include "util/integer_range.hpp"
 #include "util/json_container.hpp"
@@ -12,6 +14,7 @@
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace osrm
@@ -21,15 +24,15 @@ namespace engine
 namespace plugins
 {
 
-ViaRoutePlugin::ViaRoutePlugin(int max_locations_viaroute)
-    : shortest_path(heaps), alternative_path(heaps), direct_shortest_path(heaps),
-      max_locations_viaroute(max_locations_viaroute)
+ViaRoutePlugin::ViaRoutePlugin(int max_locations_viaroute, const std::size_t max_dense_heap_nodes)
+    : heaps(max_dense_heap_nodes), max_locations_viaroute(max_locations_viaroute)
 {
 }
 
+template <typename ResultT>
 Status ViaRoutePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataFacade> facade,
                                      const api::RouteParameters &route_parameters,
-                                     util::json::Object &json_result) const
+                                     ResultT &result) const
 {
     BOOST_ASSERT(route_parameters.IsValid());
 
@@ -40,12 +43,20 @@ Status ViaRoutePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataF
                      "Number of entries " + std::to_string(route_parameters.coordinates.size()) +
                          " is higher than current maximum (" +
                          std::to_string(max_locations_viaroute) + ")",
-                     json_result);
+                     result);
     }
 
     if (!CheckAllCoordinates(route_parameters.coordinates))
     {
-        return Error("InvalidValue", "Invalid coordinate value.", json_result);
+        return Error("InvalidValue", "Invalid coordinate value.", result);
+    }
+
+    if (route_parameters.format == api::RouteParameters::OutputFormatType::Binary &&
+        (route_parameters.steps || route_parameters.annotations))
+    {
+        return Error("InvalidOptions",
+                     "Steps and annotations are only supported by the JSON format",
+                     result);
     }
 
     auto phantom_node_pairs = GetPhantomNodes(*facade, route_parameters);
@@ -54,7 +65,7 @@ Status ViaRoutePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataF
         return Error("NoSegment",
                      std::string("Could not find a matching segment for coordinate ") +
                          std::to_string(phantom_node_pairs.size()),
-                     json_result);
+                     result);
     }
     BOOST_ASSERT(phantom_node_pairs.size() == route_parameters.coordinates.size());
 
@@ -84,31 +95,40 @@ Status ViaRoutePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataF
     };
     util::for_each_pair(snapped_phantoms, build_phantom_pairs);
 
-    if (1 == raw_route.segment_end_coordinates.size())
-    {
-        if (route_parameters.alternatives && facade->GetCoreSize() == 0)
+    datafacade::CallWithConcreteFacade(*facade, [&](const auto &concrete_facade) {
+        using DataFacadeT = std::decay_t<decltype(concrete_facade)>;
+
+        if (1 == raw_route.segment_end_coordinates.size())
         {
-            alternative_path(*facade, raw_route.segment_end_coordinates.front(), raw_route);
+            if (route_parameters.alternatives && concrete_facade.GetCoreSize() == 0)
+            {
+                routing_algorithms::AlternativeRouting<DataFacadeT> alternative_path(heaps);
+                alternative_path(
+                    concrete_facade, raw_route.segment_end_coordinates.front(), raw_route);
+            }
+            else
+            {
+                routing_algorithms::DirectShortestPathRouting<DataFacadeT> direct_shortest_path(
+                    heaps);
+                direct_shortest_path(concrete_facade, raw_route.segment_end_coordinates, raw_route);
+            }
         }
         else
         {
-            direct_shortest_path(*facade, raw_route.segment_end_coordinates, raw_route);
+            routing_algorithms::ShortestPathRouting<DataFacadeT> shortest_path(heaps);
+            shortest_path(concrete_facade,
+                          raw_route.segment_end_coordinates,
+                          route_parameters.continue_straight,
+                          raw_route);
         }
-    }
-    else
-    {
-        shortest_path(*facade,
-                      raw_route.segment_end_coordinates,
-                      route_parameters.continue_straight,
-                      raw_route);
-    }
+    });
 
     // we can only know this after the fact, different SCC ids still
     // allow for connection in one direction.
     if (raw_route.is_valid())
     {
         api::RouteAPI route_api{*facade, route_parameters};
-        route_api.MakeResponse(raw_route, json_result);
+        route_api.MakeResponse(raw_route, result);
     }
     else
     {
@@ -121,16 +141,25 @@ Status ViaRoutePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataF
 
         if (not_in_same_component)
         {
-            return Error("NoRoute", "Impossible route between points", json_result);
+            return Error("NoRoute", "Impossible route between points", result);
         }
         else
         {
-            return Error("NoRoute", "No route found between points", json_result);
+            return Error("NoRoute", "No route found between points", result);
         }
     }
 
     return Status::Ok;
 }
+
+template Status
+ViaRoutePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataFacade> facade,
+                              const api::RouteParameters &route_parameters,
+                              util::json::Object &result) const;
+template Status
+ViaRoutePlugin::HandleRequest(const std::shared_ptr<datafacade::BaseDataFacade> facade,
+                              const api::RouteParameters &route_parameters,
+                              util::binary::Writer &result) const;
 }
 }
 }
@@ -7,74 +7,67 @@ namespace osrm
 namespace engine
 {
 
+constexpr std::size_t SearchEngineData::DEFAULT_MAX_DENSE_HEAP_NODES;
+
 SearchEngineData::SearchEngineHeapPtr SearchEngineData::forward_heap_1;
 SearchEngineData::SearchEngineHeapPtr SearchEngineData::reverse_heap_1;
 SearchEngineData::SearchEngineHeapPtr SearchEngineData::forward_heap_2;
 SearchEngineData::SearchEngineHeapPtr SearchEngineData::reverse_heap_2;
 SearchEngineData::SearchEngineHeapPtr SearchEngineData::forward_heap_3;
 SearchEngineData::SearchEngineHeapPtr SearchEngineData::reverse_heap_3;
+SearchEngineData::SearchEngineHeapPtr SearchEngineData::spare_forward_heap_1;
+SearchEngineData::SearchEngineHeapPtr SearchEngineData::spare_reverse_heap_1;
+SearchEngineData::SearchEngineHeapPtr SearchEngineData::spare_forward_heap_2;
+SearchEngineData::SearchEngineHeapPtr SearchEngineData::spare_reverse_heap_2;
+SearchEngineData::SearchEngineHeapPtr SearchEngineData::spare_forward_heap_3;
+SearchEngineData::SearchEngineHeapPtr SearchEngineData::spare_reverse_heap_3;
 
-void SearchEngineData::InitializeOrClearFirstThreadLocalStorage(const unsigned number_of_nodes)
+void SearchEngineData::InitializeOrClearHeap(SearchEngineHeapPtr &heap,
+                                             SearchEngineHeapPtr &spare_heap,
+                                             const unsigned number_of_nodes) const
 {
-    if (forward_heap_1.get())
-    {
-        forward_heap_1->Clear();
-    }
-    else
+    const auto fits = [&](const SearchEngineHeapPtr &candidate) {
+        return candidate.get() &&
+               candidate->GetIndexStorage().Fits(number_of_nodes, max_dense_heap_nodes);
+    };
+
+    if (!fits(heap) && fits(spare_heap))
     {
-        forward_heap_1.reset(new QueryHeap(number_of_nodes));
+        QueryHeap *const other_heap = heap.release();
+        heap.reset(spare_heap.release());
+        spare_heap.reset(other_heap);
     }
 
-    if (reverse_heap_1.get())
+    if (fits(heap))
     {
-        reverse_heap_1->Clear();
+        heap->Clear();
+        return;
     }
-    else
+
+    const bool use_dense_storage = number_of_nodes <= max_dense_heap_nodes;
+    if (heap.get() && heap->GetIndexStorage().IsDense() != use_dense_storage)
     {
-        reverse_heap_1.reset(new QueryHeap(number_of_nodes));
+        spare_heap.reset(heap.release());
     }
+    heap.reset(new QueryHeap(number_of_nodes, max_dense_heap_nodes));
 }
 
-void SearchEngineData::InitializeOrClearSecondThreadLocalStorage(const unsigned number_of_nodes)
+void SearchEngineData::InitializeOrClearFirstThreadLocalStorage(const unsigned number_of_nodes)
 {
-    if (forward_heap_2.get())
-    {
-        forward_heap_2->Clear();
-    }
-    else
-    {
-        forward_heap_2.reset(new QueryHeap(number_of_nodes));
-    }
+    InitializeOrClearHeap(forward_heap_1, spare_forward_heap_1, number_of_nodes);
+    InitializeOrClearHeap(reverse_heap_1, spare_reverse_heap_1, number_of_nodes);
+}
 
-    if (reverse_heap_2.get())
-    {
-        reverse_heap_2->Clear();
-    }
-    else
-    {
-        reverse_heap_2.reset(new QueryHeap(number_of_nodes));
-    }
+void SearchEngineData::InitializeOrClearSecondThreadLocalStorage(const unsigned number_of_nodes)
+{
+    InitializeOrClearHeap(forward_heap_2, spare_forward_heap_2, number_of_nodes);
+    InitializeOrClearHeap(reverse_heap_2, spare_reverse_heap_2, number_of_nodes);
 }
 
 void SearchEngineData::InitializeOrClearThirdThreadLocalStorage(const unsigned number_of_nodes)
 {
-    if (forward_heap_3.get())
-    {
-        forward_heap_3->Clear();
-    }
-    else
-    {
-        forward_heap_3.reset(new QueryHeap(number_of_nodes));
-    }
-
-    if (reverse_heap_3.get())
-    {
-        reverse_heap_3->Clear();
-    }
-    else
-    {
-        reverse_heap_3.reset(new QueryHeap(number_of_nodes));
-    }
+    InitializeOrClearHeap(forward_heap_3, spare_forward_heap_3, number_of_nodes);
+    InitializeOrClearHeap(reverse_heap_3, spare_reverse_heap_3, number_of_nodes);
 }
 }
 }
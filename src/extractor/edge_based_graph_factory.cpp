@@ -19,6 +19,8 @@
 #include <boost/assert.hpp>
 #include <boost/numeric/conversion/cast.hpp>
 
+#include <tbb/parallel_for.h>
+
 #include <algorithm>
 #include <cmath>
 #include <fstream>
@@ -363,213 +365,308 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
     bearing_class_by_node_based_node.resize(m_node_based_graph->GetNumberOfNodes(),
                                             std::numeric_limits<std::uint32_t>::max());
 
-    for (const auto node_u : util::irange(0u, m_node_based_graph->GetNumberOfNodes()))
+    // The intersections are analysed and the turn penalties computed in parallel in blocks of
+    // nodes. Everything that hands out ids (lane data, entry and bearing classes and the edge
+    // based edges themselves) runs afterwards on a single thread in node order, so the output is
+    // the same for any number of threads.
+    const constexpr std::int32_t NO_TURN_PENALTY = std::numeric_limits<std::int32_t>::max();
+    struct TurnData
     {
+        NodeID node_u;
+        EdgeID edge_from_u;
+        guidance::Intersection intersection;
+        // penalty of the turn onto every road of the intersection, NO_TURN_PENALTY for roads
+        // that cannot be entered
+        std::vector<std::int32_t> turn_penalties;
+    };
+
+    const auto insert_turns = [&](TurnData &turn_data) {
+        const NodeID node_u = turn_data.node_u;
+        const EdgeID edge_from_u = turn_data.edge_from_u;
         progress.PrintStatus(node_u);
-        for (const EdgeID edge_from_u : m_node_based_graph->GetAdjacentEdgeRange(node_u))
+
+        const NodeID node_v = m_node_based_graph->GetTarget(edge_from_u);
+        ++node_based_edge_counter;
+        auto intersection = turn_lane_handler.assignTurnLanes(
+            node_u, edge_from_u, std::move(turn_data.intersection));
+        BOOST_ASSERT(intersection.size() == turn_data.turn_penalties.size());
+
+        std::vector<guidance::TurnOperation> possible_turns;
+        std::vector<std::int32_t> possible_turn_penalties;
+        for (const auto road_index : util::irange<std::size_t>(0UL, intersection.size()))
         {
-            if (m_node_based_graph->GetEdgeData(edge_from_u).reversed)
+            const auto &road = intersection[road_index];
+            if (road.entry_allowed)
             {
-                continue;
+                possible_turns.push_back(road.turn);
+                auto turn_penalty = turn_data.turn_penalties[road_index];
+                // the lane matching allows u-turns that are marked on the lanes
+                if (turn_penalty == NO_TURN_PENALTY)
+                {
+                    turn_penalty =
+                        scripting_environment.GetTurnPenalties({180. - road.turn.angle}).front();
+                }
+                possible_turn_penalties.push_back(turn_penalty);
             }
+        }
+
+        // the entry class depends on the turn, so we have to classify the interesction for
+        // every edge
+        const auto turn_classification = classifyIntersection(intersection);
 
-            const NodeID node_v = m_node_based_graph->GetTarget(edge_from_u);
-            ++node_based_edge_counter;
-            auto intersection = turn_analysis.getIntersection(node_u, edge_from_u);
-            intersection =
-                turn_analysis.assignTurnTypes(node_u, edge_from_u, std::move(intersection));
-            intersection =
-                turn_lane_handler.assignTurnLanes(node_u, edge_from_u, std::move(intersection));
+        const auto entry_class_id = [&](const util::guidance::EntryClass entry_class) {
+            if (0 == entry_class_hash.count(entry_class))
+            {
+                const auto id = static_cast<std::uint16_t>(entry_class_hash.size());
+                entry_class_hash[entry_class] = id;
+                return id;
+            }
+            else
+            {
+                return entry_class_hash.find(entry_class)->second;
+            }
+        }(turn_classification.first);
 
-            const auto possible_turns = turn_analysis.transformIntersectionIntoTurns(intersection);
+        const auto bearing_class_id = [&](const util::guidance::BearingClass bearing_class) {
+            if (0 == bearing_class_hash.count(bearing_class))
+            {
+                const auto id = static_cast<std::uint32_t>(bearing_class_hash.size());
+                bearing_class_hash[bearing_class] = id;
+                return id;
+            }
+            else
+            {
+                return bearing_class_hash.find(bearing_class)->second;
+            }
+        }(turn_classification.second);
+        bearing_class_by_node_based_node[node_v] = bearing_class_id;
 
-            // the entry class depends on the turn, so we have to classify the interesction for
-            // every edge
-            const auto turn_classification = classifyIntersection(intersection);
+        for (const auto turn_index : util::irange<std::size_t>(0UL, possible_turns.size()))
+        {
+            const auto &turn = possible_turns[turn_index];
 
-            const auto entry_class_id = [&](const util::guidance::EntryClass entry_class) {
-                if (0 == entry_class_hash.count(entry_class))
-                {
-                    const auto id = static_cast<std::uint16_t>(entry_class_hash.size());
-                    entry_class_hash[entry_class] = id;
-                    return id;
-                }
-                else
-                {
-                    return entry_class_hash.find(entry_class)->second;
-                }
-            }(turn_classification.first);
+            // only add an edge if turn is not prohibited
+            const EdgeData &edge_data1 = m_node_based_graph->GetEdgeData(edge_from_u);
+            const EdgeData &edge_data2 = m_node_based_graph->GetEdgeData(turn.eid);
 
-            const auto bearing_class_id = [&](const util::guidance::BearingClass bearing_class) {
-                if (0 == bearing_class_hash.count(bearing_class))
-                {
-                    const auto id = static_cast<std::uint32_t>(bearing_class_hash.size());
-                    bearing_class_hash[bearing_class] = id;
-                    return id;
-                }
-                else
-                {
-                    return bearing_class_hash.find(bearing_class)->second;
-                }
-            }(turn_classification.second);
-            bearing_class_by_node_based_node[node_v] = bearing_class_id;
+            BOOST_ASSERT(edge_data1.edge_id != edge_data2.edge_id);
+            BOOST_ASSERT(!edge_data1.reversed);
+            BOOST_ASSERT(!edge_data2.reversed);
 
-            for (const auto turn : possible_turns)
+            // the following is the core of the loop.
+            unsigned distance = edge_data1.distance;
+            if (m_traffic_lights.find(node_v) != m_traffic_lights.end())
             {
-                // only add an edge if turn is not prohibited
-                const EdgeData &edge_data1 = m_node_based_graph->GetEdgeData(edge_from_u);
-                const EdgeData &edge_data2 = m_node_based_graph->GetEdgeData(turn.eid);
+                distance += profile_properties.traffic_signal_penalty;
+            }
 
-                BOOST_ASSERT(edge_data1.edge_id != edge_data2.edge_id);
-                BOOST_ASSERT(!edge_data1.reversed);
-                BOOST_ASSERT(!edge_data2.reversed);
+            const int32_t turn_penalty = possible_turn_penalties[turn_index];
 
-                // the following is the core of the loop.
-                unsigned distance = edge_data1.distance;
-                if (m_traffic_lights.find(node_v) != m_traffic_lights.end())
-                {
-                    distance += profile_properties.traffic_signal_penalty;
-                }
+            const auto turn_instruction = turn.instruction;
 
-                const int32_t turn_penalty =
-                    scripting_environment.GetTurnPenalty(180. - turn.angle);
+            if (turn_instruction.direction_modifier == guidance::DirectionModifier::UTurn)
+            {
+                distance += profile_properties.u_turn_penalty;
+            }
 
-                const auto turn_instruction = turn.instruction;
+            // don't add turn penalty if it is not an actual turn. This heuristic is necessary
+            // since OSRM cannot handle looping roads/parallel roads
+            if (turn_instruction.type != guidance::TurnType::NoTurn)
+                distance += turn_penalty;
+
+            const bool is_encoded_forwards =
+                m_compressed_edge_container.HasZippedEntryForForwardID(edge_from_u);
+            const bool is_encoded_backwards =
+                m_compressed_edge_container.HasZippedEntryForReverseID(edge_from_u);
+            BOOST_ASSERT(is_encoded_forwards || is_encoded_backwards);
+            if (is_encoded_forwards)
+            {
+                original_edge_data_vector.emplace_back(
+                    GeometryID{
+                        m_compressed_edge_container.GetZippedPositionForForwardID(edge_from_u),
+                        true},
+                    edge_data1.name_id,
+                    turn.lane_data_id,
+                    turn_instruction,
+                    entry_class_id,
+                    edge_data1.travel_mode,
+                    util::guidance::TurnBearing(intersection[0].turn.bearing),
+                    util::guidance::TurnBearing(turn.bearing));
+            }
+            else if (is_encoded_backwards)
+            {
+                original_edge_data_vector.emplace_back(
+                    GeometryID{
+                        m_compressed_edge_container.GetZippedPositionForReverseID(edge_from_u),
+                        false},
+                    edge_data1.name_id,
+                    turn.lane_data_id,
+                    turn_instruction,
+                    entry_class_id,
+                    edge_data1.travel_mode,
+                    util::guidance::TurnBearing(intersection[0].turn.bearing),
+                    util::guidance::TurnBearing(turn.bearing));
+            }
 
-                if (turn_instruction.direction_modifier == guidance::DirectionModifier::UTurn)
-                {
-                    distance += profile_properties.u_turn_penalty;
-                }
+            ++original_edges_counter;
 
-                // don't add turn penalty if it is not an actual turn. This heuristic is necessary
-                // since OSRM cannot handle looping roads/parallel roads
-                if (turn_instruction.type != guidance::TurnType::NoTurn)
-                    distance += turn_penalty;
-
-                const bool is_encoded_forwards =
-                    m_compressed_edge_container.HasZippedEntryForForwardID(edge_from_u);
-                const bool is_encoded_backwards =
-                    m_compressed_edge_container.HasZippedEntryForReverseID(edge_from_u);
-                BOOST_ASSERT(is_encoded_forwards || is_encoded_backwards);
-                if (is_encoded_forwards)
-                {
-                    original_edge_data_vector.emplace_back(
-                        GeometryID{
-                            m_compressed_edge_container.GetZippedPositionForForwardID(edge_from_u),
-                            true},
-                        edge_data1.name_id,
-                        turn.lane_data_id,
-                        turn_instruction,
-                        entry_class_id,
-                        edge_data1.travel_mode,
-                        util::guidance::TurnBearing(intersection[0].turn.bearing),
-                        util::guidance::TurnBearing(turn.bearing));
-                }
-                else if (is_encoded_backwards)
-                {
-                    original_edge_data_vector.emplace_back(
-                        GeometryID{
-                            m_compressed_edge_container.GetZippedPositionForReverseID(edge_from_u),
-                            false},
-                        edge_data1.name_id,
-                        turn.lane_data_id,
-                        turn_instruction,
-                        entry_class_id,
-                        edge_data1.travel_mode,
-                        util::guidance::TurnBearing(intersection[0].turn.bearing),
-                        util::guidance::TurnBearing(turn.bearing));
-                }
+            if (original_edge_data_vector.size() > 1024 * 1024 * 10)
+            {
+                FlushVectorToStream(edge_data_file, original_edge_data_vector);
+            }
 
-                ++original_edges_counter;
+            BOOST_ASSERT(SPECIAL_NODEID != edge_data1.edge_id);
+            BOOST_ASSERT(SPECIAL_NODEID != edge_data2.edge_id);
+
+            // NOTE: potential overflow here if we hit 2^32 routable edges
+            BOOST_ASSERT(m_edge_based_edge_list.size() <= std::numeric_limits<NodeID>::max());
+            m_edge_based_edge_list.emplace_back(edge_data1.edge_id,
+                                                edge_data2.edge_id,
+                                                m_edge_based_edge_list.size(),
+                                                distance,
+                                                true,
+                                                false);
+
+            // Here is where we write out the mapping between the edge-expanded edges, and
+            // the node-based edges that are originally used to calculate the `distance`
+            // for the edge-expanded edges.  About 40 lines back, there is:
+            //
+            //                 unsigned distance = edge_data1.distance;
+            //
+            // This tells us that the weight for an edge-expanded-edge is based on the weight
+            // of the *source* node-based edge.  Therefore, we will look up the individual
+            // segments of the source node-based edge, and write out a mapping between
+            // those and the edge-based-edge ID.
+            // External programs can then use this mapping to quickly perform
+            // updates to the edge-expanded-edge based directly on its ID.
+            if (generate_edge_lookup)
+            {
+                const auto node_based_edges =
+                    m_compressed_edge_container.GetBucketReference(edge_from_u);
+                NodeID previous = node_u;
 
-                if (original_edge_data_vector.size() > 1024 * 1024 * 10)
-                {
-                    FlushVectorToStream(edge_data_file, original_edge_data_vector);
-                }
+                const unsigned node_count = node_based_edges.size() + 1;
+                const QueryNode &first_node = m_node_info_list[previous];
+
+                lookup::SegmentHeaderBlock header = {node_count, first_node.node_id};
 
-                BOOST_ASSERT(SPECIAL_NODEID != edge_data1.edge_id);
-                BOOST_ASSERT(SPECIAL_NODEID != edge_data2.edge_id);
-
-                // NOTE: potential overflow here if we hit 2^32 routable edges
-                BOOST_ASSERT(m_edge_based_edge_list.size() <= std::numeric_limits<NodeID>::max());
-                m_edge_based_edge_list.emplace_back(edge_data1.edge_id,
-                                                    edge_data2.edge_id,
-                                                    m_edge_based_edge_list.size(),
-                                                    distance,
-                                                    true,
-                                                    false);
-
-                // Here is where we write out the mapping between the edge-expanded edges, and
-                // the node-based edges that are originally used to calculate the `distance`
-                // for the edge-expanded edges.  About 40 lines back, there is:
-                //
-                //                 unsigned distance = edge_data1.distance;
-                //
-                // This tells us that the weight for an edge-expanded-edge is based on the weight
-                // of the *source* node-based edge.  Therefore, we will look up the individual
-                // segments of the source node-based edge, and write out a mapping between
-                // those and the edge-based-edge ID.
-                // External programs can then use this mapping to quickly perform
-                // updates to the edge-expanded-edge based directly on its ID.
-                if (generate_edge_lookup)
+                edge_segment_file.write(reinterpret_cast<const char *>(&header),
+                                        sizeof(header));
+
+                for (auto target_node : node_based_edges)
                 {
-                    const auto node_based_edges =
-                        m_compressed_edge_container.GetBucketReference(edge_from_u);
-                    NodeID previous = node_u;
+                    const QueryNode &from = m_node_info_list[previous];
+                    const QueryNode &to = m_node_info_list[target_node.node_id];
+                    const double segment_length =
+                        util::coordinate_calculation::greatCircleDistance(from, to);
 
-                    const unsigned node_count = node_based_edges.size() + 1;
-                    const QueryNode &first_node = m_node_info_list[previous];
+                    lookup::SegmentBlock nodeblock = {
+                        to.node_id, segment_length, target_node.weight};
 
-                    lookup::SegmentHeaderBlock header = {node_count, first_node.node_id};
+                    edge_segment_file.write(reinterpret_cast<const char *>(&nodeblock),
+                                            sizeof(nodeblock));
+                    previous = target_node.node_id;
+                }
 
-                    edge_segment_file.write(reinterpret_cast<const char *>(&header),
-                                            sizeof(header));
+                // We also now write out the mapping between the edge-expanded edges and the
+                // original nodes. Since each edge represents a possible maneuver, external
+                // programs can use this to quickly perform updates to edge weights in order
+                // to penalize certain turns.
+
+                // If this edge is 'trivial' -- where the compressed edge corresponds
+                // exactly to an original OSM segment -- we can pull the turn's preceding
+                // node ID directly with `node_u`; otherwise, we need to look up the node
+                // immediately preceding the turn from the compressed edge container.
+                const bool isTrivial = m_compressed_edge_container.IsTrivial(edge_from_u);
+
+                const auto &from_node =
+                    isTrivial
+                        ? m_node_info_list[node_u]
+                        : m_node_info_list[m_compressed_edge_container.GetLastEdgeSourceID(
+                              edge_from_u)];
+                const auto &via_node =
+                    m_node_info_list[m_compressed_edge_container.GetLastEdgeTargetID(
+                        edge_from_u)];
+                const auto &to_node =
+                    m_node_info_list[m_compressed_edge_container.GetFirstEdgeTargetID(
+                        turn.eid)];
+
+                const unsigned fixed_penalty = distance - edge_data1.distance;
+                lookup::PenaltyBlock penaltyblock = {
+                    fixed_penalty, from_node.node_id, via_node.node_id, to_node.node_id};
+                edge_penalty_file.write(reinterpret_cast<const char *>(&penaltyblock),
+                                        sizeof(penaltyblock));
+            }
+        }
+    };
 
-                    for (auto target_node : node_based_edges)
+    const constexpr NodeID BLOCK_SIZE = 256;
+    const constexpr NodeID BLOCKS_PER_BATCH = 256;
+    const NodeID number_of_nodes = m_node_based_graph->GetNumberOfNodes();
+    std::vector<std::vector<TurnData>> blocks(BLOCKS_PER_BATCH);
+    for (NodeID batch_begin = 0; batch_begin < number_of_nodes;
+         batch_begin += BLOCK_SIZE * BLOCKS_PER_BATCH)
+    {
+        const NodeID batch_end =
+            std::min(number_of_nodes, batch_begin + BLOCK_SIZE * BLOCKS_PER_BATCH);
+        const NodeID number_of_blocks = (batch_end - batch_begin + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+        tbb::parallel_for(NodeID{0}, number_of_blocks, [&](const NodeID block) {
+            auto &block_turns = blocks[block];
+            block_turns.clear();
+            const NodeID block_begin = batch_begin + block * BLOCK_SIZE;
+            const NodeID block_end = std::min(batch_end, block_begin + BLOCK_SIZE);
+            std::vector<double> turn_angles;
+            for (const auto node_u : util::irange(block_begin, block_end))
+            {
+                for (const EdgeID edge_from_u : m_node_based_graph->GetAdjacentEdgeRange(node_u))
+                {
+                    if (m_node_based_graph->GetEdgeData(edge_from_u).reversed)
                     {
-                        const QueryNode &from = m_node_info_list[previous];
-                        const QueryNode &to = m_node_info_list[target_node.node_id];
-                        const double segment_length =
-                            util::coordinate_calculation::greatCircleDistance(from, to);
+                        continue;
+                    }
 
-                        lookup::SegmentBlock nodeblock = {
-                            to.node_id, segment_length, target_node.weight};
+                    auto intersection = turn_analysis.getIntersection(node_u, edge_from_u);
+                    intersection = turn_analysis.assignTurnTypes(
+                        node_u, edge_from_u, std::move(intersection));
 
-                        edge_segment_file.write(reinterpret_cast<const char *>(&nodeblock),
-                                                sizeof(nodeblock));
-                        previous = target_node.node_id;
+                    // turns that cannot be taken get no edge, so the profile is not asked for
+                    // their penalty
+                    turn_angles.clear();
+                    for (const auto &road : intersection)
+                    {
+                        if (road.entry_allowed)
+                        {
+                            turn_angles.push_back(180. - road.turn.angle);
+                        }
+                    }
+                    const auto allowed_turn_penalties =
+                        scripting_environment.GetTurnPenalties(turn_angles);
+
+                    std::vector<std::int32_t> turn_penalties(intersection.size(),
+                                                             NO_TURN_PENALTY);
+                    auto allowed_turn_penalty = allowed_turn_penalties.begin();
+                    for (const auto road_index :
+                         util::irange<std::size_t>(0UL, intersection.size()))
+                    {
+                        if (intersection[road_index].entry_allowed)
+                        {
+                            turn_penalties[road_index] = *allowed_turn_penalty++;
+                        }
                     }
 
-                    // We also now write out the mapping between the edge-expanded edges and the
-                    // original nodes. Since each edge represents a possible maneuver, external
-                    // programs can use this to quickly perform updates to edge weights in order
-                    // to penalize certain turns.
-
-                    // If this edge is 'trivial' -- where the compressed edge corresponds
-                    // exactly to an original OSM segment -- we can pull the turn's preceding
-                    // node ID directly with `node_u`; otherwise, we need to look up the node
-                    // immediately preceding the turn from the compressed edge container.
-                    const bool isTrivial = m_compressed_edge_container.IsTrivial(edge_from_u);
-
-                    const auto &from_node =
-                        isTrivial
-                            ? m_node_info_list[node_u]
-                            : m_node_info_list[m_compressed_edge_container.GetLastEdgeSourceID(
-                                  edge_from_u)];
-                    const auto &via_node =
-                        m_node_info_list[m_compressed_edge_container.GetLastEdgeTargetID(
-                            edge_from_u)];
-                    const auto &to_node =
-                        m_node_info_list[m_compressed_edge_container.GetFirstEdgeTargetID(
-                            turn.eid)];
-
-                    const unsigned fixed_penalty = distance - edge_data1.distance;
-                    lookup::PenaltyBlock penaltyblock = {
-                        fixed_penalty, from_node.node_id, via_node.node_id, to_node.node_id};
-                    edge_penalty_file.write(reinterpret_cast<const char *>(&penaltyblock),
-                                            sizeof(penaltyblock));
+                    block_turns.push_back(TurnData{
+                        node_u, edge_from_u, std::move(intersection), std::move(turn_penalties)});
                 }
             }
+        });
+
+        for (const auto block : util::irange<NodeID>(0, number_of_blocks))
+        {
+            for (auto &turn_data : blocks[block])
+            {
+                insert_turns(turn_data);
+            }
         }
     }
 
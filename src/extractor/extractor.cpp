@@ -33,6 +33,7 @@
 #include <osmium/io/any_input.hpp>
 
 #include <tbb/concurrent_vector.h>
+#include <tbb/pipeline.h>
 #include <tbb/task_scheduler_init.h>
 
 #include <cstdlib>
@@ -158,54 +159,86 @@ int Extractor::run(ScriptingEnvironment &scripting_environment)
         boost::filesystem::ofstream timestamp_out(config.timestamp_file_name);
         timestamp_out.write(timestamp.c_str(), timestamp.length());
 
-        // initialize vectors holding parsed objects
-        tbb::concurrent_vector<std::pair<std::size_t, ExtractionNode>> resulting_nodes;
-        tbb::concurrent_vector<std::pair<std::size_t, ExtractionWay>> resulting_ways;
-        tbb::concurrent_vector<boost::optional<InputRestrictionContainer>> resulting_restrictions;
-
         // setup restriction parser
         const RestrictionParser restriction_parser(scripting_environment);
 
-        while (const osmium::memory::Buffer buffer = reader.read())
+        // Parsed objects of one buffer, the buffer is kept alive until the objects are ingested
+        struct ParsedBuffer
         {
-            // create a vector of iterators into the buffer
+            std::shared_ptr<const osmium::memory::Buffer> buffer;
             std::vector<osmium::memory::Buffer::const_iterator> osm_elements;
-            for (auto iter = std::begin(buffer), end = std::end(buffer); iter != end; ++iter)
+            tbb::concurrent_vector<std::pair<std::size_t, ExtractionNode>> resulting_nodes;
+            tbb::concurrent_vector<std::pair<std::size_t, ExtractionWay>> resulting_ways;
+            tbb::concurrent_vector<boost::optional<InputRestrictionContainer>>
+                resulting_restrictions;
+        };
+        using SharedBuffer = std::shared_ptr<const osmium::memory::Buffer>;
+        using SharedParsedBuffer = std::shared_ptr<ParsedBuffer>;
+
+        // Reading the next buffer, running the profile on the buffers read before and putting
+        // the results of earlier buffers thru the extractor callbacks overlap. The number of
+        // buffers in flight is bounded to limit the memory used for parsed objects.
+        const auto buffers_in_flight = number_of_threads * 2;
+
+        const auto read_buffer = [&](tbb::flow_control &flow_control) -> SharedBuffer {
+            auto buffer = std::make_shared<osmium::memory::Buffer>(reader.read());
+            if (!*buffer)
             {
-                osm_elements.push_back(iter);
+                flow_control.stop();
+                return {};
             }
+            return buffer;
+        };
 
-            // clear resulting vectors
-            resulting_nodes.clear();
-            resulting_ways.clear();
-            resulting_restrictions.clear();
+        const auto process_buffer = [&](const SharedBuffer &buffer) {
+            auto parsed_buffer = std::make_shared<ParsedBuffer>();
+            parsed_buffer->buffer = buffer;
 
-            scripting_environment.ProcessElements(osm_elements,
+            // create a vector of iterators into the buffer
+            for (auto iter = std::begin(*buffer), end = std::end(*buffer); iter != end; ++iter)
+            {
+                parsed_buffer->osm_elements.push_back(iter);
+            }
+
+            scripting_environment.ProcessElements(parsed_buffer->osm_elements,
                                                   restriction_parser,
-                                                  resulting_nodes,
-                                                  resulting_ways,
-                                                  resulting_restrictions);
+                                                  parsed_buffer->resulting_nodes,
+                                                  parsed_buffer->resulting_ways,
+                                                  parsed_buffer->resulting_restrictions);
+            return parsed_buffer;
+        };
+
+        const auto ingest_buffer = [&](const SharedParsedBuffer &parsed_buffer) {
+            const auto &osm_elements = parsed_buffer->osm_elements;
 
-            number_of_nodes += resulting_nodes.size();
+            number_of_nodes += parsed_buffer->resulting_nodes.size();
             // put parsed objects thru extractor callbacks
-            for (const auto &result : resulting_nodes)
+            for (const auto &result : parsed_buffer->resulting_nodes)
             {
                 extractor_callbacks->ProcessNode(
                     static_cast<const osmium::Node &>(*(osm_elements[result.first])),
                     result.second);
             }
-            number_of_ways += resulting_ways.size();
-            for (const auto &result : resulting_ways)
+            number_of_ways += parsed_buffer->resulting_ways.size();
+            for (const auto &result : parsed_buffer->resulting_ways)
             {
                 extractor_callbacks->ProcessWay(
                     static_cast<const osmium::Way &>(*(osm_elements[result.first])), result.second);
             }
-            number_of_relations += resulting_restrictions.size();
-            for (const auto &result : resulting_restrictions)
+            number_of_relations += parsed_buffer->resulting_restrictions.size();
+            for (const auto &result : parsed_buffer->resulting_restrictions)
             {
                 extractor_callbacks->ProcessRestriction(result);
             }
-        }
+        };
+
+        tbb::parallel_pipeline(
+            buffers_in_flight,
+            tbb::make_filter<void, SharedBuffer>(tbb::filter::serial_in_order, read_buffer) &
+                tbb::make_filter<SharedBuffer, SharedParsedBuffer>(tbb::filter::parallel,
+                                                                   process_buffer) &
+                tbb::make_filter<SharedParsedBuffer, void>(tbb::filter::serial_in_order,
+                                                           ingest_buffer));
         TIMER_STOP(parsing);
         util::SimpleLogger().Write() << "Parsing finished after " << TIMER_SEC(parsing)
                                      << " seconds";
@@ -577,6 +610,10 @@ void Extractor::BuildRTree(std::vector<EdgeBasedNode> node_based_edge_list,
                                                                    config.rtree_leafs_output_path,
                                                                    internal_to_external_node_map);
 
+    // The new leaves use the extraction order of the nodes, any renumbering done by an earlier
+    // osrm-contract run does not apply to them.
+    boost::filesystem::remove(config.node_order_output_path);
+
     TIMER_STOP(construction);
     util::SimpleLogger().Write() << "finished r-tree construction in " << TIMER_SEC(construction)
                                  << " seconds";
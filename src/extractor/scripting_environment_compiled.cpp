@@ -0,0 +1,120 @@
+#include "extractor/scripting_environment_compiled.hpp"
+
+#include "extractor/extraction_node.hpp"
+#include "extractor/extraction_way.hpp"
+#include "util/exception.hpp"
+#include "util/simple_logger.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/numeric/conversion/cast.hpp>
+
+#include <osmium/osm.hpp>
+
+#ifndef _WIN32
+#include <dlfcn.h>
+#endif
+
+#include <limits>
+
+namespace osrm
+{
+namespace extractor
+{
+
+CompiledScriptingEnvironment::CompiledScriptingEnvironment(const std::string &file_name)
+    : library_handle(nullptr)
+{
+    util::SimpleLogger().Write() << "Using compiled profile " << file_name;
+
+#ifndef _WIN32
+    library_handle = dlopen(file_name.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (library_handle == nullptr)
+    {
+        throw util::exception("Could not load profile " + file_name + ": " + dlerror());
+    }
+
+    const auto factory =
+        reinterpret_cast<CompiledProfileFactory>(dlsym(library_handle, COMPILED_PROFILE_FACTORY));
+    if (factory == nullptr)
+    {
+        dlclose(library_handle);
+        throw util::exception("Profile " + file_name + " does not export " +
+                              COMPILED_PROFILE_FACTORY);
+    }
+
+    profile.reset(factory());
+    properties = profile->GetProfileProperties();
+#else
+    throw util::exception("Compiled profiles are not supported on this platform");
+#endif
+}
+
+CompiledScriptingEnvironment::~CompiledScriptingEnvironment()
+{
+    // the profile's code lives in the library
+    profile.reset();
+#ifndef _WIN32
+    if (library_handle != nullptr)
+    {
+        dlclose(library_handle);
+    }
+#endif
+}
+
+const ProfileProperties &CompiledScriptingEnvironment::GetProfileProperties()
+{
+    return properties;
+}
+
+std::vector<std::string> CompiledScriptingEnvironment::GetNameSuffixList()
+{
+    return profile->GetNameSuffixList();
+}
+
+std::vector<std::string> CompiledScriptingEnvironment::GetRestrictions()
+{
+    return profile->GetRestrictions();
+}
+
+// raster sources are only available to lua profiles
+void CompiledScriptingEnvironment::SetupSources() {}
+
+int32_t CompiledScriptingEnvironment::GetTurnPenalty(const double angle)
+{
+    const double penalty = profile->GetTurnPenalty(angle);
+    BOOST_ASSERT(penalty < std::numeric_limits<int32_t>::max());
+    BOOST_ASSERT(penalty > std::numeric_limits<int32_t>::min());
+    return boost::numeric_cast<int32_t>(penalty);
+}
+
+void CompiledScriptingEnvironment::ProcessSegment(const osrm::util::Coordinate &source,
+                                                  const osrm::util::Coordinate &target,
+                                                  double distance,
+                                                  InternalExtractorEdge::WeightData &weight)
+{
+    profile->ProcessSegment(source, target, distance, weight);
+}
+
+std::vector<int32_t>
+CompiledScriptingEnvironment::GetTurnPenalties(const std::vector<double> &angles)
+{
+    std::vector<int32_t> penalties;
+    penalties.reserve(angles.size());
+    for (const auto angle : angles)
+    {
+        penalties.push_back(GetTurnPenalty(angle));
+    }
+    return penalties;
+}
+
+void CompiledScriptingEnvironment::ProcessNode(const osmium::Node &node, ExtractionNode &result)
+{
+    profile->ProcessNode(node, result);
+}
+
+void CompiledScriptingEnvironment::ProcessWay(const osmium::Way &way, ExtractionWay &result)
+{
+    profile->ProcessWay(way, result);
+}
+}
+}
@@ -9,6 +9,7 @@
 #include "extractor/raster_source.hpp"
 #include "extractor/restriction_parser.hpp"
 #include "util/exception.hpp"
+#include "util/integer_range.hpp"
 #include "util/lua_util.hpp"
 #include "util/simple_logger.hpp"
 #include "util/typedefs.hpp"
@@ -19,10 +20,9 @@
 
 #include <osmium/osm.hpp>
 
-#include <tbb/parallel_for.h>
-
 #include <memory>
 #include <sstream>
+#include <string>
 
 namespace osrm
 {
@@ -234,6 +234,8 @@ void LuaScriptingEnvironment::InitContext(LuaScriptingContext &context)
     }
 
     context.has_turn_penalty_function = util::luaFunctionExists(context.state, "turn_function");
+    context.has_turn_penalties_function =
+        util::luaFunctionExists(context.state, "turn_penalties_function");
     context.has_node_function = util::luaFunctionExists(context.state, "node_function");
     context.has_way_function = util::luaFunctionExists(context.state, "way_function");
     context.has_segment_function = util::luaFunctionExists(context.state, "segment_function");
@@ -246,67 +248,36 @@ const ProfileProperties &LuaScriptingEnvironment::GetProfileProperties()
 
 LuaScriptingContext &LuaScriptingEnvironment::GetLuaContext()
 {
-    std::lock_guard<std::mutex> lock(init_mutex);
     bool initialized = false;
     auto &ref = script_contexts.local(initialized);
     if (!initialized)
     {
+        // luabind's class registry and error callback are process wide
+        std::lock_guard<std::mutex> lock(init_mutex);
         ref = std::make_unique<LuaScriptingContext>();
         InitContext(*ref);
+        luabind::set_pcall_callback(&luaErrorCallback);
     }
-    luabind::set_pcall_callback(&luaErrorCallback);
 
     return *ref;
 }
 
-void LuaScriptingEnvironment::ProcessElements(
-    const std::vector<osmium::memory::Buffer::const_iterator> &osm_elements,
-    const RestrictionParser &restriction_parser,
-    tbb::concurrent_vector<std::pair<std::size_t, ExtractionNode>> &resulting_nodes,
-    tbb::concurrent_vector<std::pair<std::size_t, ExtractionWay>> &resulting_ways,
-    tbb::concurrent_vector<boost::optional<InputRestrictionContainer>> &resulting_restrictions)
+void LuaScriptingEnvironment::ProcessNode(const osmium::Node &node, ExtractionNode &result)
 {
-    // parse OSM entities in parallel, store in resulting vectors
-    tbb::parallel_for(
-        tbb::blocked_range<std::size_t>(0, osm_elements.size()),
-        [&](const tbb::blocked_range<std::size_t> &range) {
-            ExtractionNode result_node;
-            ExtractionWay result_way;
-            auto &local_context = this->GetLuaContext();
-
-            for (auto x = range.begin(), end = range.end(); x != end; ++x)
-            {
-                const auto entity = osm_elements[x];
-
-                switch (entity->type())
-                {
-                case osmium::item_type::node:
-                    result_node.clear();
-                    if (local_context.has_node_function)
-                    {
-                        local_context.processNode(static_cast<const osmium::Node &>(*entity),
-                                                  result_node);
-                    }
-                    resulting_nodes.push_back(std::make_pair(x, std::move(result_node)));
-                    break;
-                case osmium::item_type::way:
-                    result_way.clear();
-                    if (local_context.has_way_function)
-                    {
-                        local_context.processWay(static_cast<const osmium::Way &>(*entity),
-                                                 result_way);
-                    }
-                    resulting_ways.push_back(std::make_pair(x, std::move(result_way)));
-                    break;
-                case osmium::item_type::relation:
-                    resulting_restrictions.push_back(restriction_parser.TryParse(
-                        static_cast<const osmium::Relation &>(*entity)));
-                    break;
-                default:
-                    break;
-                }
-            }
-        });
+    auto &local_context = GetLuaContext();
+    if (local_context.has_node_function)
+    {
+        local_context.processNode(node, result);
+    }
+}
+
+void LuaScriptingEnvironment::ProcessWay(const osmium::Way &way, ExtractionWay &result)
+{
+    auto &local_context = GetLuaContext();
+    if (local_context.has_way_function)
+    {
+        local_context.processWay(way, result);
+    }
 }
 
 std::vector<std::string> LuaScriptingEnvironment::GetNameSuffixList()
@@ -395,6 +366,81 @@ void LuaScriptingEnvironment::ProcessSegment(const osrm::util::Coordinate &sourc
     }
 }
 
+std::vector<int32_t> LuaScriptingEnvironment::GetTurnPenalties(const std::vector<double> &angles)
+{
+    std::vector<int32_t> penalties(angles.size(), 0);
+    auto &context = GetLuaContext();
+    if (!context.has_turn_penalties_function && !context.has_turn_penalty_function)
+        return penalties;
+
+    BOOST_ASSERT(context.state != nullptr);
+    lua_State *state = context.state;
+    const int stack_top = lua_gettop(state);
+
+    // the penalty on top of the stack, a profile returning anything else is broken
+    const auto pop_penalty = [state, stack_top](const char *function_name) {
+        if (!lua_isnumber(state, -1))
+        {
+            lua_settop(state, stack_top);
+            throw util::exception(std::string(function_name) + " has to return numbers");
+        }
+        const double penalty = lua_tonumber(state, -1);
+        lua_pop(state, 1);
+        BOOST_ASSERT(penalty < std::numeric_limits<int32_t>::max());
+        BOOST_ASSERT(penalty > std::numeric_limits<int32_t>::min());
+        return boost::numeric_cast<int32_t>(penalty);
+    };
+
+    // a single call with all angles as an array and the penalties as an array in return
+    if (context.has_turn_penalties_function)
+    {
+        lua_getglobal(state, "turn_penalties_function");
+        lua_createtable(state, static_cast<int>(angles.size()), 0);
+        for (const auto index : util::irange<std::size_t>(0UL, angles.size()))
+        {
+            lua_pushnumber(state, angles[index]);
+            lua_rawseti(state, -2, static_cast<int>(index + 1));
+        }
+        if (0 != lua_pcall(state, 1, 1, 0))
+        {
+            util::SimpleLogger().Write(logWARNING) << lua_tostring(state, -1);
+            lua_settop(state, stack_top);
+            return penalties;
+        }
+        if (!lua_istable(state, -1))
+        {
+            lua_settop(state, stack_top);
+            throw util::exception("turn_penalties_function has to return an array of numbers");
+        }
+        for (const auto index : util::irange<std::size_t>(0UL, angles.size()))
+        {
+            lua_rawgeti(state, -1, static_cast<int>(index + 1));
+            penalties[index] = pop_penalty("turn_penalties_function");
+        }
+        lua_settop(state, stack_top);
+        return penalties;
+    }
+
+    // keep turn_function on the stack and call copies of it, this saves the global lookup and
+    // the luabind argument conversion for every angle
+    lua_getglobal(state, "turn_function");
+    for (const auto index : util::irange<std::size_t>(0UL, angles.size()))
+    {
+        lua_pushvalue(state, -1);
+        lua_pushnumber(state, angles[index]);
+        if (0 != lua_pcall(state, 1, 1, 0))
+        {
+            util::SimpleLogger().Write(logWARNING) << lua_tostring(state, -1);
+            lua_pop(state, 1);
+            continue;
+        }
+        penalties[index] = pop_penalty("turn_function");
+    }
+    lua_settop(state, stack_top);
+
+    return penalties;
+}
+
 void LuaScriptingContext::processNode(const osmium::Node &node, ExtractionNode &result)
 {
     BOOST_ASSERT(state != nullptr);
@@ -1,6 +1,7 @@
 #include "server/connection.hpp"
 #include "server/request_handler.hpp"
 #include "server/request_parser.hpp"
+#include "server/worker_pool.hpp"
 
 #include <boost/assert.hpp>
 #include <boost/bind.hpp>
@@ -16,16 +17,48 @@ namespace osrm
 namespace server
 {
 
-Connection::Connection(boost::asio::io_service &io_service, RequestHandler &handler)
-    : strand(io_service), TCP_socket(io_service), request_handler(handler)
+namespace
+{
+// the service is the first path segment, e.g. "route" for /route/v1/driving/...
+std::string getServiceName(const std::string &uri)
+{
+    const auto begin = uri.find_first_not_of('/');
+    if (begin == std::string::npos)
+    {
+        return {};
+    }
+    return uri.substr(begin, uri.find('/', begin) - begin);
+}
+}
+
+Connection::Connection(boost::asio::io_service &io_service,
+                       RequestHandler &handler,
+                       WorkerPool &worker_pool,
+                       const int keepalive_timeout,
+                       const int keepalive_max_requests)
+    : strand(io_service), TCP_socket(io_service), timer(io_service), request_handler(handler),
+      worker_pool(worker_pool), keepalive_timeout(keepalive_timeout),
+      keepalive_max_requests(keepalive_max_requests), processed_requests(0), keep_alive(false),
+      unparsed_begin(nullptr), unparsed_end(nullptr)
 {
 }
 
 boost::asio::ip::tcp::socket &Connection::socket() { return TCP_socket; }
 
 /// Start the first asynchronous operation for the connection.
-void Connection::start()
+void Connection::start() { read(); }
+
+void Connection::read()
 {
+    // only the wait for a follow-up request on a kept alive connection is bounded
+    if (processed_requests > 0)
+    {
+        timer.expires_from_now(boost::posix_time::seconds(keepalive_timeout));
+        timer.async_wait(strand.wrap(boost::bind(&Connection::handle_timeout,
+                                                 this->shared_from_this(),
+                                                 boost::asio::placeholders::error)));
+    }
+
     TCP_socket.async_read_some(
         boost::asio::buffer(incoming_data_buffer),
         strand.wrap(boost::bind(&Connection::handle_read,
@@ -38,59 +71,71 @@ void Connection::handle_read(const boost::system::error_code &error, std::size_t
 {
     if (error)
     {
+        // the connection is closed or broken, a pending wait must not touch the socket anymore
+        boost::system::error_code ignore_error;
+        timer.cancel(ignore_error);
         return;
     }
 
+    // data arrived, the connection is not idle anymore. this also cancels a pending wait
+    timer.expires_at(boost::posix_time::pos_infin);
+
+    handle_data(incoming_data_buffer.data(), incoming_data_buffer.data() + bytes_transferred);
+}
+
+void Connection::handle_data(char *begin, char *end)
+{
     // no error detected, let's parse the request
     http::compression_type compression_type(http::no_compression);
     RequestParser::RequestStatus result;
-    std::tie(result, compression_type) =
-        request_parser.parse(current_request,
-                             incoming_data_buffer.data(),
-                             incoming_data_buffer.data() + bytes_transferred);
+    char *parsed_end;
+    std::tie(result, compression_type, parsed_end) =
+        request_parser.parse(current_request, begin, end);
 
     // the request has been parsed
     if (result == RequestParser::RequestStatus::valid)
     {
-        current_request.endpoint = TCP_socket.remote_endpoint().address();
-        request_handler.HandleRequest(current_request, current_reply);
+        // anything after the request is the start of the next pipelined request
+        unparsed_begin = parsed_end;
+        unparsed_end = end;
+
+        ++processed_requests;
+        keep_alive = current_request.keep_alive && keepalive_timeout > 0 &&
+                     processed_requests < keepalive_max_requests;
+
+        // the peer may have reset the connection while a pipelined request was answered
+        boost::system::error_code endpoint_error;
+        const auto remote_endpoint = TCP_socket.remote_endpoint(endpoint_error);
+        if (endpoint_error)
+        {
+            boost::system::error_code ignore_error;
+            TCP_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignore_error);
+            TCP_socket.close(ignore_error);
+            return;
+        }
+        current_request.endpoint = remote_endpoint.address();
+
+        // queries run on the worker pool, so a slow request does not block socket I/O of other
+        // connections. Nothing else touches this connection until the reply is written.
+        auto self = this->shared_from_this();
+        const bool queued =
+            worker_pool.TryPost(getServiceName(current_request.uri), [self, compression_type] {
+                self->handle_request(compression_type);
+            });
 
-        // compress the result w/ gzip/deflate if requested
-        switch (compression_type)
+        if (!queued)
         {
-        case http::deflate_rfc1951:
-            // use deflate for compression
-            current_reply.headers.insert(current_reply.headers.begin(),
-                                         {"Content-Encoding", "deflate"});
-            compressed_output = compress_buffers(current_reply.content, compression_type);
-            current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
-            output_buffer = current_reply.headers_to_buffers();
-            output_buffer.push_back(boost::asio::buffer(compressed_output));
-            break;
-        case http::gzip_rfc1952:
-            // use gzip for compression
-            current_reply.headers.insert(current_reply.headers.begin(),
-                                         {"Content-Encoding", "gzip"});
-            compressed_output = compress_buffers(current_reply.content, compression_type);
-            current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
-            output_buffer = current_reply.headers_to_buffers();
-            output_buffer.push_back(boost::asio::buffer(compressed_output));
-            break;
-        case http::no_compression:
-            // don't use any compression
-            current_reply.set_uncompressed_size();
+            current_reply = http::reply::stock_reply(http::reply::service_unavailable);
+            current_reply.set_http_version(current_request.http_version_major,
+                                           current_request.http_version_minor);
+            current_reply.set_keep_alive(keep_alive);
             output_buffer = current_reply.to_buffers();
-            break;
+            write_reply();
         }
-        // write result to stream
-        boost::asio::async_write(TCP_socket,
-                                 output_buffer,
-                                 strand.wrap(boost::bind(&Connection::handle_write,
-                                                         this->shared_from_this(),
-                                                         boost::asio::placeholders::error)));
     }
     else if (result == RequestParser::RequestStatus::invalid)
     { // request is not parseable
+        keep_alive = false;
         current_reply = http::reply::stock_reply(http::reply::bad_request);
 
         boost::asio::async_write(TCP_socket,
@@ -102,24 +147,105 @@ void Connection::handle_read(const boost::system::error_code &error, std::size_t
     else
     {
         // we don't have a result yet, so continue reading
-        TCP_socket.async_read_some(
-            boost::asio::buffer(incoming_data_buffer),
-            strand.wrap(boost::bind(&Connection::handle_read,
-                                    this->shared_from_this(),
-                                    boost::asio::placeholders::error,
-                                    boost::asio::placeholders::bytes_transferred)));
+        read();
     }
 }
 
+void Connection::handle_request(const http::compression_type compression_type)
+{
+    request_handler.HandleRequest(current_request, current_reply);
+    current_reply.set_http_version(current_request.http_version_major,
+                                   current_request.http_version_minor);
+    current_reply.set_keep_alive(keep_alive);
+
+    // compress the result w/ gzip/deflate if requested
+    switch (compression_type)
+    {
+    case http::deflate_rfc1951:
+        // use deflate for compression
+        current_reply.headers.insert(current_reply.headers.begin(),
+                                     {"Content-Encoding", "deflate"});
+        compressed_output = compress_buffers(current_reply.content, compression_type);
+        current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
+        output_buffer = current_reply.headers_to_buffers();
+        output_buffer.push_back(boost::asio::buffer(compressed_output));
+        break;
+    case http::gzip_rfc1952:
+        // use gzip for compression
+        current_reply.headers.insert(current_reply.headers.begin(),
+                                     {"Content-Encoding", "gzip"});
+        compressed_output = compress_buffers(current_reply.content, compression_type);
+        current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
+        output_buffer = current_reply.headers_to_buffers();
+        output_buffer.push_back(boost::asio::buffer(compressed_output));
+        break;
+    case http::no_compression:
+        // don't use any compression
+        current_reply.set_uncompressed_size();
+        output_buffer = current_reply.to_buffers();
+        break;
+    }
+
+    // hand the socket operations back to the I/O threads
+    strand.post(boost::bind(&Connection::write_reply, this->shared_from_this()));
+}
+
+void Connection::write_reply()
+{
+    boost::asio::async_write(TCP_socket,
+                             output_buffer,
+                             strand.wrap(boost::bind(&Connection::handle_write,
+                                                     this->shared_from_this(),
+                                                     boost::asio::placeholders::error)));
+}
+
 /// Handle completion of a write operation.
 void Connection::handle_write(const boost::system::error_code &error)
 {
-    if (!error)
+    if (error)
+    {
+        return;
+    }
+
+    if (!keep_alive)
     {
         // Initiate graceful connection closure.
         boost::system::error_code ignore_error;
         TCP_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignore_error);
+        return;
     }
+
+    // prepare for the next request on this connection
+    current_request = http::request();
+    current_reply = http::reply();
+    compressed_output.clear();
+    output_buffer.clear();
+    request_parser.reset();
+
+    // pipelined requests are answered before reading from the socket again. The buffer is not
+    // touched while the reply is written, so the unparsed range is still valid.
+    if (unparsed_begin != unparsed_end)
+    {
+        handle_data(unparsed_begin, unparsed_end);
+    }
+    else
+    {
+        read();
+    }
+}
+
+void Connection::handle_timeout(const boost::system::error_code &error)
+{
+    // the timer was cancelled or moved to the future because a request arrived in time
+    if (error == boost::asio::error::operation_aborted ||
+        timer.expires_at() > boost::asio::deadline_timer::traits_type::now())
+    {
+        return;
+    }
+
+    boost::system::error_code ignore_error;
+    TCP_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignore_error);
+    TCP_socket.close(ignore_error);
 }
 
 std::vector<char> Connection::compress_buffers(const std::vector<char> &uncompressed_data,
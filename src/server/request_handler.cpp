@@ -24,6 +24,7 @@
 #include <iostream>
 #include <iterator>
 #include <string>
+#include <utility>
 
 namespace osrm
 {
@@ -54,10 +55,13 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
         auto api_iterator = request_string.begin();
         auto maybe_parsed_url = api::parseURL(api_iterator, request_string.end());
         ServiceHandler::ResultT result;
+        // vector tiles and the binary route / table responses are both returned as std::string
+        bool is_tile = false;
 
         // check if the was an error with the request
         if (maybe_parsed_url && api_iterator == request_string.end())
         {
+            is_tile = maybe_parsed_url->service == "tile";
 
             const engine::Status status =
                 service_handler->RunQuery(*std::move(maybe_parsed_url), result);
@@ -103,6 +107,14 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
 
             util::json::render(current_reply.content, result.get<util::json::Object>());
         }
+        else if (result.is<std::vector<char>>())
+        {
+            current_reply.headers.emplace_back("Content-Type", "application/json; charset=UTF-8");
+            current_reply.headers.emplace_back("Content-Disposition",
+                                               "inline; filename=\"response.json\"");
+
+            current_reply.content = std::move(result.get<std::vector<char>>());
+        }
         else
         {
             BOOST_ASSERT(result.is<std::string>());
@@ -111,7 +123,14 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
                       result.get<std::string>().cend(),
                       current_reply.content.begin());
 
-            current_reply.headers.emplace_back("Content-Type", "application/x-protobuf");
+            if (is_tile)
+            {
+                current_reply.headers.emplace_back("Content-Type", "application/x-protobuf");
+            }
+            else
+            {
+                current_reply.headers.emplace_back("Content-Type", "application/octet-stream");
+            }
         }
 
         // set headers
@@ -15,11 +15,20 @@ namespace server
 
 RequestParser::RequestParser()
     : state(internal_state::method_start), current_header({"", ""}),
-      selected_compression(http::no_compression)
+      selected_compression(http::no_compression), http_version_major(0), http_version_minor(0)
 {
 }
 
-std::tuple<RequestParser::RequestStatus, http::compression_type>
+void RequestParser::reset()
+{
+    state = internal_state::method_start;
+    current_header.clear();
+    selected_compression = http::no_compression;
+    http_version_major = 0;
+    http_version_minor = 0;
+}
+
+std::tuple<RequestParser::RequestStatus, http::compression_type, char *>
 RequestParser::parse(http::request &current_request, char *begin, char *end)
 {
     while (begin != end)
@@ -27,12 +36,12 @@ RequestParser::parse(http::request &current_request, char *begin, char *end)
         RequestStatus result = consume(current_request, *begin++);
         if (result != RequestStatus::indeterminate)
         {
-            return std::make_tuple(result, selected_compression);
+            return std::make_tuple(result, selected_compression, begin);
         }
     }
     RequestStatus result = RequestStatus::indeterminate;
 
-    return std::make_tuple(result, selected_compression);
+    return std::make_tuple(result, selected_compression, begin);
 }
 
 RequestParser::RequestStatus RequestParser::consume(http::request &current_request,
@@ -116,6 +125,7 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
     case internal_state::http_version_major_start:
         if (is_digit(input))
         {
+            http_version_major = input - '0';
             state = internal_state::http_version_major;
             return RequestStatus::indeterminate;
         }
@@ -128,12 +138,14 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
         }
         if (is_digit(input))
         {
+            http_version_major = http_version_major * 10 + input - '0';
             return RequestStatus::indeterminate;
         }
         return RequestStatus::invalid;
     case internal_state::http_version_minor_start:
         if (is_digit(input))
         {
+            http_version_minor = input - '0';
             state = internal_state::http_version_minor;
             return RequestStatus::indeterminate;
         }
@@ -141,11 +153,17 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
     case internal_state::http_version_minor:
         if (input == '\r')
         {
+            current_request.http_version_major = http_version_major;
+            current_request.http_version_minor = http_version_minor;
+            // HTTP/1.1 connections are persistent by default, HTTP/1.0 ones need to ask for it
+            current_request.keep_alive =
+                http_version_major > 1 || (http_version_major == 1 && http_version_minor >= 1);
             state = internal_state::expecting_newline_1;
             return RequestStatus::indeterminate;
         }
         if (is_digit(input))
         {
+            http_version_minor = http_version_minor * 10 + input - '0';
             return RequestStatus::indeterminate;
         }
         return RequestStatus::invalid;
@@ -180,6 +198,18 @@ RequestParser::RequestStatus RequestParser::consume(http::request &current_reque
             current_request.agent = current_header.value;
         }
 
+        if (boost::iequals(current_header.name, "Connection"))
+        {
+            if (boost::icontains(current_header.value, "close"))
+            {
+                current_request.keep_alive = false;
+            }
+            else if (boost::icontains(current_header.value, "keep-alive"))
+            {
+                current_request.keep_alive = true;
+            }
+        }
+
         if (input == '\r')
         {
             state = internal_state::expecting_newline_3;
@@ -4,6 +4,7 @@
 #include "server/api/parameters_parser.hpp"
 #include "engine/api/route_parameters.hpp"
 
+#include "util/binary_writer.hpp"
 #include "util/json_container.hpp"
 
 namespace osrm
@@ -64,6 +65,13 @@ RouteService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &r
     }
     BOOST_ASSERT(parameters->IsValid());
 
+    if (parameters->format == engine::api::RouteParameters::OutputFormatType::Binary)
+    {
+        result = std::string();
+        util::binary::Writer writer(result.get<std::string>());
+        return BaseService::routing_machine.Route(*parameters, writer);
+    }
+
     return BaseService::routing_machine.Route(*parameters, json_result);
 }
 }
@@ -3,7 +3,9 @@
 #include "server/api/parameters_parser.hpp"
 #include "engine/api/table_parameters.hpp"
 
+#include "util/binary_writer.hpp"
 #include "util/json_container.hpp"
+#include "util/json_writer.hpp"
 
 #include <boost/format.hpp>
 
@@ -85,7 +87,17 @@ TableService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &r
     }
     BOOST_ASSERT(parameters->IsValid());
 
-    return BaseService::routing_machine.Table(*parameters, json_result);
+    if (parameters->format == engine::api::TableParameters::OutputFormatType::Binary)
+    {
+        result = std::string();
+        util::binary::Writer writer(result.get<std::string>());
+        return BaseService::routing_machine.Table(*parameters, writer);
+    }
+
+    // stream the response, large tables are expensive to build as json::Object
+    result = std::vector<char>();
+    util::json::Writer writer(result.get<std::vector<char>>());
+    return BaseService::routing_machine.Table(*parameters, writer);
 }
 }
 }
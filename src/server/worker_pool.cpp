@@ -0,0 +1,133 @@
+#include "server/worker_pool.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tuple>
+#include <utility>
+
+namespace osrm
+{
+namespace server
+{
+
+WorkerPool::WorkerPool(const unsigned num_threads,
+                       const int max_queue_size,
+                       const ServiceLimits &service_limits)
+    : work(std::make_unique<boost::asio::io_service::work>(io_service)), stopped(false),
+      max_queue_size(max_queue_size), queue_size(0)
+{
+    BOOST_ASSERT(num_threads > 0);
+
+    for (const auto &service_limit : service_limits)
+    {
+        service_queues.emplace(std::piecewise_construct,
+                               std::forward_as_tuple(service_limit.first),
+                               std::forward_as_tuple(service_limit.second));
+    }
+
+    for (unsigned i = 0; i < num_threads; ++i)
+    {
+        threads.emplace_back([this] { io_service.run(); });
+    }
+}
+
+WorkerPool::~WorkerPool() { Stop(); }
+
+void WorkerPool::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+
+    // the workers return once every queued task has run. Tasks waiting for a service are
+    // posted by the task finishing before them, so no task is dropped.
+    work.reset();
+    for (auto &thread : threads)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+
+    BOOST_ASSERT(queue_size == 0);
+}
+
+bool WorkerPool::TryPost(const std::string &service, std::function<void()> task)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (stopped)
+    {
+        return false;
+    }
+
+    const auto is_full = [this](const std::size_t size) {
+        return max_queue_size >= 0 && size >= static_cast<std::size_t>(max_queue_size);
+    };
+
+    const auto service_iter = service_queues.find(service);
+    ServiceQueue *service_queue = nullptr;
+    if (service_iter != service_queues.end())
+    {
+        service_queue = &service_iter->second;
+        if (service_queue->limit == 0)
+        {
+            return false;
+        }
+
+        // waits in the queue of the service, which has its own bound
+        if (service_queue->limit > 0 && service_queue->running >= service_queue->limit)
+        {
+            if (is_full(service_queue->waiting.size()))
+            {
+                return false;
+            }
+            service_queue->waiting.push_back(std::move(task));
+            return true;
+        }
+    }
+
+    if (is_full(queue_size))
+    {
+        return false;
+    }
+
+    ++queue_size;
+    if (service_queue)
+    {
+        ++service_queue->running;
+    }
+    Post(service_queue, std::move(task));
+    return true;
+}
+
+void WorkerPool::Post(ServiceQueue *service_queue, std::function<void()> task)
+{
+    io_service.post([this, service_queue, task = std::move(task)] {
+        task();
+        Finish(service_queue);
+    });
+}
+
+void WorkerPool::Finish(ServiceQueue *service_queue)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // hand the slots of the finished task to the next waiting one
+    if (service_queue && !service_queue->waiting.empty())
+    {
+        Post(service_queue, std::move(service_queue->waiting.front()));
+        service_queue->waiting.pop_front();
+        return;
+    }
+
+    --queue_size;
+    if (service_queue)
+    {
+        --service_queue->running;
+    }
+}
+}
+}
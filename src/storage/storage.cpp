@@ -29,6 +29,7 @@
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
 #include <boost/interprocess/exceptions.hpp>
 #include <boost/interprocess/sync/named_sharable_mutex.hpp>
 #include <boost/interprocess/sync/named_upgradable_mutex.hpp>
@@ -50,11 +51,14 @@ namespace storage
 {
 
 using RTreeLeaf = engine::datafacade::BaseDataFacade::RTreeLeaf;
-using RTreeNode =
-    util::StaticRTree<RTreeLeaf, util::ShM<util::Coordinate, true>::vector, true>::TreeNode;
-using QueryGraph = util::StaticGraph<contractor::QueryEdge::EdgeData>;
+using RTree = util::StaticRTree<RTreeLeaf, util::ShM<util::Coordinate, true>::vector, true>;
+using RTreeNode = RTree::TreeNode;
+using QueryGraph = util::StaticGraph<contractor::QueryEdge::SearchData>;
 
-Storage::Storage(StorageConfig config_) : config(std::move(config_)) {}
+Storage::Storage(StorageConfig config_, bool load_rtree_leaves_)
+    : config(std::move(config_)), load_rtree_leaves(load_rtree_leaves_)
+{
+}
 
 struct RegionsLayout
 {
@@ -262,6 +266,8 @@ Storage::ReturnCode Storage::Run(int max_wait)
                                                                 hsgr_header.number_of_nodes);
     shared_layout_ptr->SetBlockSize<QueryGraph::EdgeArrayEntry>(SharedDataLayout::GRAPH_EDGE_LIST,
                                                                 hsgr_header.number_of_edges);
+    shared_layout_ptr->SetBlockSize<contractor::QueryEdge::UnpackData>(
+        SharedDataLayout::GRAPH_EDGE_UNPACK_LIST, hsgr_header.number_of_edges);
 
     // load rsearch tree size
     boost::filesystem::ifstream tree_node_file(config.ram_index_path, std::ios::binary);
@@ -269,6 +275,16 @@ Storage::ReturnCode Storage::Run(int max_wait)
     const auto tree_size = io::readElementCount(tree_node_file);
     shared_layout_ptr->SetBlockSize<RTreeNode>(SharedDataLayout::R_SEARCH_TREE, tree_size);
 
+    // the leaves are stored at the alignment of their pages
+    const auto leaves_size =
+        load_rtree_leaves ? boost::filesystem::file_size(config.file_index_path) : 0;
+    if (load_rtree_leaves)
+    {
+        util::SimpleLogger().Write() << "load rtree leaves from: " << config.file_index_path;
+        shared_layout_ptr->SetBlockSize<char>(SharedDataLayout::R_SEARCH_LEAVES,
+                                              leaves_size + alignof(RTree::LeafNode) - 1);
+    }
+
     // allocate space in shared memory for profile properties
     const auto properties_size = io::readPropertiesCount();
     shared_layout_ptr->SetBlockSize<extractor::ProfileProperties>(SharedDataLayout::PROPERTIES,
@@ -681,6 +697,19 @@ Storage::ReturnCode Storage::Run(int max_wait)
         shared_memory_ptr, SharedDataLayout::R_SEARCH_TREE);
     io::readRamIndex(tree_node_file, rtree_ptrtest, tree_size);
 
+    // store the leaves of the rtree
+    auto rtree_leaves_ptr = shared_layout_ptr->GetAlignedBlockPtr<RTree::LeafNode, true>(
+        shared_memory_ptr, SharedDataLayout::R_SEARCH_LEAVES);
+    if (leaves_size > 0)
+    {
+        boost::filesystem::ifstream leaves_input_stream(config.file_index_path, std::ios::binary);
+        leaves_input_stream.read(reinterpret_cast<char *>(rtree_leaves_ptr), leaves_size);
+        if (!leaves_input_stream)
+        {
+            throw util::exception("Could not read " + config.file_index_path.string());
+        }
+    }
+
     // load core markers
     std::vector<char> unpacked_core_markers(number_of_core_markers);
     core_marker_file.read((char *)unpacked_core_markers.data(),
@@ -720,10 +749,16 @@ Storage::ReturnCode Storage::Run(int max_wait)
         shared_layout_ptr->GetBlockPtr<QueryGraph::EdgeArrayEntry, true>(
             shared_memory_ptr, SharedDataLayout::GRAPH_EDGE_LIST);
 
+    // load the data that is only needed to unpack the edges of the search graph
+    contractor::QueryEdge::UnpackData *graph_edge_unpack_list_ptr =
+        shared_layout_ptr->GetBlockPtr<contractor::QueryEdge::UnpackData, true>(
+            shared_memory_ptr, SharedDataLayout::GRAPH_EDGE_UNPACK_LIST);
+
     io::readHSGR(hsgr_input_stream,
                  graph_node_list_ptr,
                  hsgr_header.number_of_nodes,
                  graph_edge_list_ptr,
+                 graph_edge_unpack_list_ptr,
                  hsgr_header.number_of_edges);
     hsgr_input_stream.close();
 
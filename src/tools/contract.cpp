@@ -53,6 +53,15 @@ return_code parseArguments(int argc, char *argv[], contractor::ContractorConfig
         boost::program_options::value<bool>(&contractor_config.use_cached_priority)
             ->default_value(false),
         "Use .level file to retain the contaction level for each node from the last run.")(
+        "renumber-nodes",
+        boost::program_options::value<bool>(&contractor_config.renumber_nodes)
+            ->default_value(false),
+        "Renumber the nodes of the contracted graph to improve the memory locality of queries.")(
+        "customize",
+        boost::program_options::value<bool>(&contractor_config.customize_hierarchy)
+            ->default_value(false),
+        "Only update the weights of the hierarchy from the last run to the new segment speeds "
+        "and turn penalties. Contracts the graph again if the hierarchy can not be kept.")(
         "edge-weight-updates-over-factor",
         boost::program_options::value<double>(&contractor_config.log_edge_updates_factor)
             ->default_value(0.0),
@@ -1,5 +1,6 @@
 #include "extractor/extractor.hpp"
 #include "extractor/extractor_config.hpp"
+#include "extractor/scripting_environment_compiled.hpp"
 #include "extractor/scripting_environment_lua.hpp"
 #include "util/simple_logger.hpp"
 #include "util/version.hpp"
@@ -11,6 +12,7 @@
 
 #include <cstdlib>
 #include <exception>
+#include <memory>
 #include <new>
 
 using namespace osrm;
@@ -34,7 +36,7 @@ return_code parseArguments(int argc, char *argv[], extractor::ExtractorConfig &e
         "profile,p",
         boost::program_options::value<boost::filesystem::path>(&extractor_config.profile_path)
             ->default_value("profile.lua"),
-        "Path to LUA routing profile")(
+        "Path to LUA routing profile or compiled profile library")(
         "threads,t",
         boost::program_options::value<unsigned int>(&extractor_config.requested_num_threads)
             ->default_value(tbb::task_scheduler_init::default_num_threads()),
@@ -151,9 +153,18 @@ int main(int argc, char *argv[]) try
     }
 
     // setup scripting environment
-    extractor::LuaScriptingEnvironment scripting_environment(
-        extractor_config.profile_path.string().c_str());
-    return extractor::Extractor(extractor_config).run(scripting_environment);
+    std::unique_ptr<extractor::ScriptingEnvironment> scripting_environment;
+    if (extractor_config.IsCompiledProfile())
+    {
+        scripting_environment = std::make_unique<extractor::CompiledScriptingEnvironment>(
+            extractor_config.profile_path.string());
+    }
+    else
+    {
+        scripting_environment = std::make_unique<extractor::LuaScriptingEnvironment>(
+            extractor_config.profile_path.string().c_str());
+    }
+    return extractor::Extractor(extractor_config).run(*scripting_environment);
 }
 catch (const std::bad_alloc &e)
 {
@@ -1,4 +1,5 @@
 #include "server/server.hpp"
+#include "util/rtree_warmup.hpp"
 #include "util/simple_logger.hpp"
 #include "util/version.hpp"
 
@@ -23,8 +24,10 @@
 #include <iostream>
 #include <memory>
 #include <new>
+#include <stdexcept>
 #include <string>
 #include <thread>
+#include <vector>
 
 #ifdef _WIN32
 boost::function0<void> console_ctrl_function;
@@ -58,17 +61,29 @@ inline unsigned generateServerProgramOptions(const int argc,
                                              std::string &ip_address,
                                              int &ip_port,
                                              int &requested_num_threads,
+                                             int &requested_io_threads,
+                                             int &max_queue_size,
+                                             server::WorkerPool::ServiceLimits &service_limits,
+                                             int &keepalive_timeout,
+                                             int &keepalive_max_requests,
                                              bool &use_shared_memory,
                                              bool &trial,
                                              int &max_locations_trip,
                                              int &max_locations_viaroute,
                                              int &max_locations_distance_table,
                                              int &max_locations_map_matching,
-                                             int &max_results_nearest)
+                                             int &max_results_nearest,
+                                             int &max_parallelism_distance_table,
+                                             int &max_dense_heap_nodes,
+                                             util::RTreeWarmup &rtree_warmup,
+                                             boost::filesystem::path &rtree_hot_pages_path)
 {
     using boost::program_options::value;
     using boost::filesystem::path;
 
+    std::vector<std::string> service_limit_options;
+    std::string rtree_warmup_option;
+
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
     generic_options.add_options()                                         //
@@ -87,6 +102,22 @@ inline unsigned generateServerProgramOptions(const int argc,
         ("threads,t",
          value<int>(&requested_num_threads)->default_value(8),
          "Number of threads to use") //
+        ("io-threads",
+         value<int>(&requested_io_threads)->default_value(2),
+         "Number of threads handling network I/O, in addition to the query threads") //
+        ("max-queue-size",
+         value<int>(&max_queue_size)->default_value(1000),
+         "Max. requests queued or running before the server replies 503 (-1 for unlimited)") //
+        ("max-concurrent-requests",
+         value<std::vector<std::string>>(&service_limit_options)->composing(),
+         "Max. concurrently running requests of a service, further ones wait in a queue of the "
+         "service bounded by --max-queue-size, e.g. table=2 (0 rejects the service, repeatable)") //
+        ("keepalive-timeout",
+         value<int>(&keepalive_timeout)->default_value(5),
+         "Seconds to keep an idle connection open (0 disables keep-alive)") //
+        ("keepalive-max-requests",
+         value<int>(&keepalive_max_requests)->default_value(1000),
+         "Max. requests served on a single keep-alive connection") //
         ("shared-memory,s",
          value<bool>(&use_shared_memory)->implicit_value(true)->default_value(false),
          "Load data from shared memory") //
@@ -104,7 +135,19 @@ inline unsigned generateServerProgramOptions(const int argc,
          "Max. locations supported in map matching query") //
         ("max-nearest-size",
          value<int>(&max_results_nearest)->default_value(100),
-         "Max. results supported in nearest query");
+         "Max. results supported in nearest query") //
+        ("max-table-parallelism",
+         value<int>(&max_parallelism_distance_table)->default_value(1),
+         "Max. threads used by a single distance table query (-1 for all)") //
+        ("max-dense-heap-nodes",
+         value<int>(&max_dense_heap_nodes)->default_value(1 << 22),
+         "Max. graph size in nodes for dense search heap indices (-1 for unlimited)") //
+        ("rtree-warmup",
+         value<std::string>(&rtree_warmup_option)->default_value("none"),
+         "Load the R-tree leaves before the first query: none, advise, populate or hot-pages") //
+        ("rtree-hot-pages",
+         value<boost::filesystem::path>(&rtree_hot_pages_path),
+         "File of the R-tree pages used by the last dataset, read and written by hot-pages");
 
     // hidden options, will be allowed on command line, but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -154,6 +197,40 @@ inline unsigned generateServerProgramOptions(const int argc,
 
     boost::program_options::notify(option_variables);
 
+    for (const auto &service_limit : service_limit_options)
+    {
+        const auto separator = service_limit.find('=');
+        try
+        {
+            if (separator == std::string::npos || separator == 0)
+            {
+                throw std::invalid_argument(service_limit);
+            }
+            service_limits[service_limit.substr(0, separator)] =
+                std::stoi(service_limit.substr(separator + 1));
+        }
+        catch (const std::logic_error &)
+        {
+            util::SimpleLogger().Write(logWARNING)
+                << "[error] invalid --max-concurrent-requests value " << service_limit
+                << ", expected <service>=<number>";
+            return INIT_FAILED;
+        }
+    }
+
+    if (!util::parseRTreeWarmup(rtree_warmup_option, rtree_warmup))
+    {
+        util::SimpleLogger().Write(logWARNING) << "[error] invalid --rtree-warmup value "
+                                               << rtree_warmup_option;
+        return INIT_FAILED;
+    }
+    if (rtree_warmup == util::RTreeWarmup::HotPages && rtree_hot_pages_path.empty())
+    {
+        util::SimpleLogger().Write(logWARNING)
+            << "[error] --rtree-warmup hot-pages needs an --rtree-hot-pages file";
+        return INIT_FAILED;
+    }
+
     if (!use_shared_memory && option_variables.count("base"))
     {
         return INIT_OK_START_ENGINE;
@@ -178,7 +255,9 @@ int main(int argc, const char *argv[]) try
 
     bool trial_run = false;
     std::string ip_address;
-    int ip_port, requested_thread_num;
+    int ip_port, requested_thread_num, requested_io_threads, max_queue_size;
+    int keepalive_timeout, keepalive_max_requests;
+    server::WorkerPool::ServiceLimits service_limits;
 
     EngineConfig config;
     boost::filesystem::path base_path;
@@ -188,13 +267,22 @@ int main(int argc, const char *argv[]) try
                                                               ip_address,
                                                               ip_port,
                                                               requested_thread_num,
+                                                              requested_io_threads,
+                                                              max_queue_size,
+                                                              service_limits,
+                                                              keepalive_timeout,
+                                                              keepalive_max_requests,
                                                               config.use_shared_memory,
                                                               trial_run,
                                                               config.max_locations_trip,
                                                               config.max_locations_viaroute,
                                                               config.max_locations_distance_table,
                                                               config.max_locations_map_matching,
-                                                              config.max_results_nearest);
+                                                              config.max_results_nearest,
+                                                              config.max_parallelism_distance_table,
+                                                              config.max_dense_heap_nodes,
+                                                              config.rtree_warmup,
+                                                              config.rtree_hot_pages_path);
     if (init_result == INIT_OK_DO_NOT_START_ENGINE)
     {
         return EXIT_SUCCESS;
@@ -306,8 +394,10 @@ int main(int argc, const char *argv[]) try
     }
 
     util::SimpleLogger().Write() << "Threads: " << requested_thread_num;
+    util::SimpleLogger().Write() << "I/O threads: " << requested_io_threads;
     util::SimpleLogger().Write() << "IP address: " << ip_address;
     util::SimpleLogger().Write() << "IP port: " << ip_port;
+    util::SimpleLogger().Write() << "Keep-alive timeout: " << keepalive_timeout << "s";
 
 #ifndef _WIN32
     int sig = 0;
@@ -317,7 +407,14 @@ int main(int argc, const char *argv[]) try
     pthread_sigmask(SIG_BLOCK, &new_mask, &old_mask);
 #endif
 
-    auto routing_server = server::Server::CreateServer(ip_address, ip_port, requested_thread_num);
+    auto routing_server = server::Server::CreateServer(ip_address,
+                                                       ip_port,
+                                                       requested_thread_num,
+                                                       requested_io_threads,
+                                                       keepalive_timeout,
+                                                       keepalive_max_requests,
+                                                       max_queue_size,
+                                                       service_limits);
     auto service_handler = std::make_unique<server::ServiceHandler>(config);
 
     routing_server->RegisterServiceHandler(std::move(service_handler));
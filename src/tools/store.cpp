@@ -13,7 +13,8 @@ using namespace osrm;
 bool generateDataStoreOptions(const int argc,
                               const char *argv[],
                               boost::filesystem::path &base_path,
-                              int &max_wait)
+                              int &max_wait,
+                              bool &load_rtree_leaves)
 {
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
@@ -25,7 +26,13 @@ bool generateDataStoreOptions(const int argc,
     config_options.add_options()(
         "max-wait",
         boost::program_options::value<int>(&max_wait)->default_value(-1),
-        "Maximum number of seconds to wait on requests that use the old dataset.");
+        "Maximum number of seconds to wait on requests that use the old dataset.")(
+        "load-rtree-leaves",
+        boost::program_options::value<bool>(&load_rtree_leaves)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Load the leaves of the R-tree into shared memory instead of mapping the .fileIndex "
+        "file in osrm-routed.");
 
     // hidden options, will be allowed on command line but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -93,7 +100,8 @@ int main(const int argc, const char *argv[]) try
 
     boost::filesystem::path base_path;
     int max_wait = -1;
-    if (!generateDataStoreOptions(argc, argv, base_path, max_wait))
+    bool load_rtree_leaves = false;
+    if (!generateDataStoreOptions(argc, argv, base_path, max_wait, load_rtree_leaves))
     {
         return EXIT_SUCCESS;
     }
@@ -103,7 +111,7 @@ int main(const int argc, const char *argv[]) try
         util::SimpleLogger().Write(logWARNING) << "Config contains invalid file paths. Exiting!";
         return EXIT_FAILURE;
     }
-    storage::Storage storage(std::move(config));
+    storage::Storage storage(std::move(config), load_rtree_leaves);
 
     // We will attempt to load this dataset to memory several times if we encounter
     // an error we can recover from. This is needed when we need to clear mutexes
@@ -0,0 +1,466 @@
+#include "util/rtree_kernels.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define OSRM_RTREE_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace osrm
+{
+namespace util
+{
+namespace rtree_kernels
+{
+
+namespace
+{
+
+using SegmentKernel = void (*)(const std::int32_t *,
+                               const std::int32_t *,
+                               const std::int32_t *,
+                               const std::int32_t *,
+                               const std::size_t,
+                               const std::int32_t,
+                               const std::int32_t,
+                               std::uint64_t *,
+                               std::int32_t *,
+                               std::int32_t *);
+using RectangleKernel = void (*)(const std::int32_t *,
+                                 const std::int32_t *,
+                                 const std::int32_t *,
+                                 const std::int32_t *,
+                                 const std::size_t,
+                                 const std::int32_t,
+                                 const std::int32_t,
+                                 std::uint64_t *);
+
+// Same as coordinate_calculation::squaredEuclideanDistance
+inline std::uint64_t squaredDistance(const std::int32_t delta_lon, const std::int32_t delta_lat)
+{
+    const std::uint64_t dx = delta_lon;
+    const std::uint64_t dy = delta_lat;
+    return dx * dx + dy * dy;
+}
+
+// The closest point is computed like coordinate_calculation::projectPointOnSegment, but in the
+// fixed point units to get the same results as the vectorized kernels.
+void segmentDistancesScalar(const std::int32_t *u_lon,
+                            const std::int32_t *u_lat,
+                            const std::int32_t *v_lon,
+                            const std::int32_t *v_lat,
+                            const std::size_t count,
+                            const std::int32_t lon,
+                            const std::int32_t lat,
+                            std::uint64_t *squared_distances,
+                            std::int32_t *nearest_lon,
+                            std::int32_t *nearest_lat)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const double source_lon = u_lon[i];
+        const double source_lat = u_lat[i];
+        const double slope_lon = v_lon[i] - source_lon;
+        const double slope_lat = v_lat[i] - source_lat;
+        const double relative_lon = lon - source_lon;
+        const double relative_lat = lat - source_lat;
+
+        const double unnormed_ratio = slope_lon * relative_lon + slope_lat * relative_lat;
+        const double squared_length = slope_lon * slope_lon + slope_lat * slope_lat;
+        double ratio = squared_length > 0 ? unnormed_ratio / squared_length : 0.;
+        ratio = std::min(std::max(ratio, 0.), 1.);
+
+        nearest_lon[i] = static_cast<std::int32_t>(source_lon + ratio * slope_lon);
+        nearest_lat[i] = static_cast<std::int32_t>(source_lat + ratio * slope_lat);
+        squared_distances[i] = squaredDistance(lon - nearest_lon[i], lat - nearest_lat[i]);
+    }
+}
+
+void rectangleDistancesScalar(const std::int32_t *min_lon,
+                              const std::int32_t *max_lon,
+                              const std::int32_t *min_lat,
+                              const std::int32_t *max_lat,
+                              const std::size_t count,
+                              const std::int32_t lon,
+                              const std::int32_t lat,
+                              std::uint64_t *squared_distances)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const std::int32_t delta_lon = std::max({min_lon[i] - lon, 0, lon - max_lon[i]});
+        const std::int32_t delta_lat = std::max({min_lat[i] - lat, 0, lat - max_lat[i]});
+        squared_distances[i] = squaredDistance(delta_lon, delta_lat);
+    }
+}
+
+#ifdef OSRM_RTREE_KERNELS_X86
+
+// Lambdas do not inherit the target of the enclosing function, so the kernels use these helpers
+
+__attribute__((target("sse4.1"))) inline __m128d loadSSE41(const std::int32_t *values)
+{
+    return _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(values)));
+}
+
+__attribute__((target("sse4.1"))) inline __m128i squareSSE41(const __m128i delta)
+{
+    const __m128i wide_delta = _mm_cvtepi32_epi64(delta);
+    return _mm_mul_epi32(wide_delta, wide_delta);
+}
+
+__attribute__((target("avx2"))) inline __m256d loadAVX2(const std::int32_t *values)
+{
+    return _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i *>(values)));
+}
+
+__attribute__((target("avx2"))) inline __m256i squareAVX2(const __m128i delta)
+{
+    const __m256i wide_delta = _mm256_cvtepi32_epi64(delta);
+    return _mm256_mul_epi32(wide_delta, wide_delta);
+}
+
+__attribute__((target("sse4.1"))) void segmentDistancesSSE41(const std::int32_t *u_lon,
+                                                             const std::int32_t *u_lat,
+                                                             const std::int32_t *v_lon,
+                                                             const std::int32_t *v_lat,
+                                                             const std::size_t count,
+                                                             const std::int32_t lon,
+                                                             const std::int32_t lat,
+                                                             std::uint64_t *squared_distances,
+                                                             std::int32_t *nearest_lon,
+                                                             std::int32_t *nearest_lat)
+{
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d one = _mm_set1_pd(1.);
+    const __m128d coordinate_lon = _mm_set1_pd(lon);
+    const __m128d coordinate_lat = _mm_set1_pd(lat);
+    const __m128i fixed_lon = _mm_set1_epi32(lon);
+    const __m128i fixed_lat = _mm_set1_epi32(lat);
+
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        const __m128d source_lon = loadSSE41(u_lon + i);
+        const __m128d source_lat = loadSSE41(u_lat + i);
+        const __m128d slope_lon = _mm_sub_pd(loadSSE41(v_lon + i), source_lon);
+        const __m128d slope_lat = _mm_sub_pd(loadSSE41(v_lat + i), source_lat);
+        const __m128d relative_lon = _mm_sub_pd(coordinate_lon, source_lon);
+        const __m128d relative_lat = _mm_sub_pd(coordinate_lat, source_lat);
+
+        const __m128d unnormed_ratio = _mm_add_pd(_mm_mul_pd(slope_lon, relative_lon),
+                                                  _mm_mul_pd(slope_lat, relative_lat));
+        const __m128d squared_length =
+            _mm_add_pd(_mm_mul_pd(slope_lon, slope_lon), _mm_mul_pd(slope_lat, slope_lat));
+        // zero length segments have the ratio 0
+        const __m128d has_length = _mm_cmpgt_pd(squared_length, zero);
+        const __m128d ratio = _mm_and_pd(
+            _mm_min_pd(_mm_max_pd(_mm_div_pd(unnormed_ratio, squared_length), zero), one),
+            has_length);
+
+        const __m128i closest_lon =
+            _mm_cvttpd_epi32(_mm_add_pd(source_lon, _mm_mul_pd(ratio, slope_lon)));
+        const __m128i closest_lat =
+            _mm_cvttpd_epi32(_mm_add_pd(source_lat, _mm_mul_pd(ratio, slope_lat)));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(nearest_lon + i), closest_lon);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(nearest_lat + i), closest_lat);
+
+        const __m128i distance = _mm_add_epi64(squareSSE41(_mm_sub_epi32(fixed_lon, closest_lon)),
+                                               squareSSE41(_mm_sub_epi32(fixed_lat, closest_lat)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(squared_distances + i), distance);
+    }
+
+    segmentDistancesScalar(u_lon + i,
+                           u_lat + i,
+                           v_lon + i,
+                           v_lat + i,
+                           count - i,
+                           lon,
+                           lat,
+                           squared_distances + i,
+                           nearest_lon + i,
+                           nearest_lat + i);
+}
+
+__attribute__((target("sse4.1"))) void rectangleDistancesSSE41(const std::int32_t *min_lon,
+                                                               const std::int32_t *max_lon,
+                                                               const std::int32_t *min_lat,
+                                                               const std::int32_t *max_lat,
+                                                               const std::size_t count,
+                                                               const std::int32_t lon,
+                                                               const std::int32_t lat,
+                                                               std::uint64_t *squared_distances)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i coordinate_lon = _mm_set1_epi32(lon);
+    const __m128i coordinate_lat = _mm_set1_epi32(lat);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i lower_lon = _mm_loadu_si128(reinterpret_cast<const __m128i *>(min_lon + i));
+        const __m128i upper_lon = _mm_loadu_si128(reinterpret_cast<const __m128i *>(max_lon + i));
+        const __m128i lower_lat = _mm_loadu_si128(reinterpret_cast<const __m128i *>(min_lat + i));
+        const __m128i upper_lat = _mm_loadu_si128(reinterpret_cast<const __m128i *>(max_lat + i));
+        const __m128i delta_lon =
+            _mm_max_epi32(_mm_max_epi32(_mm_sub_epi32(lower_lon, coordinate_lon), zero),
+                          _mm_sub_epi32(coordinate_lon, upper_lon));
+        const __m128i delta_lat =
+            _mm_max_epi32(_mm_max_epi32(_mm_sub_epi32(lower_lat, coordinate_lat), zero),
+                          _mm_sub_epi32(coordinate_lat, upper_lat));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(squared_distances + i),
+                         _mm_add_epi64(squareSSE41(delta_lon), squareSSE41(delta_lat)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(squared_distances + i + 2),
+                         _mm_add_epi64(squareSSE41(_mm_srli_si128(delta_lon, 8)),
+                                       squareSSE41(_mm_srli_si128(delta_lat, 8))));
+    }
+
+    rectangleDistancesScalar(min_lon + i,
+                             max_lon + i,
+                             min_lat + i,
+                             max_lat + i,
+                             count - i,
+                             lon,
+                             lat,
+                             squared_distances + i);
+}
+
+__attribute__((target("avx2"))) void segmentDistancesAVX2(const std::int32_t *u_lon,
+                                                          const std::int32_t *u_lat,
+                                                          const std::int32_t *v_lon,
+                                                          const std::int32_t *v_lat,
+                                                          const std::size_t count,
+                                                          const std::int32_t lon,
+                                                          const std::int32_t lat,
+                                                          std::uint64_t *squared_distances,
+                                                          std::int32_t *nearest_lon,
+                                                          std::int32_t *nearest_lat)
+{
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.);
+    const __m256d coordinate_lon = _mm256_set1_pd(lon);
+    const __m256d coordinate_lat = _mm256_set1_pd(lat);
+    const __m128i fixed_lon = _mm_set1_epi32(lon);
+    const __m128i fixed_lat = _mm_set1_epi32(lat);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m256d source_lon = loadAVX2(u_lon + i);
+        const __m256d source_lat = loadAVX2(u_lat + i);
+        const __m256d slope_lon = _mm256_sub_pd(loadAVX2(v_lon + i), source_lon);
+        const __m256d slope_lat = _mm256_sub_pd(loadAVX2(v_lat + i), source_lat);
+        const __m256d relative_lon = _mm256_sub_pd(coordinate_lon, source_lon);
+        const __m256d relative_lat = _mm256_sub_pd(coordinate_lat, source_lat);
+
+        const __m256d unnormed_ratio = _mm256_add_pd(_mm256_mul_pd(slope_lon, relative_lon),
+                                                     _mm256_mul_pd(slope_lat, relative_lat));
+        const __m256d squared_length = _mm256_add_pd(_mm256_mul_pd(slope_lon, slope_lon),
+                                                     _mm256_mul_pd(slope_lat, slope_lat));
+        // zero length segments have the ratio 0
+        const __m256d has_length = _mm256_cmp_pd(squared_length, zero, _CMP_GT_OQ);
+        const __m256d ratio = _mm256_and_pd(
+            _mm256_min_pd(_mm256_max_pd(_mm256_div_pd(unnormed_ratio, squared_length), zero),
+                          one),
+            has_length);
+
+        const __m128i closest_lon =
+            _mm256_cvttpd_epi32(_mm256_add_pd(source_lon, _mm256_mul_pd(ratio, slope_lon)));
+        const __m128i closest_lat =
+            _mm256_cvttpd_epi32(_mm256_add_pd(source_lat, _mm256_mul_pd(ratio, slope_lat)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(nearest_lon + i), closest_lon);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(nearest_lat + i), closest_lat);
+
+        const __m256i distance =
+            _mm256_add_epi64(squareAVX2(_mm_sub_epi32(fixed_lon, closest_lon)),
+                             squareAVX2(_mm_sub_epi32(fixed_lat, closest_lat)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(squared_distances + i), distance);
+    }
+
+    segmentDistancesSSE41(u_lon + i,
+                          u_lat + i,
+                          v_lon + i,
+                          v_lat + i,
+                          count - i,
+                          lon,
+                          lat,
+                          squared_distances + i,
+                          nearest_lon + i,
+                          nearest_lat + i);
+}
+
+__attribute__((target("avx2"))) void rectangleDistancesAVX2(const std::int32_t *min_lon,
+                                                            const std::int32_t *max_lon,
+                                                            const std::int32_t *min_lat,
+                                                            const std::int32_t *max_lat,
+                                                            const std::size_t count,
+                                                            const std::int32_t lon,
+                                                            const std::int32_t lat,
+                                                            std::uint64_t *squared_distances)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i coordinate_lon = _mm256_set1_epi32(lon);
+    const __m256i coordinate_lat = _mm256_set1_epi32(lat);
+
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256i lower_lon =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(min_lon + i));
+        const __m256i upper_lon =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(max_lon + i));
+        const __m256i lower_lat =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(min_lat + i));
+        const __m256i upper_lat =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(max_lat + i));
+        const __m256i delta_lon =
+            _mm256_max_epi32(_mm256_max_epi32(_mm256_sub_epi32(lower_lon, coordinate_lon), zero),
+                             _mm256_sub_epi32(coordinate_lon, upper_lon));
+        const __m256i delta_lat =
+            _mm256_max_epi32(_mm256_max_epi32(_mm256_sub_epi32(lower_lat, coordinate_lat), zero),
+                             _mm256_sub_epi32(coordinate_lat, upper_lat));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(squared_distances + i),
+                            _mm256_add_epi64(squareAVX2(_mm256_castsi256_si128(delta_lon)),
+                                             squareAVX2(_mm256_castsi256_si128(delta_lat))));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(squared_distances + i + 4),
+                            _mm256_add_epi64(squareAVX2(_mm256_extracti128_si256(delta_lon, 1)),
+                                             squareAVX2(_mm256_extracti128_si256(delta_lat, 1))));
+    }
+
+    rectangleDistancesSSE41(min_lon + i,
+                            max_lon + i,
+                            min_lat + i,
+                            max_lat + i,
+                            count - i,
+                            lon,
+                            lat,
+                            squared_distances + i);
+}
+
+#endif
+
+InstructionSet detectInstructionSet()
+{
+#ifdef OSRM_RTREE_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return InstructionSet::AVX2;
+    if (__builtin_cpu_supports("sse4.1"))
+        return InstructionSet::SSE41;
+#endif
+    return InstructionSet::Scalar;
+}
+
+struct Kernels
+{
+    InstructionSet instruction_set;
+    SegmentKernel segment_distances;
+    RectangleKernel rectangle_distances;
+};
+
+const Kernels &getKernels(const InstructionSet instruction_set)
+{
+#ifdef OSRM_RTREE_KERNELS_X86
+    static const Kernels avx2_kernels{
+        InstructionSet::AVX2, segmentDistancesAVX2, rectangleDistancesAVX2};
+    static const Kernels sse41_kernels{
+        InstructionSet::SSE41, segmentDistancesSSE41, rectangleDistancesSSE41};
+    switch (instruction_set)
+    {
+    case InstructionSet::AVX2:
+        return avx2_kernels;
+    case InstructionSet::SSE41:
+        return sse41_kernels;
+    default:
+        break;
+    }
+#else
+    (void)instruction_set;
+#endif
+    static const Kernels scalar_kernels{
+        InstructionSet::Scalar, segmentDistancesScalar, rectangleDistancesScalar};
+    return scalar_kernels;
+}
+
+std::atomic<const Kernels *> &currentKernels()
+{
+    static std::atomic<const Kernels *> kernels{&getKernels(detectInstructionSet())};
+    return kernels;
+}
+}
+
+InstructionSet getInstructionSet() { return currentKernels().load()->instruction_set; }
+
+InstructionSet getSupportedInstructionSet()
+{
+    static const InstructionSet supported = detectInstructionSet();
+    return supported;
+}
+
+InstructionSet setInstructionSet(const InstructionSet instruction_set)
+{
+    const auto used_instruction_set = std::min(instruction_set, getSupportedInstructionSet());
+    currentKernels().store(&getKernels(used_instruction_set));
+    return used_instruction_set;
+}
+
+const char *toString(const InstructionSet instruction_set)
+{
+    switch (instruction_set)
+    {
+    case InstructionSet::AVX2:
+        return "AVX2";
+    case InstructionSet::SSE41:
+        return "SSE4.1";
+    default:
+        return "scalar";
+    }
+}
+
+void segmentDistances(const std::int32_t *u_lon,
+                      const std::int32_t *u_lat,
+                      const std::int32_t *v_lon,
+                      const std::int32_t *v_lat,
+                      const std::size_t count,
+                      const Coordinate coordinate,
+                      std::uint64_t *squared_distances,
+                      std::int32_t *nearest_lon,
+                      std::int32_t *nearest_lat)
+{
+    currentKernels().load(std::memory_order_relaxed)
+        ->segment_distances(u_lon,
+                            u_lat,
+                            v_lon,
+                            v_lat,
+                            count,
+                            static_cast<std::int32_t>(coordinate.lon),
+                            static_cast<std::int32_t>(coordinate.lat),
+                            squared_distances,
+                            nearest_lon,
+                            nearest_lat);
+}
+
+void rectangleDistances(const std::int32_t *min_lon,
+                        const std::int32_t *max_lon,
+                        const std::int32_t *min_lat,
+                        const std::int32_t *max_lat,
+                        const std::size_t count,
+                        const Coordinate coordinate,
+                        std::uint64_t *squared_distances)
+{
+    currentKernels().load(std::memory_order_relaxed)
+        ->rectangle_distances(min_lon,
+                              max_lon,
+                              min_lat,
+                              max_lat,
+                              count,
+                              static_cast<std::int32_t>(coordinate.lon),
+                              static_cast<std::int32_t>(coordinate.lat),
+                              squared_distances);
+}
+}
+}
+}
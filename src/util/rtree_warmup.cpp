@@ -0,0 +1,218 @@
+#include "util/rtree_warmup.hpp"
+#include "util/simple_logger.hpp"
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace osrm
+{
+namespace util
+{
+
+bool parseRTreeWarmup(const std::string &name, RTreeWarmup &warmup)
+{
+    for (const auto candidate :
+         {RTreeWarmup::None, RTreeWarmup::Advise, RTreeWarmup::Populate, RTreeWarmup::HotPages})
+    {
+        if (name == toString(candidate))
+        {
+            warmup = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char *toString(const RTreeWarmup warmup)
+{
+    switch (warmup)
+    {
+    case RTreeWarmup::Advise:
+        return "advise";
+    case RTreeWarmup::Populate:
+        return "populate";
+    case RTreeWarmup::HotPages:
+        return "hot-pages";
+    case RTreeWarmup::None:
+    default:
+        return "none";
+    }
+}
+
+namespace rtree_warmup
+{
+namespace
+{
+
+std::size_t getPageSize()
+{
+#ifndef _WIN32
+    return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#else
+    return 4096;
+#endif
+}
+
+void adviseWillNeed(const char *data, const std::size_t size)
+{
+#ifdef __linux__
+    // the mapping starts at a page boundary
+    if (-1 == madvise(const_cast<char *>(data), size, MADV_WILLNEED))
+    {
+        SimpleLogger().Write(logWARNING) << "Could not advise the kernel to read the R-tree leaves";
+    }
+#else
+    (void)data;
+    (void)size;
+#endif
+}
+
+// reads one byte of the page, which faults it in if it is not resident
+void touchPage(const char *page) { (void)*reinterpret_cast<const volatile char *>(page); }
+
+// Format of the hot pages file: number of pages followed by their offsets in bytes, in ascending
+// order. Offsets instead of page numbers keep the file valid for a different page size.
+std::vector<std::uint64_t> readHotPages(const boost::filesystem::path &hot_pages_path)
+{
+    std::vector<std::uint64_t> offsets;
+    boost::filesystem::ifstream hot_pages_file(hot_pages_path, std::ios::binary);
+    if (!hot_pages_file)
+    {
+        SimpleLogger().Write(logWARNING) << "No hot R-tree pages saved in "
+                                         << hot_pages_path.string() << " yet";
+        return offsets;
+    }
+
+    // the count is only trusted as far as the file can hold that many offsets
+    boost::system::error_code error;
+    const auto file_size = boost::filesystem::file_size(hot_pages_path, error);
+    std::uint64_t number_of_pages = 0;
+    hot_pages_file.read(reinterpret_cast<char *>(&number_of_pages), sizeof(number_of_pages));
+    if (error || !hot_pages_file ||
+        number_of_pages != (file_size - sizeof(number_of_pages)) / sizeof(std::uint64_t))
+    {
+        SimpleLogger().Write(logWARNING) << "Ignoring the invalid hot R-tree pages file "
+                                         << hot_pages_path.string();
+        return offsets;
+    }
+
+    offsets.resize(number_of_pages);
+    hot_pages_file.read(reinterpret_cast<char *>(offsets.data()),
+                        number_of_pages * sizeof(std::uint64_t));
+    if (!hot_pages_file)
+    {
+        SimpleLogger().Write(logWARNING) << "Could not read the hot R-tree pages file "
+                                         << hot_pages_path.string();
+        offsets.clear();
+    }
+    return offsets;
+}
+}
+
+std::size_t warmUp(const char *data,
+                   const std::size_t size,
+                   const RTreeWarmup warmup,
+                   const boost::filesystem::path &hot_pages_path)
+{
+    const auto page_size = getPageSize();
+    std::size_t number_of_pages = 0;
+
+    switch (warmup)
+    {
+    case RTreeWarmup::None:
+        break;
+    case RTreeWarmup::Advise:
+        adviseWillNeed(data, size);
+        break;
+    case RTreeWarmup::Populate:
+        // read ahead in large requests instead of faulting in single pages
+        adviseWillNeed(data, size);
+        for (std::size_t offset = 0; offset < size; offset += page_size)
+        {
+            touchPage(data + offset);
+            ++number_of_pages;
+        }
+        break;
+    case RTreeWarmup::HotPages:
+        // the pages were saved for the dataset that was loaded before, which may be smaller
+        for (const auto offset : readHotPages(hot_pages_path))
+        {
+            if (offset < size)
+            {
+                touchPage(data + offset);
+                ++number_of_pages;
+            }
+        }
+        break;
+    }
+
+    return number_of_pages;
+}
+
+std::size_t saveHotPages(const char *data,
+                         const std::size_t size,
+                         const boost::filesystem::path &hot_pages_path)
+{
+#ifdef __linux__
+    const auto page_size = getPageSize();
+    std::vector<unsigned char> residency((size + page_size - 1) / page_size);
+    if (-1 == mincore(const_cast<char *>(data), size, residency.data()))
+    {
+        SimpleLogger().Write(logWARNING) << "Could not determine the resident R-tree pages";
+        return 0;
+    }
+
+    std::vector<std::uint64_t> offsets;
+    for (std::size_t page = 0; page < residency.size(); ++page)
+    {
+        if (residency[page] & 1)
+        {
+            offsets.push_back(page * page_size);
+        }
+    }
+
+    // replace the file at once, a new dataset might read it concurrently
+    auto temporary_path = hot_pages_path;
+    temporary_path += ".tmp";
+    {
+        boost::filesystem::ofstream hot_pages_file(temporary_path, std::ios::binary);
+        const std::uint64_t number_of_pages = offsets.size();
+        hot_pages_file.write(reinterpret_cast<const char *>(&number_of_pages),
+                             sizeof(number_of_pages));
+        hot_pages_file.write(reinterpret_cast<const char *>(offsets.data()),
+                             number_of_pages * sizeof(std::uint64_t));
+        if (!hot_pages_file)
+        {
+            SimpleLogger().Write(logWARNING) << "Could not write the hot R-tree pages to "
+                                             << temporary_path.string();
+            return 0;
+        }
+    }
+
+    boost::system::error_code error;
+    boost::filesystem::rename(temporary_path, hot_pages_path, error);
+    if (error)
+    {
+        SimpleLogger().Write(logWARNING) << "Could not save the hot R-tree pages to "
+                                         << hot_pages_path.string() << ": " << error.message();
+        return 0;
+    }
+    return offsets.size();
+#else
+    (void)data;
+    (void)size;
+    (void)hot_pages_path;
+    return 0;
+#endif
+}
+}
+}
+}
@@ -0,0 +1,396 @@
+#include "contractor/graph_customizer.hpp"
+#include "contractor/graph_contractor.hpp"
+#include "contractor/query_edge.hpp"
+#include "extractor/edge_based_edge.hpp"
+#include "util/deallocating_vector.hpp"
+#include "util/integer_range.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(graph_customizer)
+
+using namespace osrm;
+using namespace osrm::contractor;
+using EdgeBasedEdges = util::DeallocatingVector<extractor::EdgeBasedEdge>;
+using QueryEdges = util::DeallocatingVector<QueryEdge>;
+
+namespace
+{
+
+struct Hierarchy
+{
+    QueryEdges edges;
+    std::vector<float> node_levels;
+    std::vector<bool> is_core_node;
+};
+
+// Copies of a DeallocatingVector share their memory, so the edges are passed as temporaries
+void contract(const NodeID number_of_nodes,
+              EdgeBasedEdges &&edges,
+              std::vector<EdgeWeight> node_weights,
+              Hierarchy &hierarchy)
+{
+    GraphContractor graph_contractor(number_of_nodes, edges, {}, std::move(node_weights));
+    graph_contractor.Run();
+    graph_contractor.GetEdges(hierarchy.edges);
+    graph_contractor.GetCoreMarker(hierarchy.is_core_node);
+    graph_contractor.GetNodeLevels(hierarchy.node_levels);
+    // like the edges of a .hsgr file
+    std::sort(hierarchy.edges.begin(), hierarchy.edges.end());
+}
+
+// Returns whether the hierarchy could be customized
+bool customize(const NodeID number_of_nodes,
+               Hierarchy &hierarchy,
+               const EdgeBasedEdges &edges,
+               std::vector<EdgeWeight> node_weights)
+{
+    GraphCustomizer customizer(number_of_nodes,
+                               hierarchy.edges,
+                               hierarchy.node_levels,
+                               hierarchy.is_core_node,
+                               std::move(node_weights));
+    if (!customizer.Run(edges, {}))
+        return false;
+
+    QueryEdges customized_edges;
+    customizer.GetEdges(customized_edges);
+    std::sort(customized_edges.begin(), customized_edges.end());
+    hierarchy.edges.swap(customized_edges);
+    return true;
+}
+
+// Weights of the shortest paths between all pairs of different nodes, INVALID_EDGE_WEIGHT if
+// there is none. Runs Dijkstra searches over the given arcs, all nodes are settled.
+template <typename ArcsT>
+std::vector<EdgeWeight> dijkstra(const NodeID number_of_nodes, const NodeID source, ArcsT &&arcs)
+{
+    std::vector<EdgeWeight> weights(number_of_nodes, INVALID_EDGE_WEIGHT);
+    using Entry = std::pair<EdgeWeight, NodeID>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    weights[source] = 0;
+    queue.emplace(0, source);
+    while (!queue.empty())
+    {
+        const auto entry = queue.top();
+        queue.pop();
+        if (entry.first > weights[entry.second])
+            continue;
+        arcs(entry.second, [&](const NodeID target, const EdgeWeight weight) {
+            if (entry.first + weight < weights[target])
+            {
+                weights[target] = entry.first + weight;
+                queue.emplace(weights[target], target);
+            }
+        });
+    }
+    return weights;
+}
+
+std::vector<EdgeWeight> graphDistances(const NodeID number_of_nodes, const EdgeBasedEdges &edges)
+{
+    std::vector<EdgeWeight> distances;
+    for (const auto source : util::irange<NodeID>(0, number_of_nodes))
+    {
+        const auto weights =
+            dijkstra(number_of_nodes, source, [&](const NodeID node, const auto &relax) {
+                for (const auto &edge : edges)
+                {
+                    if (edge.forward && edge.source == node)
+                        relax(edge.target, std::max(edge.weight, 1));
+                    if (edge.backward && edge.target == node)
+                        relax(edge.source, std::max(edge.weight, 1));
+                }
+            });
+        distances.insert(distances.end(), weights.begin(), weights.end());
+    }
+    return distances;
+}
+
+// Queries the hierarchy with complete upward searches from both ends
+std::vector<EdgeWeight> hierarchyDistances(const NodeID number_of_nodes, const QueryEdges &edges)
+{
+    const auto upward_search = [&](const NodeID start, const bool forward) {
+        return dijkstra(number_of_nodes, start, [&](const NodeID node, const auto &relax) {
+            for (const auto &edge : edges)
+            {
+                if (edge.source == node && (forward ? edge.data.forward : edge.data.backward))
+                    relax(edge.target, edge.data.weight);
+            }
+        });
+    };
+
+    std::vector<EdgeWeight> distances;
+    for (const auto source : util::irange<NodeID>(0, number_of_nodes))
+    {
+        const auto forward_weights = upward_search(source, true);
+        for (const auto target : util::irange<NodeID>(0, number_of_nodes))
+        {
+            if (source == target)
+            {
+                distances.push_back(0);
+                continue;
+            }
+            const auto reverse_weights = upward_search(target, false);
+            EdgeWeight distance = INVALID_EDGE_WEIGHT;
+            for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+            {
+                if (forward_weights[node] != INVALID_EDGE_WEIGHT &&
+                    reverse_weights[node] != INVALID_EDGE_WEIGHT)
+                {
+                    distance = std::min(distance, forward_weights[node] + reverse_weights[node]);
+                }
+            }
+            distances.push_back(distance);
+        }
+    }
+    return distances;
+}
+
+// A grid of one-way and two-way edges
+const constexpr NodeID GRID_SIZE = 6;
+const constexpr NodeID GRID_NODES = GRID_SIZE * GRID_SIZE;
+
+EdgeBasedEdges makeGrid(const std::function<EdgeWeight(NodeID)> &weight_of_edge)
+{
+    EdgeBasedEdges edges;
+    NodeID edge_id = 0;
+    for (const auto row : util::irange<NodeID>(0, GRID_SIZE))
+    {
+        for (const auto column : util::irange<NodeID>(0, GRID_SIZE))
+        {
+            const NodeID node = row * GRID_SIZE + column;
+            if (column + 1 < GRID_SIZE)
+            {
+                edges.push_back(extractor::EdgeBasedEdge(
+                    node, node + 1, edge_id, weight_of_edge(edge_id), true, edge_id % 5 != 0));
+                ++edge_id;
+            }
+            if (row + 1 < GRID_SIZE)
+            {
+                edges.push_back(extractor::EdgeBasedEdge(
+                    node, node + GRID_SIZE, edge_id, weight_of_edge(edge_id), true, true));
+                ++edge_id;
+            }
+        }
+    }
+    return edges;
+}
+
+std::vector<EdgeWeight>
+randomWeights(const unsigned seed, const EdgeWeight min, const EdgeWeight max)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<EdgeWeight> distribution(min, max);
+    std::vector<EdgeWeight> weights(2 * GRID_NODES);
+    for (auto &weight : weights)
+        weight = distribution(generator);
+    return weights;
+}
+
+// Customizes a hierarchy of the grid with old_weights to new_weights and compares the distances
+// to the ones of a hierarchy contracted with new_weights. Returns whether it could be customized.
+bool customizeGrid(const std::vector<EdgeWeight> &old_weights,
+                   const std::vector<EdgeWeight> &new_weights)
+{
+    const std::vector<EdgeWeight> node_weights(GRID_NODES, 0);
+    Hierarchy hierarchy;
+    contract(GRID_NODES,
+             makeGrid([&](const NodeID id) { return old_weights[id]; }),
+             node_weights,
+             hierarchy);
+
+    const auto make_new_edges = [&] {
+        return makeGrid([&](const NodeID id) { return new_weights[id]; });
+    };
+    const auto new_edges = make_new_edges();
+    if (!customize(GRID_NODES, hierarchy, new_edges, node_weights))
+        return false;
+
+    Hierarchy contracted;
+    contract(GRID_NODES, make_new_edges(), node_weights, contracted);
+    const auto expected = graphDistances(GRID_NODES, new_edges);
+    const auto contracted_distances = hierarchyDistances(GRID_NODES, contracted.edges);
+    const auto customized_distances = hierarchyDistances(GRID_NODES, hierarchy.edges);
+    BOOST_CHECK_EQUAL_COLLECTIONS(contracted_distances.begin(),
+                                  contracted_distances.end(),
+                                  expected.begin(),
+                                  expected.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(customized_distances.begin(),
+                                  customized_distances.end(),
+                                  contracted_distances.begin(),
+                                  contracted_distances.end());
+    return true;
+}
+}
+
+BOOST_AUTO_TEST_CASE(weight_increase)
+{
+    const auto old_weights = randomWeights(42, 10, 100);
+
+    // the same shortest paths, every witness stays a witness
+    auto new_weights = old_weights;
+    for (auto &weight : new_weights)
+        weight *= 3;
+    BOOST_CHECK(customizeGrid(old_weights, new_weights));
+
+    // single edges get longer, if the hierarchy still fits it has to give the right distances
+    for (const auto edge_id : util::irange<NodeID>(0, 20))
+    {
+        new_weights = old_weights;
+        new_weights[edge_id * 3] += 50;
+        customizeGrid(old_weights, new_weights);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(weight_decrease)
+{
+    const auto old_weights = randomWeights(7, 10, 100);
+
+    auto new_weights = old_weights;
+    for (auto &weight : new_weights)
+        weight /= 2;
+    auto scaled_old_weights = new_weights;
+    for (auto &weight : scaled_old_weights)
+        weight *= 2;
+    BOOST_CHECK(customizeGrid(scaled_old_weights, new_weights));
+
+    for (const auto edge_id : util::irange<NodeID>(0, 20))
+    {
+        new_weights = old_weights;
+        new_weights[edge_id * 3] = 10;
+        customizeGrid(old_weights, new_weights);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(missing_shortcut_forces_fallback)
+{
+    // The contractor always connects the last nodes of a cycle, so the hierarchy of a square
+    // 0-1-3-2 is given explicitly: the path 1-3-2 is a witness for 1-0-2 and there is no record
+    // between 1 and 2.
+    const auto make_square = [](const EdgeWeight witness_weight) {
+        EdgeBasedEdges edges;
+        edges.push_back(extractor::EdgeBasedEdge(0, 1, 0, 10, true, true));
+        edges.push_back(extractor::EdgeBasedEdge(0, 2, 1, 10, true, true));
+        edges.push_back(extractor::EdgeBasedEdge(1, 3, 2, witness_weight, true, true));
+        edges.push_back(extractor::EdgeBasedEdge(2, 3, 3, witness_weight, true, true));
+        return edges;
+    };
+    const auto make_hierarchy = [](Hierarchy &hierarchy) {
+        const auto add_record = [&](const NodeID source, const NodeID target, const NodeID id) {
+            QueryEdge::EdgeData data;
+            data.id = id;
+            data.weight = 10;
+            data.forward = true;
+            data.backward = true;
+            hierarchy.edges.push_back(QueryEdge(source, target, data));
+        };
+        add_record(0, 1, 0);
+        add_record(0, 2, 1);
+        add_record(1, 3, 2);
+        add_record(2, 3, 3);
+        hierarchy.node_levels = {0, 1, 2, 3};
+        hierarchy.is_core_node.assign(4, false);
+    };
+    const std::vector<EdgeWeight> node_weights(4, 0);
+
+    Hierarchy hierarchy;
+    make_hierarchy(hierarchy);
+    // a shorter witness is still a witness
+    BOOST_CHECK(customize(4, hierarchy, make_square(5), node_weights));
+
+    Hierarchy outdated_hierarchy;
+    make_hierarchy(outdated_hierarchy);
+    // the path via 0 is shorter now
+    BOOST_CHECK(!customize(4, outdated_hierarchy, make_square(15), node_weights));
+}
+
+BOOST_AUTO_TEST_CASE(tied_levels)
+{
+    // With cached priorities neighbours can share a level. Node 1 is contracted before 0 and 2,
+    // so the record between 0 and 2 is a shortcut via 1 and has to be recomputed after the
+    // records of 1 although 0 and 1 have the same level.
+    const auto make_edges = [](const EdgeWeight weight) {
+        EdgeBasedEdges edges;
+        edges.push_back(extractor::EdgeBasedEdge(1, 0, 0, weight, true, true));
+        edges.push_back(extractor::EdgeBasedEdge(1, 2, 1, 10, true, true));
+        edges.push_back(extractor::EdgeBasedEdge(0, 2, 2, 100, true, true));
+        return edges;
+    };
+    const auto make_hierarchy = [](Hierarchy &hierarchy) {
+        const auto add_record = [&](const NodeID source,
+                                    const NodeID target,
+                                    const EdgeWeight weight,
+                                    const NodeID id,
+                                    const bool shortcut) {
+            QueryEdge::EdgeData data;
+            data.id = id;
+            data.weight = weight;
+            data.shortcut = shortcut;
+            data.forward = true;
+            data.backward = true;
+            hierarchy.edges.push_back(QueryEdge(source, target, data));
+        };
+        add_record(0, 2, 20, 1, true);
+        add_record(1, 0, 10, 0, false);
+        add_record(1, 2, 10, 1, false);
+        hierarchy.node_levels = {0, 0, 1};
+        hierarchy.is_core_node.assign(3, false);
+    };
+    const std::vector<EdgeWeight> node_weights(3, 0);
+
+    for (const EdgeWeight weight : {5, 50})
+    {
+        Hierarchy hierarchy;
+        make_hierarchy(hierarchy);
+        const auto edges = make_edges(weight);
+        BOOST_CHECK(customize(3, hierarchy, edges, node_weights));
+
+        const auto expected = graphDistances(3, edges);
+        const auto customized_distances = hierarchyDistances(3, hierarchy.edges);
+        BOOST_CHECK_EQUAL_COLLECTIONS(customized_distances.begin(),
+                                      customized_distances.end(),
+                                      expected.begin(),
+                                      expected.end());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(missing_self_loop_forces_fallback)
+{
+    // going from 0 to 1 and back is shorter than the node weight for weights below 25, so the
+    // contractor adds a self-loop at the one of both contracted last
+    const auto make_edges = [](const EdgeWeight weight) {
+        EdgeBasedEdges edges;
+        edges.push_back(extractor::EdgeBasedEdge(0, 1, 0, weight, true, true));
+        edges.push_back(extractor::EdgeBasedEdge(0, 2, 1, 100, true, true));
+        edges.push_back(extractor::EdgeBasedEdge(1, 3, 2, 100, true, true));
+        return edges;
+    };
+    const auto has_loop = [](const Hierarchy &hierarchy) {
+        return std::any_of(hierarchy.edges.begin(),
+                           hierarchy.edges.end(),
+                           [](const QueryEdge &edge) { return edge.source == edge.target; });
+    };
+    const std::vector<EdgeWeight> node_weights(4, 50);
+
+    Hierarchy without_loop;
+    contract(4, make_edges(30), node_weights, without_loop);
+    BOOST_CHECK(!has_loop(without_loop));
+    BOOST_CHECK(customize(4, without_loop, make_edges(28), node_weights));
+    BOOST_CHECK(!customize(4, without_loop, make_edges(20), node_weights));
+
+    Hierarchy with_loop;
+    contract(4, make_edges(20), node_weights, with_loop);
+    BOOST_CHECK(has_loop(with_loop));
+    BOOST_CHECK(customize(4, with_loop, make_edges(15), node_weights));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
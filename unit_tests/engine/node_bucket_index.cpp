@@ -0,0 +1,72 @@
+#include "engine/routing_algorithms/node_bucket_index.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(node_bucket_index)
+
+using namespace osrm;
+using namespace osrm::engine::routing_algorithms;
+
+struct TestBucket
+{
+    NodeID middle_node;
+    unsigned target_id;
+};
+
+BOOST_AUTO_TEST_CASE(empty_index)
+{
+    NodeBucketIndex index;
+    index.Build(std::vector<TestBucket>{});
+    BOOST_CHECK(index.Find(0) == NodeBucketIndex::BucketRange(0, 0));
+    BOOST_CHECK(index.Find(42) == NodeBucketIndex::BucketRange(0, 0));
+}
+
+BOOST_AUTO_TEST_CASE(finds_all_buckets_of_a_node)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<NodeID> node_distribution(0, 10000);
+
+    std::vector<TestBucket> buckets;
+    for (unsigned target_id = 0; target_id < 1000; ++target_id)
+    {
+        buckets.push_back(TestBucket{node_distribution(generator), target_id});
+    }
+    // consecutive ids hash to nearby slots without a good mix
+    for (NodeID node = 20000; node < 20100; ++node)
+    {
+        buckets.push_back(TestBucket{node, 0});
+    }
+    std::stable_sort(buckets.begin(), buckets.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.middle_node < rhs.middle_node;
+    });
+
+    NodeBucketIndex index;
+    index.Build(buckets);
+
+    for (NodeID node = 0; node < 20200; ++node)
+    {
+        const auto expected =
+            std::equal_range(buckets.begin(),
+                             buckets.end(),
+                             TestBucket{node, 0},
+                             [](const auto &lhs, const auto &rhs) {
+                                 return lhs.middle_node < rhs.middle_node;
+                             });
+        const auto range = index.Find(node);
+        if (expected.first == expected.second)
+        {
+            BOOST_CHECK_EQUAL(range.first, range.second);
+        }
+        else
+        {
+            BOOST_CHECK_EQUAL(range.first, expected.first - buckets.begin());
+            BOOST_CHECK_EQUAL(range.second, expected.second - buckets.begin());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,39 @@
+#include "engine/search_engine_data.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(search_engine_data)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+BOOST_AUTO_TEST_CASE(reuses_heaps_of_both_storage_kinds)
+{
+    const unsigned number_of_nodes = 100;
+    SearchEngineData dense_data(number_of_nodes);
+    SearchEngineData sparse_data(number_of_nodes - 1);
+
+    dense_data.InitializeOrClearFirstThreadLocalStorage(number_of_nodes);
+    const auto *const dense_heap = SearchEngineData::forward_heap_1.get();
+    BOOST_CHECK(dense_heap->GetIndexStorage().IsDense());
+
+    sparse_data.InitializeOrClearFirstThreadLocalStorage(number_of_nodes);
+    const auto *const sparse_heap = SearchEngineData::forward_heap_1.get();
+    BOOST_CHECK(!sparse_heap->GetIndexStorage().IsDense());
+
+    // alternating instances with different limits swap the heaps instead of reallocating them
+    dense_data.InitializeOrClearFirstThreadLocalStorage(number_of_nodes);
+    BOOST_CHECK_EQUAL(SearchEngineData::forward_heap_1.get(), dense_heap);
+    sparse_data.InitializeOrClearFirstThreadLocalStorage(number_of_nodes);
+    BOOST_CHECK_EQUAL(SearchEngineData::forward_heap_1.get(), sparse_heap);
+
+    // a heap for another graph size replaces the one of the same kind
+    dense_data.InitializeOrClearFirstThreadLocalStorage(number_of_nodes / 2);
+    BOOST_CHECK(SearchEngineData::forward_heap_1->GetIndexStorage().IsDense());
+    BOOST_CHECK(SearchEngineData::forward_heap_1->GetIndexStorage().Fits(number_of_nodes / 2,
+                                                                         number_of_nodes));
+    sparse_data.InitializeOrClearFirstThreadLocalStorage(number_of_nodes);
+    BOOST_CHECK_EQUAL(SearchEngineData::forward_heap_1.get(), sparse_heap);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -68,4 +68,42 @@ BOOST_AUTO_TEST_CASE(test_match)
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_match_batch)
+{
+    const auto args = get_args();
+    BOOST_REQUIRE_EQUAL(args.size(), 1);
+
+    using namespace osrm;
+
+    auto osrm = getOSRM(args[0]);
+
+    MatchParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+
+    MatchParameters invalid_params;
+    invalid_params.coordinates.push_back(get_dummy_location());
+    invalid_params.coordinates.push_back(get_dummy_location());
+    invalid_params.timestamps = {2, 1};
+
+    const std::vector<MatchParameters> batch = {params, invalid_params, params};
+    std::vector<json::Object> results;
+
+    const auto rc = osrm.Match(batch, results);
+
+    BOOST_CHECK(rc == Status::Error);
+    BOOST_REQUIRE_EQUAL(results.size(), batch.size());
+
+    // results are in the order of the parameters
+    BOOST_CHECK_EQUAL(results[0].values.at("code").get<json::String>().value, "Ok");
+    BOOST_CHECK_EQUAL(results[1].values.at("code").get<json::String>().value, "InvalidValue");
+    BOOST_CHECK_EQUAL(results[2].values.at("code").get<json::String>().value, "Ok");
+
+    json::Object single_result;
+    osrm.Match(params, single_result);
+    BOOST_CHECK_EQUAL(results[0].values.at("tracepoints").get<json::Array>().values.size(),
+                      single_result.values.at("tracepoints").get<json::Array>().values.size());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
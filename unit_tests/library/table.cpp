@@ -14,6 +14,11 @@
 #include "osrm/osrm.hpp"
 #include "osrm/status.hpp"
 
+#include "util/json_writer.hpp"
+
+#include <string>
+#include <vector>
+
 BOOST_AUTO_TEST_SUITE(table)
 
 BOOST_AUTO_TEST_CASE(test_table_three_coords_one_source_one_dest_matrix)
@@ -161,4 +166,86 @@ BOOST_AUTO_TEST_CASE(test_table_three_coordinates_matrix)
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_table_parallel_matches_sequential)
+{
+    const auto args = get_args();
+    BOOST_REQUIRE_EQUAL(args.size(), 1);
+
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {args[0]};
+    config.use_shared_memory = false;
+
+    OSRM sequential_osrm{config};
+    config.max_parallelism_distance_table = -1;
+    OSRM parallel_osrm{config};
+
+    // enough locations to split the searches into several chunks
+    TableParameters params;
+    for (int i = 0; i < 64; ++i)
+    {
+        params.coordinates.push_back(
+            {Longitude{7.415800 + 0.0003 * (i % 8)}, Latitude{43.734132 + 0.0003 * (i / 8)}});
+    }
+
+    json::Object sequential_result;
+    json::Object parallel_result;
+    BOOST_CHECK(sequential_osrm.Table(params, sequential_result) == Status::Ok);
+    BOOST_CHECK(parallel_osrm.Table(params, parallel_result) == Status::Ok);
+
+    const auto &sequential_durations =
+        sequential_result.values.at("durations").get<json::Array>().values;
+    const auto &parallel_durations =
+        parallel_result.values.at("durations").get<json::Array>().values;
+    BOOST_REQUIRE_EQUAL(sequential_durations.size(), params.coordinates.size());
+    BOOST_REQUIRE_EQUAL(parallel_durations.size(), params.coordinates.size());
+    for (std::size_t row = 0; row < sequential_durations.size(); ++row)
+    {
+        const auto &sequential_row = sequential_durations[row].get<json::Array>().values;
+        const auto &parallel_row = parallel_durations[row].get<json::Array>().values;
+        BOOST_REQUIRE_EQUAL(sequential_row.size(), parallel_row.size());
+        for (std::size_t column = 0; column < sequential_row.size(); ++column)
+        {
+            BOOST_CHECK_EQUAL(sequential_row[column].get<json::Number>().value,
+                              parallel_row[column].get<json::Number>().value);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_table_streaming_matches_object)
+{
+    const auto args = get_args();
+    BOOST_REQUIRE_EQUAL(args.size(), 1);
+
+    using namespace osrm;
+
+    auto osrm = getOSRM(args[0]);
+
+    TableParameters params;
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+    params.coordinates.push_back(get_dummy_location());
+    params.sources.push_back(0);
+
+    json::Object result;
+    BOOST_CHECK(osrm.Table(params, result) == Status::Ok);
+
+    std::vector<char> streamed;
+    json::Writer writer(streamed);
+    BOOST_CHECK(osrm.Table(params, writer) == Status::Ok);
+    const std::string streamed_string(streamed.begin(), streamed.end());
+
+    // key order differs between both, so compare the members one by one
+    for (const auto &key : {"code", "sources", "destinations", "durations"})
+    {
+        std::vector<char> member;
+        json::Writer member_writer(member);
+        member_writer.Value(result.values.at(key));
+        const auto expected =
+            "\"" + std::string(key) + "\":" + std::string(member.begin(), member.end());
+        BOOST_CHECK(streamed_string.find(expected) != std::string::npos);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -20,14 +20,15 @@ namespace test
 class MockDataFacade final : public engine::datafacade::BaseDataFacade
 {
   private:
-    EdgeData foo;
+    SearchData foo;
 
   public:
     unsigned GetNumberOfNodes() const override { return 0; }
     unsigned GetNumberOfEdges() const override { return 0; }
     unsigned GetOutDegree(const NodeID /* n */) const override { return 0; }
     NodeID GetTarget(const EdgeID /* e */) const override { return SPECIAL_NODEID; }
-    const EdgeData &GetEdgeData(const EdgeID /* e */) const override { return foo; }
+    const SearchData &GetSearchData(const EdgeID /* e */) const override { return foo; }
+    EdgeData GetEdgeData(const EdgeID /* e */) const override { return EdgeData(); }
     EdgeID BeginEdges(const NodeID /* n */) const override { return SPECIAL_EDGEID; }
     EdgeID EndEdges(const NodeID /* n */) const override { return SPECIAL_EDGEID; }
     osrm::engine::datafacade::EdgeRange GetAdjacentEdgeRange(const NodeID /* node */) const override
@@ -66,33 +67,31 @@ class MockDataFacade final : public engine::datafacade::BaseDataFacade
     {
         return GeometryID{SPECIAL_GEOMETRYID, false};
     }
-    std::vector<NodeID> GetUncompressedForwardGeometry(const EdgeID /* id */) const override
+    util::ArrayView<NodeID> GetUncompressedForwardGeometry(const EdgeID /* id */) const override
     {
         return {};
     }
-    std::vector<NodeID> GetUncompressedReverseGeometry(const EdgeID /* id */) const override
+    util::ArrayView<NodeID> GetUncompressedReverseGeometry(const EdgeID /* id */) const override
     {
         return {};
     }
-    std::vector<EdgeWeight> GetUncompressedForwardWeights(const EdgeID /* id */) const override
+    util::ArrayView<EdgeWeight> GetUncompressedForwardWeights(const EdgeID /* id */) const override
     {
-        std::vector<EdgeWeight> result_weights;
-        result_weights.resize(1);
-        result_weights[0] = 1;
-        return result_weights;
+        static const EdgeWeight weight = 1;
+        return util::ArrayView<EdgeWeight>::Repeat(weight, 1);
     }
-    std::vector<EdgeWeight> GetUncompressedReverseWeights(const EdgeID /* id */) const override
+    util::ArrayView<EdgeWeight> GetUncompressedReverseWeights(const EdgeID /* id */) const override
     {
-        std::vector<EdgeWeight> result_weights;
-        result_weights.resize(1);
-        result_weights[0] = 1;
-        return result_weights;
+        static const EdgeWeight weight = 1;
+        return util::ArrayView<EdgeWeight>::Repeat(weight, 1);
     }
-    std::vector<uint8_t> GetUncompressedForwardDatasources(const EdgeID /*id*/) const override
+    util::ArrayView<DatasourceID>
+    GetUncompressedForwardDatasources(const EdgeID /*id*/) const override
     {
         return {};
     }
-    std::vector<uint8_t> GetUncompressedReverseDatasources(const EdgeID /*id*/) const override
+    util::ArrayView<DatasourceID>
+    GetUncompressedReverseDatasources(const EdgeID /*id*/) const override
     {
         return {};
     }
@@ -196,6 +195,17 @@ class MockDataFacade final : public engine::datafacade::BaseDataFacade
         return {};
     }
 
+    std::vector<std::pair<engine::PhantomNode, engine::PhantomNode>>
+    NearestPhantomNodesWithAlternativeFromBigComponent(
+        const std::vector<util::Coordinate> &input_coordinates,
+        const std::vector<boost::optional<double>> & /*radiuses*/,
+        const std::vector<boost::optional<engine::Bearing>> & /*bearings*/,
+        const int /*max_parallelism*/) const override
+    {
+        return std::vector<std::pair<engine::PhantomNode, engine::PhantomNode>>(
+            input_coordinates.size());
+    }
+
     unsigned GetCheckSum() const override { return 0; }
     bool IsCoreNode(const NodeID /* id */) const override { return false; }
     unsigned GetNameIndexFromEdgeID(const unsigned /* id */) const override { return 0; }
@@ -75,6 +75,10 @@ BOOST_AUTO_TEST_CASE(invalid_table_urls)
         testInvalidOptions<TableParameters>("1,2;3,4?sources=1&destinations=1&bla=foo"), 32UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?sources=foo"), 16UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?destinations=foo"), 21UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?format=foo"), 15UL);
+    // only route and table can produce a binary response
+    BOOST_CHECK_EQUAL(testInvalidOptions<MatchParameters>("1,2;3,4?format=binary"), 8UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<NearestParameters>("1,2?format=binary"), 4UL);
 }
 
 BOOST_AUTO_TEST_CASE(valid_route_hint)
@@ -296,6 +300,12 @@ BOOST_AUTO_TEST_CASE(valid_route_urls)
     CHECK_EQUAL_RANGE(reference_10.radiuses, result_10->radiuses);
     CHECK_EQUAL_RANGE(reference_10.coordinates, result_10->coordinates);
     CHECK_EQUAL_RANGE(reference_10.hints, result_10->hints);
+
+    auto result_11 = parseParameters<RouteParameters>("1,2;3,4?format=binary&overview=full");
+    BOOST_CHECK(result_11);
+    BOOST_CHECK(result_10->format == RouteParameters::OutputFormatType::JSON);
+    BOOST_CHECK(result_11->format == RouteParameters::OutputFormatType::Binary);
+    BOOST_CHECK_EQUAL(result_11->overview, RouteParameters::OverviewType::Full);
 }
 
 BOOST_AUTO_TEST_CASE(valid_table_urls)
@@ -332,6 +342,13 @@ BOOST_AUTO_TEST_CASE(valid_table_urls)
     CHECK_EQUAL_RANGE(reference_1.bearings, result_3->bearings);
     CHECK_EQUAL_RANGE(reference_1.radiuses, result_3->radiuses);
     CHECK_EQUAL_RANGE(reference_1.coordinates, result_3->coordinates);
+
+    auto result_4 = parseParameters<TableParameters>("1,2;3,4?format=binary&sources=0");
+    BOOST_CHECK(result_4);
+    BOOST_CHECK(result_1->format == TableParameters::OutputFormatType::JSON);
+    BOOST_CHECK(result_4->format == TableParameters::OutputFormatType::Binary);
+    std::vector<std::size_t> sources_4 = {0};
+    CHECK_EQUAL_RANGE(sources_4, result_4->sources);
 }
 
 BOOST_AUTO_TEST_CASE(valid_match_urls)
@@ -0,0 +1,100 @@
+#include "server/request_parser.hpp"
+#include "server/http/request.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <tuple>
+
+BOOST_AUTO_TEST_SUITE(request_parser)
+
+using namespace osrm;
+using namespace osrm::server;
+
+using Status = RequestParser::RequestStatus;
+
+// parses a single request from the start of input, returns the number of consumed characters
+std::size_t parseRequest(RequestParser &parser,
+                         http::request &request,
+                         std::string &input,
+                         Status expected_status)
+{
+    Status status;
+    http::compression_type compression;
+    char *parsed_end;
+    std::tie(status, compression, parsed_end) =
+        parser.parse(request, &input[0], &input[0] + input.size());
+    BOOST_CHECK(status == expected_status);
+    return parsed_end - &input[0];
+}
+
+BOOST_AUTO_TEST_CASE(keep_alive_defaults)
+{
+    {
+        RequestParser parser;
+        http::request request;
+        std::string input = "GET /route HTTP/1.1\r\nHost: localhost\r\n\r\n";
+        parseRequest(parser, request, input, Status::valid);
+        BOOST_CHECK(request.keep_alive);
+        BOOST_CHECK_EQUAL(request.http_version_major, 1);
+        BOOST_CHECK_EQUAL(request.http_version_minor, 1);
+    }
+    {
+        RequestParser parser;
+        http::request request;
+        std::string input = "GET /route HTTP/1.0\r\n\r\n";
+        parseRequest(parser, request, input, Status::valid);
+        BOOST_CHECK(!request.keep_alive);
+        BOOST_CHECK_EQUAL(request.http_version_major, 1);
+        BOOST_CHECK_EQUAL(request.http_version_minor, 0);
+    }
+    {
+        RequestParser parser;
+        http::request request;
+        std::string input = "GET /route HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n";
+        parseRequest(parser, request, input, Status::valid);
+        BOOST_CHECK(request.keep_alive);
+    }
+    {
+        RequestParser parser;
+        http::request request;
+        std::string input = "GET /route HTTP/1.1\r\nConnection: close\r\n\r\n";
+        parseRequest(parser, request, input, Status::valid);
+        BOOST_CHECK(!request.keep_alive);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(pipelined_requests)
+{
+    const std::string first = "GET /first HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    const std::string second = "GET /second HTTP/1.1\r\nConnection: close\r\n\r\n";
+    std::string input = first + second;
+
+    RequestParser parser;
+    http::request request;
+    const auto consumed = parseRequest(parser, request, input, Status::valid);
+    BOOST_CHECK_EQUAL(consumed, first.size());
+    BOOST_CHECK_EQUAL(request.uri, "/first");
+    BOOST_CHECK(request.keep_alive);
+
+    parser.reset();
+    request = http::request();
+    std::string rest = input.substr(consumed);
+    BOOST_CHECK_EQUAL(parseRequest(parser, request, rest, Status::valid), second.size());
+    BOOST_CHECK_EQUAL(request.uri, "/second");
+    BOOST_CHECK(!request.keep_alive);
+}
+
+BOOST_AUTO_TEST_CASE(partial_request)
+{
+    RequestParser parser;
+    http::request request;
+    std::string head = "GET /route HTTP/1.1\r\nHo";
+    BOOST_CHECK_EQUAL(parseRequest(parser, request, head, Status::indeterminate), head.size());
+    std::string tail = "st: localhost\r\n\r\n";
+    BOOST_CHECK_EQUAL(parseRequest(parser, request, tail, Status::valid), tail.size());
+    BOOST_CHECK_EQUAL(request.uri, "/route");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
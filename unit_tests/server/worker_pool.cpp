@@ -0,0 +1,134 @@
+#include "server/worker_pool.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <future>
+
+BOOST_AUTO_TEST_SUITE(worker_pool)
+
+using namespace osrm;
+using namespace osrm::server;
+
+BOOST_AUTO_TEST_CASE(runs_tasks)
+{
+    WorkerPool pool(2, -1, {});
+
+    std::promise<void> done;
+    BOOST_CHECK(pool.TryPost("route", [&done] { done.set_value(); }));
+    done.get_future().wait();
+}
+
+BOOST_AUTO_TEST_CASE(sheds_load_when_queue_is_full)
+{
+    WorkerPool pool(1, 2, {});
+
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::promise<void> first_done, second_done;
+
+    BOOST_CHECK(pool.TryPost("route", [released, &first_done] {
+        released.wait();
+        first_done.set_value();
+    }));
+    BOOST_CHECK(pool.TryPost("route", [&second_done] { second_done.set_value(); }));
+    BOOST_CHECK(!pool.TryPost("route", [] {}));
+
+    release.set_value();
+    first_done.get_future().wait();
+    second_done.get_future().wait();
+
+    // the slots are released after the task has run, so wait until the pool has drained
+    std::promise<void> third_done;
+    while (!pool.TryPost("route", [&third_done] { third_done.set_value(); }))
+    {
+    }
+    third_done.get_future().wait();
+}
+
+BOOST_AUTO_TEST_CASE(limits_concurrency_per_service)
+{
+    WorkerPool pool(2, -1, {{"table", 1}, {"trip", 0}});
+
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::promise<void> first_table_done, second_table_done, nearest_done;
+    std::atomic<bool> first_table_running{true};
+
+    BOOST_CHECK(pool.TryPost("table", [released, &first_table_done, &first_table_running] {
+        released.wait();
+        first_table_running = false;
+        first_table_done.set_value();
+    }));
+    // waits for the first one instead of taking the second worker
+    BOOST_CHECK(pool.TryPost("table", [&second_table_done, &first_table_running] {
+        BOOST_CHECK(!first_table_running);
+        second_table_done.set_value();
+    }));
+
+    // other services still get a worker
+    BOOST_CHECK(pool.TryPost("nearest", [&nearest_done] { nearest_done.set_value(); }));
+    nearest_done.get_future().wait();
+
+    // disabled services are rejected
+    BOOST_CHECK(!pool.TryPost("trip", [] {}));
+
+    release.set_value();
+    first_table_done.get_future().wait();
+    second_table_done.get_future().wait();
+}
+
+BOOST_AUTO_TEST_CASE(limited_service_does_not_fill_queue)
+{
+    WorkerPool pool(2, 2, {{"table", 1}});
+
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::atomic<int> tables_finished{0};
+
+    BOOST_CHECK(pool.TryPost("table", [released, &tables_finished] {
+        released.wait();
+        ++tables_finished;
+    }));
+    // the queue of the table service is bounded on its own
+    BOOST_CHECK(pool.TryPost("table", [&tables_finished] { ++tables_finished; }));
+    BOOST_CHECK(pool.TryPost("table", [&tables_finished] { ++tables_finished; }));
+    BOOST_CHECK(!pool.TryPost("table", [] {}));
+
+    // the waiting tables take no slot of the global queue
+    std::promise<void> nearest_done;
+    BOOST_CHECK(pool.TryPost("nearest", [&nearest_done] { nearest_done.set_value(); }));
+    nearest_done.get_future().wait();
+
+    release.set_value();
+    pool.Stop();
+    BOOST_CHECK_EQUAL(tables_finished, 3);
+}
+
+BOOST_AUTO_TEST_CASE(stop_runs_queued_tasks)
+{
+    WorkerPool pool(1, -1, {{"table", 1}});
+
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::atomic<int> finished{0};
+
+    BOOST_CHECK(pool.TryPost("table", [released, &finished] {
+        released.wait();
+        ++finished;
+    }));
+    for (int i = 0; i < 3; ++i)
+    {
+        BOOST_CHECK(pool.TryPost("table", [&finished] { ++finished; }));
+        BOOST_CHECK(pool.TryPost("route", [&finished] { ++finished; }));
+    }
+
+    release.set_value();
+    pool.Stop();
+    BOOST_CHECK_EQUAL(finished, 7);
+
+    BOOST_CHECK(!pool.TryPost("route", [] {}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
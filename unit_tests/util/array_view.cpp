@@ -0,0 +1,58 @@
+#include "util/array_view.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <numeric>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(array_view_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(forward_and_reverse_views)
+{
+    const std::vector<int> data = {0, 1, 2, 3, 4, 5};
+
+    const auto forward = ArrayView<int>::Forward(data.data(), 1, 4);
+    BOOST_CHECK_EQUAL(forward.size(), 3);
+    BOOST_CHECK_EQUAL(forward.front(), 1);
+    BOOST_CHECK_EQUAL(forward.back(), 3);
+    const std::vector<int> forward_copy(forward.begin(), forward.end());
+    const std::vector<int> forward_expected = {1, 2, 3};
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        forward_copy.begin(), forward_copy.end(), forward_expected.begin(), forward_expected.end());
+
+    // same elements as the std::reverse_iterator based copy the facades used to return
+    const auto reverse = ArrayView<int>::Reverse(data.data(), 1, 4);
+    const std::vector<int> reverse_expected(data.rbegin() + (data.size() - 4),
+                                            data.rbegin() + (data.size() - 1));
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        reverse.begin(), reverse.end(), reverse_expected.begin(), reverse_expected.end());
+    BOOST_CHECK_EQUAL(reverse[0], 3);
+    BOOST_CHECK_EQUAL(*(reverse.end() - 1), 1);
+
+    const auto reversed = forward.Reversed();
+    BOOST_CHECK_EQUAL_COLLECTIONS(reversed.begin(), reversed.end(), reverse.begin(), reverse.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(forward.rbegin(), forward.rend(), reverse.begin(), reverse.end());
+
+    BOOST_CHECK_EQUAL(std::accumulate(reverse.begin(), reverse.end(), 0), 6);
+}
+
+BOOST_AUTO_TEST_CASE(repeated_and_empty_views)
+{
+    const int zero = 0;
+    const auto repeated = ArrayView<int>::Repeat(zero, 4);
+    BOOST_CHECK_EQUAL(repeated.size(), 4);
+    BOOST_CHECK_EQUAL(repeated.end() - repeated.begin(), 4);
+    BOOST_CHECK_EQUAL(repeated[3], 0);
+    BOOST_CHECK_EQUAL(repeated.Reversed().size(), 4);
+
+    const ArrayView<int> empty;
+    BOOST_CHECK(empty.empty());
+    BOOST_CHECK(empty.begin() == empty.end());
+    BOOST_CHECK(empty.Reversed().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -25,7 +25,8 @@ typedef int TestKey;
 typedef int TestWeight;
 typedef boost::mpl::list<ArrayStorage<TestNodeID, TestKey>,
                          MapStorage<TestNodeID, TestKey>,
-                         UnorderedMapStorage<TestNodeID, TestKey>>
+                         UnorderedMapStorage<TestNodeID, TestKey>,
+                         GenerationArrayStorage<TestNodeID, TestKey>>
     storage_types;
 
 template <unsigned NUM_ELEM> struct RandomDataFixture
@@ -157,4 +158,77 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(decrease_key_test, T, storage_types, RandomData
     }
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(clear_test, T, storage_types, RandomDataFixture<NUM_NODES>)
+{
+    BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(NUM_NODES);
+
+    for (unsigned round = 0; round < 3; ++round)
+    {
+        for (unsigned idx : order)
+        {
+            BOOST_CHECK(!heap.WasInserted(ids[idx]));
+            heap.Insert(ids[idx], weights[idx], data[idx]);
+        }
+
+        for (auto id : ids)
+        {
+            BOOST_CHECK_EQUAL(id, heap.DeleteMin());
+        }
+
+        heap.Clear();
+
+        for (auto id : ids)
+        {
+            BOOST_CHECK(!heap.WasInserted(id));
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(generation_array_storage_fallback_test, RandomDataFixture<NUM_NODES>)
+{
+    // a dense size limit below the number of nodes switches to the hash map
+    using Storage = GenerationArrayStorage<TestNodeID, TestKey>;
+    BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, Storage> heap(NUM_NODES, NUM_NODES / 2);
+
+    for (unsigned idx : order)
+    {
+        heap.Insert(ids[idx], weights[idx], data[idx]);
+    }
+
+    for (auto id : ids)
+    {
+        BOOST_CHECK_EQUAL(heap.GetKey(id), weights[id]);
+        BOOST_CHECK_EQUAL(id, heap.DeleteMin());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(generation_array_storage_grow_test)
+{
+    // nodes beyond the initial size can be inserted, e.g. after a dataset swap
+    using Storage = GenerationArrayStorage<TestNodeID, TestKey>;
+    BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, Storage> heap(10);
+
+    BOOST_CHECK(!heap.WasInserted(100));
+    heap.Insert(100, 1, TestData{1});
+    BOOST_CHECK(heap.WasInserted(100));
+    BOOST_CHECK_EQUAL(heap.Min(), 100);
+}
+
+BOOST_AUTO_TEST_CASE(generation_array_storage_fits_test)
+{
+    using Storage = GenerationArrayStorage<TestNodeID, TestKey>;
+    const Storage dense(100, 1000);
+    BOOST_CHECK(dense.Fits(100, 1000));
+    // other graph sizes need a new dense array
+    BOOST_CHECK(!dense.Fits(50, 1000));
+    BOOST_CHECK(!dense.Fits(200, 1000));
+    // a lower limit switches to the hash map
+    BOOST_CHECK(!dense.Fits(100, 50));
+
+    const Storage sparse(100, 50);
+    BOOST_CHECK(sparse.Fits(100, 50));
+    BOOST_CHECK(sparse.Fits(200, 50));
+    BOOST_CHECK(!sparse.Fits(100, 1000));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
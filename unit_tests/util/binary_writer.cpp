@@ -0,0 +1,52 @@
+#include "util/binary_writer.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(binary_writer)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(little_endian_layout)
+{
+    std::string buffer;
+    binary::Writer writer(buffer);
+    writer.Header();
+    writer.String("Ok");
+    writer.Int32(-2);
+    writer.Double(1.5);
+
+    const std::string expected("OSRM"
+                               "\x01\x00\x00\x00"
+                               "\x02\x00\x00\x00"
+                               "Ok"
+                               "\xfe\xff\xff\xff"
+                               "\x00\x00\x00\x00\x00\x00\xf8\x3f",
+                               4 + 4 + 4 + 2 + 4 + 8);
+    BOOST_CHECK(buffer == expected);
+}
+
+BOOST_AUTO_TEST_CASE(aligned_arrays)
+{
+    std::string buffer;
+    binary::Writer writer(buffer);
+    writer.String("abc");
+    writer.StartInt32Array(2);
+    // 4 byte length, 3 characters, 4 byte count, 1 byte padding
+    BOOST_CHECK_EQUAL(buffer.size(), 12);
+    writer.Int32(7);
+    writer.Int32(0x01020304);
+
+    BOOST_CHECK_EQUAL(buffer.size(), 20);
+    BOOST_CHECK_EQUAL(buffer[7], '\x02');
+    BOOST_CHECK_EQUAL(buffer[11], '\0');
+    BOOST_CHECK_EQUAL(buffer[12], '\x07');
+    BOOST_CHECK_EQUAL(buffer[16], '\x04');
+    BOOST_CHECK_EQUAL(buffer[19], '\x01');
+}
+
+BOOST_AUTO_TEST_SUITE_END()
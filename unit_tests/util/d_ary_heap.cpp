@@ -0,0 +1,136 @@
+#include "util/binary_heap.hpp"
+#include "util/d_ary_heap.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/mpl/list.hpp>
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(d_ary_heap)
+
+using namespace osrm;
+using namespace osrm::util;
+
+struct TestData
+{
+    unsigned value;
+};
+
+typedef NodeID TestNodeID;
+typedef int TestKey;
+typedef int TestWeight;
+typedef ArrayStorage<TestNodeID, TestKey> TestStorage;
+
+typedef boost::mpl::list<DAryHeap<TestNodeID, TestKey, TestWeight, TestData, TestStorage, 2>,
+                         DAryHeap<TestNodeID, TestKey, TestWeight, TestData, TestStorage, 3>,
+                         DAryHeap<TestNodeID, TestKey, TestWeight, TestData, TestStorage, 4>,
+                         DAryHeap<TestNodeID, TestKey, TestWeight, TestData, TestStorage, 8>>
+    heap_types;
+
+constexpr unsigned NUM_NODES = 1000;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(delete_min_sorted_test, Heap, heap_types)
+{
+    Heap heap(NUM_NODES);
+
+    // Choosen by a fair W20 dice roll
+    std::mt19937 g(15);
+    std::uniform_int_distribution<TestWeight> weight_distribution(0, 10000);
+
+    std::vector<TestWeight> weights(NUM_NODES);
+    for (TestNodeID id = 0; id < NUM_NODES; ++id)
+    {
+        weights[id] = weight_distribution(g);
+        heap.Insert(id, weights[id], TestData{id});
+    }
+    BOOST_CHECK_EQUAL(heap.Size(), NUM_NODES);
+
+    TestWeight last_weight = std::numeric_limits<TestWeight>::min();
+    while (!heap.Empty())
+    {
+        const auto min_weight = heap.MinKey();
+        const auto id = heap.DeleteMin();
+        BOOST_CHECK_EQUAL(weights[id], min_weight);
+        BOOST_CHECK_EQUAL(heap.GetData(id).value, id);
+        BOOST_CHECK(heap.WasRemoved(id));
+        BOOST_CHECK_LE(last_weight, min_weight);
+        last_weight = min_weight;
+    }
+}
+
+// Runs the same random sequence of operations as on a binary heap, the results have to match
+BOOST_AUTO_TEST_CASE_TEMPLATE(matches_binary_heap_test, Heap, heap_types)
+{
+    Heap heap(NUM_NODES);
+    BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, TestStorage> reference(NUM_NODES);
+
+    std::mt19937 g(13);
+    std::uniform_int_distribution<TestNodeID> node_distribution(0, NUM_NODES - 1);
+    std::uniform_int_distribution<TestWeight> weight_distribution(0, 10000);
+    std::uniform_int_distribution<int> operation_distribution(0, 2);
+
+    for (unsigned round = 0; round < 2; ++round)
+    {
+        for (unsigned step = 0; step < 10 * NUM_NODES; ++step)
+        {
+            const auto node = node_distribution(g);
+            const auto weight = weight_distribution(g);
+            switch (operation_distribution(g))
+            {
+            case 0:
+                if (!reference.WasInserted(node))
+                {
+                    BOOST_CHECK(!heap.WasInserted(node));
+                    reference.Insert(node, weight, TestData{node});
+                    heap.Insert(node, weight, TestData{node});
+                }
+                break;
+            case 1:
+                if (reference.WasInserted(node) && !reference.WasRemoved(node) &&
+                    weight < reference.GetKey(node))
+                {
+                    reference.DecreaseKey(node, weight);
+                    heap.DecreaseKey(node, weight);
+                }
+                break;
+            case 2:
+                if (!reference.Empty())
+                {
+                    BOOST_CHECK_EQUAL(reference.MinKey(), heap.MinKey());
+                    const auto min_weight = reference.MinKey();
+                    const auto removed = heap.DeleteMin();
+                    reference.DeleteMin();
+                    BOOST_CHECK_EQUAL(heap.GetKey(removed), min_weight);
+                }
+                break;
+            }
+            BOOST_REQUIRE_EQUAL(reference.Size(), heap.Size());
+        }
+
+        heap.Clear();
+        reference.Clear();
+        BOOST_CHECK(heap.Empty());
+    }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(delete_all_test, Heap, heap_types)
+{
+    Heap heap(NUM_NODES);
+
+    for (TestNodeID id = 0; id < NUM_NODES; ++id)
+    {
+        heap.Insert(id, NUM_NODES - id, TestData{id});
+    }
+
+    heap.DeleteAll();
+
+    BOOST_CHECK(heap.Empty());
+    BOOST_CHECK(heap.WasRemoved(0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
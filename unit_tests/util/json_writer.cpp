@@ -0,0 +1,98 @@
+#include "util/cast.hpp"
+#include "util/json_renderer.hpp"
+#include "util/json_writer.hpp"
+
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(json_writer)
+
+using namespace osrm;
+using namespace osrm::util;
+
+std::string formatNumber(const double value)
+{
+    char buffer[512];
+    char *end = json::detail::formatNumber(value, buffer);
+    return std::string(buffer, end);
+}
+
+BOOST_AUTO_TEST_CASE(number_formatting)
+{
+    const std::vector<double> values = {0.,     -0.,        1.,          -1.,      0.5,
+                                        10.,    100.,       123.456789,  1e-7,     -1e-7,
+                                        5e-7,   0.0000005,  13.388799,   52.517033, -180.,
+                                        1e15,   1.5e20,     3.1415926535, 2.5e-6,  1234567.8};
+    for (const auto value : values)
+    {
+        BOOST_CHECK_EQUAL(formatNumber(value), cast::to_string_with_precision(value));
+    }
+
+    std::mt19937 generator(13);
+    std::uniform_real_distribution<double> distribution(-1e7, 1e7);
+    std::uniform_int_distribution<int> fixed_distribution(-180000000, 180000000);
+    for (int i = 0; i < 100000; ++i)
+    {
+        const double value = distribution(generator);
+        BOOST_CHECK_EQUAL(formatNumber(value), cast::to_string_with_precision(value));
+
+        // coordinates and durations are fixed point values converted to double
+        const double coordinate = fixed_distribution(generator) / 1e6;
+        BOOST_CHECK_EQUAL(formatNumber(coordinate), cast::to_string_with_precision(coordinate));
+        const double duration = fixed_distribution(generator) / 10.;
+        BOOST_CHECK_EQUAL(formatNumber(duration), cast::to_string_with_precision(duration));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(streaming_matches_tree)
+{
+    json::Object object;
+    object.values["code"] = "Ok";
+    json::Array array;
+    array.values.push_back(json::Number(1.5));
+    array.values.push_back(json::Null());
+    array.values.push_back(json::String("a \"quoted\" string/path"));
+    object.values["values"] = std::move(array);
+
+    std::vector<char> rendered;
+    json::render(rendered, object);
+
+    std::vector<char> streamed;
+    json::Writer writer(streamed);
+    writer.Value(object);
+
+    BOOST_CHECK_EQUAL(std::string(streamed.begin(), streamed.end()),
+                      std::string(rendered.begin(), rendered.end()));
+}
+
+BOOST_AUTO_TEST_CASE(separators)
+{
+    std::vector<char> out;
+    json::Writer writer(out);
+    writer.StartObject();
+    writer.Key("a");
+    writer.StartArray();
+    writer.StartArray();
+    writer.Number(1);
+    writer.Number(2);
+    writer.EndArray();
+    writer.StartArray();
+    writer.EndArray();
+    writer.Null();
+    writer.EndArray();
+    writer.Key("b");
+    writer.Bool(true);
+    writer.Key("c");
+    writer.StartObject();
+    writer.EndObject();
+    writer.EndObject();
+
+    BOOST_CHECK_EQUAL(std::string(out.begin(), out.end()),
+                      "{\"a\":[[1,2],[],null],\"b\":true,\"c\":{}}");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,131 @@
+#include "util/rtree_kernels.hpp"
+#include "util/coordinate_calculation.hpp"
+#include "util/rectangle.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(rtree_kernels_test)
+
+using namespace osrm;
+using namespace osrm::util;
+using rtree_kernels::InstructionSet;
+
+// not a multiple of the vector sizes to test the scalar remainder
+constexpr std::size_t NUM_OBJECTS = 127;
+
+std::vector<std::int32_t> randomValues(std::mt19937 &generator)
+{
+    std::uniform_int_distribution<std::int32_t> distribution(-180 * COORDINATE_PRECISION,
+                                                             180 * COORDINATE_PRECISION);
+    std::vector<std::int32_t> values(NUM_OBJECTS);
+    for (auto &value : values)
+    {
+        value = distribution(generator);
+    }
+    return values;
+}
+
+// Every instruction set supported by the CPU computes the distances of the scalar kernels
+template <typename TestT> void forEachInstructionSet(TestT test)
+{
+    const auto supported = rtree_kernels::getSupportedInstructionSet();
+    for (const auto instruction_set :
+         {InstructionSet::Scalar, InstructionSet::SSE41, InstructionSet::AVX2})
+    {
+        if (instruction_set > supported)
+            break;
+        BOOST_CHECK(rtree_kernels::setInstructionSet(instruction_set) == instruction_set);
+        test();
+    }
+    rtree_kernels::setInstructionSet(supported);
+}
+
+BOOST_AUTO_TEST_CASE(segment_distances_test)
+{
+    std::mt19937 generator(42);
+    auto u_lon = randomValues(generator);
+    auto u_lat = randomValues(generator);
+    auto v_lon = randomValues(generator);
+    auto v_lat = randomValues(generator);
+    // zero length segment
+    v_lon[3] = u_lon[3];
+    v_lat[3] = u_lat[3];
+    const Coordinate coordinate{FloatLongitude{13.4}, FloatLatitude{52.5}};
+
+    forEachInstructionSet([&] {
+        std::vector<std::uint64_t> squared_distances(NUM_OBJECTS);
+        std::vector<std::int32_t> nearest_lon(NUM_OBJECTS);
+        std::vector<std::int32_t> nearest_lat(NUM_OBJECTS);
+        rtree_kernels::segmentDistances(u_lon.data(),
+                                        u_lat.data(),
+                                        v_lon.data(),
+                                        v_lat.data(),
+                                        NUM_OBJECTS,
+                                        coordinate,
+                                        squared_distances.data(),
+                                        nearest_lon.data(),
+                                        nearest_lat.data());
+
+        for (std::size_t i = 0; i < NUM_OBJECTS; ++i)
+        {
+            const Coordinate u{FixedLongitude{u_lon[i]}, FixedLatitude{u_lat[i]}};
+            const Coordinate v{FixedLongitude{v_lon[i]}, FixedLatitude{v_lat[i]}};
+            const Coordinate expected{
+                coordinate_calculation::projectPointOnSegment(u, v, coordinate).second};
+            const Coordinate nearest{FixedLongitude{nearest_lon[i]},
+                                     FixedLatitude{nearest_lat[i]}};
+
+            // the kernels do not convert to floating point degrees
+            BOOST_CHECK_LE(std::abs(nearest_lon[i] - static_cast<std::int32_t>(expected.lon)), 1);
+            BOOST_CHECK_LE(std::abs(nearest_lat[i] - static_cast<std::int32_t>(expected.lat)), 1);
+            BOOST_CHECK_EQUAL(
+                squared_distances[i],
+                coordinate_calculation::squaredEuclideanDistance(coordinate, nearest));
+        }
+    });
+}
+
+BOOST_AUTO_TEST_CASE(rectangle_distances_test)
+{
+    std::mt19937 generator(42);
+    auto min_lon = randomValues(generator);
+    auto max_lon = randomValues(generator);
+    auto min_lat = randomValues(generator);
+    auto max_lat = randomValues(generator);
+    for (std::size_t i = 0; i < NUM_OBJECTS; ++i)
+    {
+        if (min_lon[i] > max_lon[i])
+            std::swap(min_lon[i], max_lon[i]);
+        if (min_lat[i] > max_lat[i])
+            std::swap(min_lat[i], max_lat[i]);
+    }
+    const Coordinate coordinate{FloatLongitude{13.4}, FloatLatitude{52.5}};
+
+    forEachInstructionSet([&] {
+        std::vector<std::uint64_t> squared_distances(NUM_OBJECTS);
+        rtree_kernels::rectangleDistances(min_lon.data(),
+                                          max_lon.data(),
+                                          min_lat.data(),
+                                          max_lat.data(),
+                                          NUM_OBJECTS,
+                                          coordinate,
+                                          squared_distances.data());
+
+        for (std::size_t i = 0; i < NUM_OBJECTS; ++i)
+        {
+            const RectangleInt2D rectangle{FixedLongitude{min_lon[i]},
+                                           FixedLongitude{max_lon[i]},
+                                           FixedLatitude{min_lat[i]},
+                                           FixedLatitude{max_lat[i]}};
+            BOOST_CHECK_EQUAL(squared_distances[i], rectangle.GetMinSquaredDist(coordinate));
+        }
+    });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,106 @@
+#include "util/rtree_warmup.hpp"
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <string>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+const static std::string HOT_PAGES_TMP_FILE = "test_rtree_warmup.tmp";
+
+BOOST_AUTO_TEST_SUITE(rtree_warmup_tests)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(parse_rtree_warmup)
+{
+    for (const auto warmup : {RTreeWarmup::None,
+                              RTreeWarmup::Advise,
+                              RTreeWarmup::Populate,
+                              RTreeWarmup::HotPages})
+    {
+        RTreeWarmup parsed = RTreeWarmup::None;
+        BOOST_CHECK(parseRTreeWarmup(toString(warmup), parsed));
+        BOOST_CHECK(parsed == warmup);
+    }
+
+    RTreeWarmup parsed = RTreeWarmup::Advise;
+    BOOST_CHECK(parseRTreeWarmup("hot-pages", parsed));
+    BOOST_CHECK(parsed == RTreeWarmup::HotPages);
+    BOOST_CHECK(!parseRTreeWarmup("hot_pages", parsed));
+    BOOST_CHECK(!parseRTreeWarmup("", parsed));
+    // unchanged by invalid names
+    BOOST_CHECK(parsed == RTreeWarmup::HotPages);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_hot_pages_file)
+{
+    const char data[1] = {0};
+
+    // a missing file reads no pages
+    boost::filesystem::remove(HOT_PAGES_TMP_FILE);
+    BOOST_CHECK_EQUAL(
+        rtree_warmup::warmUp(data, sizeof(data), RTreeWarmup::HotPages, HOT_PAGES_TMP_FILE), 0);
+
+    // a count that does not fit the file is not trusted
+    {
+        boost::filesystem::ofstream hot_pages_file(HOT_PAGES_TMP_FILE, std::ios::binary);
+        const std::uint64_t number_of_pages = std::uint64_t{1} << 60;
+        const std::uint64_t offset = 0;
+        hot_pages_file.write(reinterpret_cast<const char *>(&number_of_pages),
+                             sizeof(number_of_pages));
+        hot_pages_file.write(reinterpret_cast<const char *>(&offset), sizeof(offset));
+    }
+    BOOST_CHECK_EQUAL(
+        rtree_warmup::warmUp(data, sizeof(data), RTreeWarmup::HotPages, HOT_PAGES_TMP_FILE), 0);
+
+    // shorter than the count
+    {
+        boost::filesystem::ofstream hot_pages_file(HOT_PAGES_TMP_FILE, std::ios::binary);
+        hot_pages_file.write("abc", 3);
+    }
+    BOOST_CHECK_EQUAL(
+        rtree_warmup::warmUp(data, sizeof(data), RTreeWarmup::HotPages, HOT_PAGES_TMP_FILE), 0);
+}
+
+#ifdef __linux__
+BOOST_AUTO_TEST_CASE(save_and_read_hot_pages)
+{
+    const std::size_t page_size = sysconf(_SC_PAGESIZE);
+    const std::size_t number_of_pages = 16;
+    const std::size_t size = number_of_pages * page_size;
+    auto data = static_cast<char *>(
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    BOOST_REQUIRE(data != MAP_FAILED);
+
+    // only the written pages are resident
+    for (std::size_t page = 0; page < number_of_pages; page += 4)
+    {
+        data[page * page_size] = 1;
+    }
+
+    BOOST_CHECK_EQUAL(rtree_warmup::saveHotPages(data, size, HOT_PAGES_TMP_FILE),
+                      number_of_pages / 4);
+    BOOST_CHECK_EQUAL(boost::filesystem::file_size(HOT_PAGES_TMP_FILE),
+                      sizeof(std::uint64_t) * (1 + number_of_pages / 4));
+    BOOST_CHECK_EQUAL(
+        rtree_warmup::warmUp(data, size, RTreeWarmup::HotPages, HOT_PAGES_TMP_FILE),
+        number_of_pages / 4);
+
+    // pages beyond a smaller dataset are skipped
+    BOOST_CHECK_EQUAL(
+        rtree_warmup::warmUp(data, size / 2, RTreeWarmup::HotPages, HOT_PAGES_TMP_FILE),
+        number_of_pages / 8);
+
+    munmap(data, size);
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
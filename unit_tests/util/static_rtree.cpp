@@ -9,6 +9,8 @@
 
 #include "mocks/mock_datafacade.hpp"
 
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
 #include <boost/functional/hash.hpp>
 #include <boost/test/auto_unit_test.hpp>
 #include <boost/test/test_case_template.hpp>
@@ -37,7 +39,7 @@ using namespace osrm::util;
 using namespace osrm::test;
 
 constexpr uint32_t TEST_BRANCHING_FACTOR = 8;
-constexpr uint32_t TEST_LEAF_NODE_SIZE = 64;
+constexpr uint32_t TEST_LEAF_NODE_SIZE = 128;
 
 using TestData = extractor::EdgeBasedNode;
 using TestStaticRTree = StaticRTree<TestData,
@@ -45,7 +47,18 @@ using TestStaticRTree = StaticRTree<TestData,
                                     false,
                                     TEST_BRANCHING_FACTOR,
                                     TEST_LEAF_NODE_SIZE>;
+using SharedStaticRTree = StaticRTree<TestData,
+                                      std::vector<Coordinate>,
+                                      true,
+                                      TEST_BRANCHING_FACTOR,
+                                      TEST_LEAF_NODE_SIZE>;
 using MiniStaticRTree = StaticRTree<TestData, std::vector<Coordinate>, false, 2, 128>;
+using LookupStaticRTree = StaticRTree<TestData,
+                                      std::vector<Coordinate>,
+                                      false,
+                                      TEST_BRANCHING_FACTOR,
+                                      TEST_LEAF_NODE_SIZE,
+                                      false>;
 
 // Choosen by a fair W20 dice roll (this value is completely arbitrary)
 constexpr unsigned RANDOM_SEED = 42;
@@ -273,7 +286,7 @@ void construction_test(const std::string &prefix, FixtureT *fixture)
 
 BOOST_FIXTURE_TEST_CASE(construct_tiny, TestRandomGraphFixture_10_30)
 {
-    using TinyTestTree = StaticRTree<TestData, std::vector<Coordinate>, false, 2, 64>;
+    using TinyTestTree = StaticRTree<TestData, std::vector<Coordinate>, false, 2, 128>;
     construction_test<TinyTestTree>("test_tiny", this);
 }
 
@@ -302,6 +315,143 @@ BOOST_FIXTURE_TEST_CASE(construct_multiple_levels_test, TestRandomGraphFixture_M
     construction_test("test_5", this);
 }
 
+BOOST_FIXTURE_TEST_CASE(construct_lookup_leaves_test, TestRandomGraphFixture_MultipleLevels)
+{
+    construction_test<LookupStaticRTree>("test_6", this);
+}
+
+// The bounded queue returns the same segments as a search that queues all candidates
+BOOST_FIXTURE_TEST_CASE(bounded_nearest_test, TestRandomGraphFixture_MultipleLevels)
+{
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree<TestRandomGraphFixture_MultipleLevels, TestStaticRTree>(
+        "test_bounded", this, leaves_path, nodes_path);
+    TestStaticRTree rtree(nodes_path, leaves_path, coords);
+
+    using CandidateSegment = TestStaticRTree::CandidateSegment;
+    const auto odd_segments = [](const CandidateSegment &segment) {
+        return std::make_pair(segment.data.u % 2 == 1, segment.data.u % 2 == 1);
+    };
+    const auto verify_results = [this](const Coordinate input_coordinate,
+                                       const std::vector<TestData> &expected,
+                                       const std::vector<TestData> &results) {
+        BOOST_REQUIRE_EQUAL(results.size(), expected.size());
+        for (const auto i : util::irange<std::size_t>(0, results.size()))
+        {
+            BOOST_CHECK_EQUAL(coordinate_calculation::perpendicularDistance(
+                                  coords[results[i].u], coords[results[i].v], input_coordinate),
+                              coordinate_calculation::perpendicularDistance(
+                                  coords[expected[i].u], coords[expected[i].v], input_coordinate));
+        }
+    };
+
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
+    std::uniform_int_distribution<> lon_udist(WORLD_MIN_LON, WORLD_MAX_LON);
+
+    // the queue and the results are reused by all queries
+    TestStaticRTree::NearestQueue queue;
+    std::vector<TestData> results;
+    for (const auto num_results : {1u, 2u, 10u})
+    {
+        const auto count_terminator = [num_results](const std::size_t num,
+                                                    const CandidateSegment &) {
+            return num >= num_results;
+        };
+        for (unsigned i = 0; i < 100; i++)
+        {
+            const Coordinate q{FixedLongitude{lon_udist(g)}, FixedLatitude{lat_udist(g)}};
+
+            verify_results(q,
+                           rtree.Nearest(q,
+                                         [](const CandidateSegment &) {
+                                             return std::make_pair(true, true);
+                                         },
+                                         count_terminator),
+                           rtree.Nearest(q, num_results));
+
+            rtree.Nearest(q,
+                          odd_segments,
+                          [](const std::size_t, const CandidateSegment &) { return false; },
+                          num_results,
+                          queue,
+                          results);
+            verify_results(q, rtree.Nearest(q, odd_segments, count_terminator), results);
+
+            // the same queue without a bound, the filter is applied to dequeued segments only
+            std::vector<TestData> unbounded_results;
+            rtree.Nearest(q, odd_segments, count_terminator, queue, unbounded_results);
+            verify_results(q, results, unbounded_results);
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(leaf_warmup_test, TestRandomGraphFixture_MultipleLevels)
+{
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree<TestRandomGraphFixture_MultipleLevels, TestStaticRTree>(
+        "test_warmup", this, leaves_path, nodes_path);
+    TestStaticRTree rtree(nodes_path, leaves_path, coords);
+    const std::string hot_pages_path = "test_warmup.hotPages";
+    boost::filesystem::remove(hot_pages_path);
+
+    // a missing hot pages file is not an error
+    for (const auto warmup : {util::RTreeWarmup::None,
+                              util::RTreeWarmup::Advise,
+                              util::RTreeWarmup::Populate,
+                              util::RTreeWarmup::HotPages})
+    {
+        rtree.WarmUpLeaves(warmup, hot_pages_path);
+    }
+
+    rtree.SaveHotLeafPages(hot_pages_path);
+#ifdef __linux__
+    // all pages were read by the populate warm-up
+    BOOST_CHECK(boost::filesystem::exists(hot_pages_path));
+    rtree.WarmUpLeaves(util::RTreeWarmup::HotPages, hot_pages_path);
+#endif
+
+    LinearSearchNN<TestData> lsnn(coords, edges);
+    sampling_verify_rtree(rtree, lsnn, coords, 100);
+}
+
+BOOST_FIXTURE_TEST_CASE(in_memory_leaves_test, TestRandomGraphFixture_MultipleLevels)
+{
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree<TestRandomGraphFixture_MultipleLevels, TestStaticRTree>(
+        "test_in_memory", this, leaves_path, nodes_path);
+
+    boost::filesystem::ifstream nodes_file(nodes_path, std::ios::binary);
+    std::uint64_t number_of_nodes = 0;
+    nodes_file.read(reinterpret_cast<char *>(&number_of_nodes), sizeof(number_of_nodes));
+    std::vector<SharedStaticRTree::TreeNode> nodes(number_of_nodes);
+    nodes_file.read(reinterpret_cast<char *>(nodes.data()),
+                    number_of_nodes * sizeof(SharedStaticRTree::TreeNode));
+
+    // placed like osrm-datastore places the leaves in shared memory
+    using LeafNode = SharedStaticRTree::LeafNode;
+    const auto leaves_size = boost::filesystem::file_size(leaves_path);
+    std::vector<char> leaves_block(leaves_size + alignof(LeafNode) - 1);
+    const auto leaves_address = reinterpret_cast<std::uintptr_t>(leaves_block.data());
+    auto leaves_ptr = reinterpret_cast<LeafNode *>((leaves_address + alignof(LeafNode) - 1) &
+                                                   ~(alignof(LeafNode) - 1));
+    boost::filesystem::ifstream leaves_file(leaves_path, std::ios::binary);
+    leaves_file.read(reinterpret_cast<char *>(leaves_ptr), leaves_size);
+    BOOST_REQUIRE(leaves_file);
+
+    SharedStaticRTree rtree(
+        nodes.data(), number_of_nodes, leaves_ptr, leaves_size / sizeof(LeafNode), coords);
+    // nothing to load for leaves in memory
+    rtree.WarmUpLeaves(util::RTreeWarmup::Populate, {});
+
+    LinearSearchNN<TestData> lsnn(coords, edges);
+    simple_verify_rtree(rtree, coords, edges);
+    sampling_verify_rtree(rtree, lsnn, coords, 100);
+}
+
 // Bug: If you querry a point that lies between two BBs that have a gap,
 // one BB will be pruned, even if it could contain a nearer match.
 BOOST_AUTO_TEST_CASE(regression_test)
@@ -440,6 +590,83 @@ BOOST_AUTO_TEST_CASE(bearing_tests)
     }
 }
 
+// Batches return the phantom nodes of single queries in input order
+BOOST_AUTO_TEST_CASE(batch_snapping_tests)
+{
+    using Coord = std::pair<FloatLongitude, FloatLatitude>;
+    using Edge = std::pair<unsigned, unsigned>;
+    GraphFixture fixture(
+        {
+            Coord(FloatLongitude{0.0}, FloatLatitude{0.0}),
+            Coord(FloatLongitude{1.0}, FloatLatitude{1.0}),
+            Coord(FloatLongitude{2.0}, FloatLatitude{0.0}),
+            Coord(FloatLongitude{3.0}, FloatLatitude{1.0}),
+            Coord(FloatLongitude{4.0}, FloatLatitude{0.0}),
+        },
+        {Edge(0, 1), Edge(1, 2), Edge(2, 3), Edge(3, 4)});
+
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree<GraphFixture, MiniStaticRTree>("test_batch", &fixture, leaves_path, nodes_path);
+    MiniStaticRTree rtree(nodes_path, leaves_path, fixture.coords);
+    MockDataFacade mockfacade;
+    engine::GeospatialQuery<MiniStaticRTree, MockDataFacade> query(
+        rtree, fixture.coords, mockfacade);
+
+    // enough coordinates to snap them on two threads
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_real_distribution<> lon_udist(-1.0, 5.0);
+    std::uniform_real_distribution<> lat_udist(-1.0, 2.0);
+    std::vector<Coordinate> coordinates;
+    std::vector<boost::optional<double>> radiuses;
+    std::vector<boost::optional<engine::Bearing>> bearings;
+    for (unsigned i = 0; i < 100; i++)
+    {
+        coordinates.emplace_back(FloatLongitude{lon_udist(g)}, FloatLatitude{lat_udist(g)});
+        radiuses.push_back(i % 3 == 0 ? boost::optional<double>(50000.) : boost::none);
+        bearings.push_back(i % 2 == 0 ? boost::optional<engine::Bearing>(engine::Bearing{45, 90})
+                                      : boost::none);
+    }
+
+    const auto check_batch = [&](const std::size_t count, const int max_parallelism) {
+        const auto results = query.NearestPhantomNodesWithAlternativeFromBigComponent(
+            std::vector<Coordinate>(coordinates.begin(), coordinates.begin() + count),
+            std::vector<boost::optional<double>>(radiuses.begin(), radiuses.begin() + count),
+            std::vector<boost::optional<engine::Bearing>>(bearings.begin(),
+                                                          bearings.begin() + count),
+            max_parallelism);
+        BOOST_REQUIRE_EQUAL(results.size(), count);
+        for (const auto i : irange<std::size_t>(0, count))
+        {
+            std::pair<engine::PhantomNode, engine::PhantomNode> expected;
+            if (bearings[i] && radiuses[i])
+                expected = query.NearestPhantomNodeWithAlternativeFromBigComponent(
+                    coordinates[i], *radiuses[i], bearings[i]->bearing, bearings[i]->range);
+            else if (bearings[i])
+                expected = query.NearestPhantomNodeWithAlternativeFromBigComponent(
+                    coordinates[i], bearings[i]->bearing, bearings[i]->range);
+            else if (radiuses[i])
+                expected = query.NearestPhantomNodeWithAlternativeFromBigComponent(coordinates[i],
+                                                                                   *radiuses[i]);
+            else
+                expected = query.NearestPhantomNodeWithAlternativeFromBigComponent(coordinates[i]);
+
+            BOOST_CHECK(results[i].first == expected.first);
+            BOOST_CHECK(results[i].second == expected.second);
+            BOOST_CHECK_EQUAL(results[i].first.forward_segment_id.id,
+                              expected.first.forward_segment_id.id);
+        }
+    };
+    // too few coordinates to be sorted
+    check_batch(10, 2);
+    for (const auto max_parallelism : {1, 2})
+    {
+        check_batch(coordinates.size(), max_parallelism);
+    }
+
+    BOOST_CHECK(query.NearestPhantomNodesWithAlternativeFromBigComponent({}, {}, {}, 2).empty());
+}
+
 BOOST_AUTO_TEST_CASE(bbox_search_tests)
 {
     using Coord = std::pair<FloatLongitude, FloatLatitude>;